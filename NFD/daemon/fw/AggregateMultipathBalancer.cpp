@@ -0,0 +1,164 @@
+#include "AggregateMultipathBalancer.hpp"
+
+#include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
+#include "ns3/data-rate.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+
+namespace nfd {
+namespace fw {
+
+// Weight of a new RTT sample, as in TCP's SRTT
+static const double RTT_GAIN = 0.125;
+// Lower bound on expected delay so that idle, unmeasured faces do not get infinite weight
+static const double MIN_DELAY_NS = 1000.0;
+
+void
+AggregateMultipathBalancer::addRttSample(const Face& face, time::nanoseconds rtt)
+{
+  double sample = static_cast<double>(rtt.count());
+  auto it = m_srtt.find(face.getId());
+  if (it == m_srtt.end()) {
+    m_srtt.emplace(face.getId(), sample);
+  }
+  else {
+    it->second += RTT_GAIN * (sample - it->second);
+  }
+}
+
+time::nanoseconds
+AggregateMultipathBalancer::getSmoothedRtt(const Face& face) const
+{
+  auto it = m_srtt.find(face.getId());
+  if (it == m_srtt.end()) {
+    return time::nanoseconds(-1);
+  }
+  return time::nanoseconds(static_cast<int64_t>(it->second));
+}
+
+std::vector<Face*>
+AggregateMultipathBalancer::getEqualCostFaces(const fib::Entry& entry, const Face& ingress)
+{
+  // Next hops are sorted by cost
+  std::vector<Face*> faces;
+  const fib::NextHopList& nexthops = entry.getNextHops();
+  uint64_t bestCost = std::numeric_limits<uint64_t>::max();
+  for (const auto& nexthop : nexthops) {
+    if (&nexthop.getFace() == &ingress) {
+      continue;
+    }
+    if (faces.empty()) {
+      bestCost = nexthop.getCost();
+    }
+    else if (nexthop.getCost() != bestCost) {
+      break;
+    }
+    faces.push_back(&nexthop.getFace());
+  }
+
+  if (faces.empty() && !nexthops.empty()) {
+    faces.push_back(&nexthops.begin()->getFace());
+  }
+  return faces;
+}
+
+void
+AggregateMultipathBalancer::assign(const std::vector<int>& ids, const std::vector<Face*>& faces,
+                                   std::map<Face*, std::vector<int>>& faceToIds) const
+{
+  if (faces.size() == 1 || ids.size() == 1) {
+    std::vector<int>& faceIds = faceToIds[faces.size() == 1 ? faces.front() : pick(faces)];
+    faceIds.insert(faceIds.end(), ids.begin(), ids.end());
+    return;
+  }
+
+  std::vector<double> weights = getExpectedDelays(faces);
+  for (double& weight : weights) {
+    weight = 1.0 / weight;
+  }
+  double totalWeight = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+  // Largest remainder apportionment of ids.size() over the weights
+  std::vector<size_t> counts(faces.size());
+  std::vector<std::pair<double, size_t>> remainders;
+  size_t nAssigned = 0;
+  for (size_t i = 0; i < faces.size(); ++i) {
+    double share = ids.size() * weights[i] / totalWeight;
+    counts[i] = static_cast<size_t>(share);
+    nAssigned += counts[i];
+    remainders.emplace_back(share - counts[i], i);
+  }
+  std::sort(remainders.begin(), remainders.end(), std::greater<std::pair<double, size_t>>());
+  for (size_t i = 0; nAssigned < ids.size(); ++i, ++nAssigned) {
+    ++counts[remainders[i].second];
+  }
+
+  auto begin = ids.begin();
+  for (size_t i = 0; i < faces.size(); ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    std::vector<int>& faceIds = faceToIds[faces[i]];
+    faceIds.insert(faceIds.end(), begin, begin + counts[i]);
+    begin += counts[i];
+  }
+}
+
+Face*
+AggregateMultipathBalancer::pick(const std::vector<Face*>& faces) const
+{
+  std::vector<double> delays = getExpectedDelays(faces);
+  return faces[std::min_element(delays.begin(), delays.end()) - delays.begin()];
+}
+
+std::vector<double>
+AggregateMultipathBalancer::getExpectedDelays(const std::vector<Face*>& faces) const
+{
+  // Faces without samples are assumed to be as fast as the best measured one, so that
+  // a newly usable path gets traffic and thereby measurements
+  double bestRtt = std::numeric_limits<double>::max();
+  for (const Face* face : faces) {
+    auto it = m_srtt.find(face->getId());
+    if (it != m_srtt.end()) {
+      bestRtt = std::min(bestRtt, it->second);
+    }
+  }
+  if (bestRtt == std::numeric_limits<double>::max()) {
+    bestRtt = 0;
+  }
+
+  std::vector<double> delays;
+  delays.reserve(faces.size());
+  for (const Face* face : faces) {
+    auto it = m_srtt.find(face->getId());
+    double rtt = it == m_srtt.end() ? bestRtt : it->second;
+    delays.push_back(std::max(MIN_DELAY_NS, rtt + getQueueDelay(*face)));
+  }
+  return delays;
+}
+
+double
+AggregateMultipathBalancer::getQueueDelay(const Face& face)
+{
+  auto transport = dynamic_cast<ns3::ndn::NetDeviceTransport*>(face.getTransport());
+  if (transport == nullptr) {
+    return 0;
+  }
+  ssize_t nBytes = transport->getSendQueueLength();
+  if (nBytes <= 0) {
+    return 0;
+  }
+
+  ns3::DataRateValue rate;
+  if (!transport->GetNetDevice()->GetAttributeFailSafe("DataRate", rate) ||
+      rate.Get().GetBitRate() == 0) {
+    return 0;
+  }
+  return nBytes * 8 * 1e9 / rate.Get().GetBitRate();
+}
+
+} // namespace fw
+} // namespace nfd
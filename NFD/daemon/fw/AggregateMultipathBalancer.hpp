@@ -0,0 +1,78 @@
+#ifndef AGGREGATE_MULTIPATH_BALANCER_HPP
+#define AGGREGATE_MULTIPATH_BALANCER_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/table/fib-entry.hpp"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Spreads the IDs of an aggregate Interest over equal-cost next hops
+ *
+ * Every face is scored by the delay a sub-Interest sent on it is expected to see: the
+ * smoothed RTT of earlier sub-Interests on that face plus the time needed to drain its
+ * send queue. An ID set is cut into contiguous runs, one per face, whose sizes are
+ * proportional to the inverse of that delay, so slow or congested paths get fewer IDs
+ * and contiguous runs keep the sub-Interest names compact.
+ */
+class AggregateMultipathBalancer
+{
+public:
+  /**
+   * @brief Fold one RTT measurement of @p face into its smoothed RTT
+   */
+  void
+  addRttSample(const Face& face, time::nanoseconds rtt);
+
+  /**
+   * @return Smoothed RTT of @p face, or a negative duration if it has no samples yet
+   */
+  time::nanoseconds
+  getSmoothedRtt(const Face& face) const;
+
+  /**
+   * @return Lowest-cost next hops of @p entry, excluding @p ingress unless it is the only one
+   */
+  static std::vector<Face*>
+  getEqualCostFaces(const fib::Entry& entry, const Face& ingress);
+
+  /**
+   * @brief Append @p ids to @p faceToIds in contiguous runs weighted by expected delay
+   * @param faces non-empty list of candidate faces
+   */
+  void
+  assign(const std::vector<int>& ids, const std::vector<Face*>& faces,
+         std::map<Face*, std::vector<int>>& faceToIds) const;
+
+  /**
+   * @return The face of @p faces with the lowest expected delay
+   */
+  Face*
+  pick(const std::vector<Face*>& faces) const;
+
+private:
+  /**
+   * @return Expected delay, in nanoseconds, of one more sub-Interest sent on each of @p faces
+   */
+  std::vector<double>
+  getExpectedDelays(const std::vector<Face*>& faces) const;
+
+  /**
+   * @return Time needed to transmit the bytes queued on @p face, or 0 if unknown
+   */
+  static double
+  getQueueDelay(const Face& face);
+
+private:
+  // Smoothed RTT in nanoseconds, keyed by FaceId (FaceIds are never reused)
+  std::unordered_map<FaceId, double> m_srtt;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // AGGREGATE_MULTIPATH_BALANCER_HPP
@@ -0,0 +1,75 @@
+#include "AggregateNextHopCache.hpp"
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+
+namespace nfd {
+namespace fw {
+
+static const Name AGGREGATE_PREFIX("/aggregate");
+
+AggregateNextHopCache::AggregateNextHopCache(Fib& fib)
+  : m_fib(fib)
+{
+  m_newNextHopConn = m_fib.afterNewNextHop.connect(
+    [this] (const Name& prefix, const fib::NextHop&) { onFibChange(prefix); });
+  m_updateNextHopsConn = m_fib.afterUpdateNextHops.connect(
+    [this] (const Name& prefix) { onFibChange(prefix); });
+}
+
+Face*
+AggregateNextHopCache::lookup(int id)
+{
+  const fib::Entry* entry = lookupEntry(id);
+  return entry == nullptr ? nullptr : &entry->getNextHops().begin()->getFace();
+}
+
+const fib::Entry*
+AggregateNextHopCache::lookupEntry(int id)
+{
+  if (id < 0 || id >= MAX_CACHED_ID) {
+    return resolve(id);
+  }
+
+  if (static_cast<size_t>(id) >= m_slots.size()) {
+    m_slots.resize(id + 1);
+  }
+  Slot& slot = m_slots[id];
+  if (!slot.isResolved) {
+    slot.entry = resolve(id);
+    slot.isResolved = true;
+    ++m_nResolved;
+  }
+  return slot.entry;
+}
+
+void
+AggregateNextHopCache::invalidate()
+{
+  m_slots.clear();
+  m_nResolved = 0;
+}
+
+const fib::Entry*
+AggregateNextHopCache::resolve(int id) const
+{
+  Name idName(AGGREGATE_PREFIX);
+  ns3::ndn::AggregateUtils::appendId(idName, id);
+  const fib::Entry& fibEntry = m_fib.findLongestPrefixMatch(idName);
+  if (fibEntry.getPrefix().empty() || fibEntry.getNextHops().empty()) {
+    return nullptr;
+  }
+  return &fibEntry;
+}
+
+void
+AggregateNextHopCache::onFibChange(const Name& prefix)
+{
+  // Also catches removed faces: their next hops are removed before the face goes away
+  if (m_nResolved > 0 &&
+      (prefix.isPrefixOf(AGGREGATE_PREFIX) || AGGREGATE_PREFIX.isPrefixOf(prefix))) {
+    invalidate();
+  }
+}
+
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,85 @@
+#ifndef AGGREGATE_NEXT_HOP_CACHE_HPP
+#define AGGREGATE_NEXT_HOP_CACHE_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/table/fib.hpp"
+
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Per-ID next-hop plan used by AggregateStrategy to split ID sets by out-face
+ *
+ * Producer ID i is reached through the FIB entry matching /aggregate/<i>. That entry is
+ * resolved by longest prefix match on first use and then kept in a dense array indexed
+ * by ID, so partitioning an ID set costs one array load per ID instead of a Name
+ * construction and a FIB lookup.
+ *
+ * The plan is dropped as a whole whenever a next hop of a FIB entry at or above
+ * /aggregate, or below it, is added, updated or removed.
+ */
+class AggregateNextHopCache
+{
+public:
+  explicit
+  AggregateNextHopCache(Fib& fib);
+
+  /**
+   * @return Out-face for producer @p id, or nullptr if the FIB has no route to it
+   */
+  Face*
+  lookup(int id);
+
+  /**
+   * @return FIB entry that routes producer @p id, or nullptr if it has no next hops
+   * @note The pointer is valid until the next FIB change under /aggregate
+   */
+  const fib::Entry*
+  lookupEntry(int id);
+
+  /**
+   * @brief Forget all resolved next hops
+   */
+  void
+  invalidate();
+
+  /**
+   * @return Number of IDs currently resolved
+   */
+  size_t
+  getResolvedCount() const
+  {
+    return m_nResolved;
+  }
+
+  /**
+   * @brief IDs at or above this bound are looked up in the FIB every time
+   */
+  static constexpr int MAX_CACHED_ID = 1 << 20;
+
+private:
+  const fib::Entry*
+  resolve(int id) const;
+
+  void
+  onFibChange(const Name& prefix);
+
+private:
+  struct Slot
+  {
+    const fib::Entry* entry = nullptr;
+    bool isResolved = false;
+  };
+
+  Fib& m_fib;
+  std::vector<Slot> m_slots;
+  size_t m_nResolved = 0;
+  signal::ScopedConnection m_newNextHopConn;
+  signal::ScopedConnection m_updateNextHopsConn;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // AGGREGATE_NEXT_HOP_CACHE_HPP
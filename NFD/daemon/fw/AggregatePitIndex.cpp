@@ -0,0 +1,248 @@
+#include "AggregatePitIndex.hpp"
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+
+#include <algorithm>
+
+namespace nfd {
+namespace fw {
+
+void
+AggregatePitIndex::insert(const std::shared_ptr<pit::Entry>& entry, const IdSet& ids)
+{
+  auto it = m_records.find(entry.get());
+  if (it != m_records.end()) {
+    eraseRecord(it);
+  }
+
+  Record record;
+  record.entry = entry;
+  record.ids = ids;
+  record.signature = ids.hash();
+  record.round = makeRoundKey(entry->getName());
+
+  Bucket& bucket = m_buckets[record.round];
+  bucket.bySignature.emplace(record.signature, entry.get());
+  for (int id : ids) {
+    bucket.byId[id].insert(entry.get());
+  }
+
+  m_records.emplace(entry.get(), std::move(record));
+}
+
+void
+AggregatePitIndex::erase(const pit::Entry& entry)
+{
+  auto it = m_records.find(&entry);
+  if (it != m_records.end()) {
+    eraseRecord(it);
+  }
+}
+
+void
+AggregatePitIndex::eraseRecord(std::unordered_map<const pit::Entry*, Record>::iterator it)
+{
+  const pit::Entry* key = it->first;
+  const Record& record = it->second;
+
+  auto bucketIt = m_buckets.find(record.round);
+  if (bucketIt != m_buckets.end()) {
+    Bucket& bucket = bucketIt->second;
+
+    auto range = bucket.bySignature.equal_range(record.signature);
+    for (auto sigIt = range.first; sigIt != range.second; ++sigIt) {
+      if (sigIt->second == key) {
+        bucket.bySignature.erase(sigIt);
+        break;
+      }
+    }
+
+    for (int id : record.ids) {
+      auto postingIt = bucket.byId.find(id);
+      if (postingIt == bucket.byId.end()) {
+        continue;
+      }
+      postingIt->second.erase(key);
+      if (postingIt->second.empty()) {
+        bucket.byId.erase(postingIt);
+      }
+    }
+
+    if (bucket.bySignature.empty()) {
+      m_buckets.erase(bucketIt);
+    }
+  }
+
+  m_records.erase(it);
+}
+
+std::shared_ptr<pit::Entry>
+AggregatePitIndex::lockOrPurge(const pit::Entry* key)
+{
+  auto it = m_records.find(key);
+  if (it == m_records.end()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<pit::Entry> entry = it->second.entry.lock();
+  if (!entry || entry->isSatisfied) {
+    eraseRecord(it);
+    return nullptr;
+  }
+  return entry;
+}
+
+AggregatePitIndex::Bucket*
+AggregatePitIndex::findBucket(const Name& name)
+{
+  auto it = m_buckets.find(makeRoundKey(name));
+  return it == m_buckets.end() ? nullptr : &it->second;
+}
+
+Name
+AggregatePitIndex::makeRoundKey(const Name& name)
+{
+  Name key;
+  key.append(ns3::ndn::AggregateUtils::extractSequenceComponent(name));
+  key.append(ns3::ndn::AggregateUtils::extractOperatorComponent(name));
+  return key;
+}
+
+std::shared_ptr<pit::Entry>
+AggregatePitIndex::findExact(const Name& name, const IdSet& ids, const pit::Entry* exclude)
+{
+  Bucket* bucket = findBucket(name);
+  if (bucket == nullptr) {
+    return nullptr;
+  }
+
+  size_t signature = ids.hash();
+  std::vector<const pit::Entry*> candidates;
+  auto range = bucket->bySignature.equal_range(signature);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second != exclude) {
+      candidates.push_back(it->second);
+    }
+  }
+
+  for (const pit::Entry* key : candidates) {
+    auto entry = lockOrPurge(key);
+    if (entry && m_records.at(key).ids == ids) {
+      return entry;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<std::shared_ptr<pit::Entry>>
+AggregatePitIndex::findSupersets(const Name& name, const IdSet& ids, const pit::Entry* exclude)
+{
+  std::vector<std::shared_ptr<pit::Entry>> result;
+  Bucket* bucket = findBucket(name);
+  if (bucket == nullptr || ids.empty()) {
+    return result;
+  }
+
+  // Every superset must appear in the posting list of every requested ID,
+  // so only the shortest posting list needs to be examined
+  const std::unordered_set<const pit::Entry*>* shortest = nullptr;
+  for (int id : ids) {
+    auto postingIt = bucket->byId.find(id);
+    if (postingIt == bucket->byId.end()) {
+      return result;
+    }
+    if (shortest == nullptr || postingIt->second.size() < shortest->size()) {
+      shortest = &postingIt->second;
+    }
+  }
+
+  std::vector<const pit::Entry*> candidates;
+  for (const pit::Entry* key : *shortest) {
+    if (key != exclude) {
+      candidates.push_back(key);
+    }
+  }
+
+  for (const pit::Entry* key : candidates) {
+    auto entry = lockOrPurge(key);
+    if (entry && ids.isSubsetOf(m_records.at(key).ids)) {
+      result.push_back(entry);
+    }
+  }
+  return result;
+}
+
+std::vector<std::shared_ptr<pit::Entry>>
+AggregatePitIndex::findSubsets(const Name& name, const IdSet& ids, const pit::Entry* exclude)
+{
+  std::vector<std::shared_ptr<pit::Entry>> result;
+  Bucket* bucket = findBucket(name);
+  if (bucket == nullptr) {
+    return result;
+  }
+
+  // An entry is a subset iff every one of its IDs is hit while walking the
+  // posting lists of the requested IDs
+  std::unordered_map<const pit::Entry*, size_t> hits;
+  for (int id : ids) {
+    auto postingIt = bucket->byId.find(id);
+    if (postingIt == bucket->byId.end()) {
+      continue;
+    }
+    for (const pit::Entry* key : postingIt->second) {
+      if (key != exclude) {
+        ++hits[key];
+      }
+    }
+  }
+
+  for (const auto& hit : hits) {
+    auto recordIt = m_records.find(hit.first);
+    if (recordIt == m_records.end() || recordIt->second.ids.size() != hit.second) {
+      continue;
+    }
+    auto entry = lockOrPurge(hit.first);
+    if (entry) {
+      result.push_back(entry);
+    }
+  }
+  return result;
+}
+
+std::vector<AggregatePitIndex::Match>
+AggregatePitIndex::findOverlapping(const Name& name, const IdSet& ids, const pit::Entry* exclude)
+{
+  std::vector<Match> result;
+  Bucket* bucket = findBucket(name);
+  if (bucket == nullptr) {
+    return result;
+  }
+
+  std::unordered_set<const pit::Entry*> keys;
+  for (int id : ids) {
+    auto postingIt = bucket->byId.find(id);
+    if (postingIt == bucket->byId.end()) {
+      continue;
+    }
+    for (const pit::Entry* key : postingIt->second) {
+      if (key != exclude) {
+        keys.insert(key);
+      }
+    }
+  }
+
+  for (const pit::Entry* key : keys) {
+    auto entry = lockOrPurge(key);
+    if (entry) {
+      result.push_back({entry, m_records.at(key).ids});
+    }
+  }
+  // Pointer order differs between runs; keep the caller's choices reproducible
+  std::sort(result.begin(), result.end(), [] (const Match& a, const Match& b) {
+    return a.entry->getName() < b.entry->getName();
+  });
+  return result;
+}
+
+} // namespace fw
+} // namespace nfd
@@ -0,0 +1,140 @@
+#ifndef AGGREGATE_PIT_INDEX_HPP
+#define AGGREGATE_PIT_INDEX_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/table/pit-entry.hpp"
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-id-set.hpp"
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Secondary index over live /aggregate PIT entries owned by AggregateStrategy
+ *
+ * Entries are bucketed by round (sequence component plus operator component, so
+ * different operators never share results), and inside a bucket they are
+ * reachable by ID-set signature (exact match) and through per-ID posting lists
+ * (superset/subset match), so lookups never walk the whole PIT.
+ *
+ * The index holds weak references only; records whose PIT entry is gone or
+ * satisfied are dropped lazily on lookup or explicitly through erase().
+ */
+class AggregatePitIndex
+{
+public:
+  using IdSet = ns3::ndn::AggregateIdSet;
+
+  /**
+   * @brief Add or refresh the record for a PIT entry
+   * @param entry The PIT entry
+   * @param ids The ID set carried in the entry's name
+   */
+  void
+  insert(const std::shared_ptr<pit::Entry>& entry, const IdSet& ids);
+
+  /**
+   * @brief Drop the record for a PIT entry, if any
+   */
+  void
+  erase(const pit::Entry& entry);
+
+  /**
+   * @brief Find a live entry in the same round with exactly the same ID set
+   * @param name Name whose sequence and operator components select the bucket
+   * @param ids The ID set to match
+   * @param exclude Entry to ignore (typically the caller's own entry)
+   */
+  std::shared_ptr<pit::Entry>
+  findExact(const Name& name, const IdSet& ids, const pit::Entry* exclude = nullptr);
+
+  /**
+   * @brief Find live entries in the same round whose ID set contains @p ids
+   */
+  std::vector<std::shared_ptr<pit::Entry>>
+  findSupersets(const Name& name, const IdSet& ids, const pit::Entry* exclude = nullptr);
+
+  /**
+   * @brief Find live entries in the same round whose ID set is contained in @p ids
+   */
+  std::vector<std::shared_ptr<pit::Entry>>
+  findSubsets(const Name& name, const IdSet& ids, const pit::Entry* exclude = nullptr);
+
+  struct Match
+  {
+    std::shared_ptr<pit::Entry> entry;
+    IdSet ids;
+  };
+
+  /**
+   * @brief Find live entries in the same round that share at least one ID with @p ids
+   * @return The entries with their full ID sets, in name order
+   */
+  std::vector<Match>
+  findOverlapping(const Name& name, const IdSet& ids, const pit::Entry* exclude = nullptr);
+
+  /**
+   * @return Number of indexed records (including not yet purged stale ones)
+   */
+  size_t
+  size() const
+  {
+    return m_records.size();
+  }
+
+  /**
+   * @return Number of distinct rounds (sequence/operator pairs) currently indexed
+   */
+  size_t
+  getRoundCount() const
+  {
+    return m_buckets.size();
+  }
+
+private:
+  struct Record
+  {
+    std::weak_ptr<pit::Entry> entry;
+    IdSet ids;
+    size_t signature;
+    Name round;
+  };
+
+  struct Bucket
+  {
+    std::unordered_multimap<size_t, const pit::Entry*> bySignature;
+    std::unordered_map<int, std::unordered_set<const pit::Entry*>> byId;
+  };
+
+  /**
+   * @return The live PIT entry for @p key, or nullptr after purging a stale record
+   */
+  std::shared_ptr<pit::Entry>
+  lockOrPurge(const pit::Entry* key);
+
+  void
+  eraseRecord(std::unordered_map<const pit::Entry*, Record>::iterator it);
+
+  Bucket*
+  findBucket(const Name& name);
+
+  /**
+   * @return Bucket key made of the sequence and operator components of @p name
+   */
+  static Name
+  makeRoundKey(const Name& name);
+
+private:
+  std::unordered_map<const pit::Entry*, Record> m_records;
+  std::map<Name, Bucket> m_buckets;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // AGGREGATE_PIT_INDEX_HPP
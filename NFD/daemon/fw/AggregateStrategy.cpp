@@ -11,6 +11,12 @@
 #include "ns3/config.h"
 
 #include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+#include "ns3/ndnSIM/utils/ndn-rtt-mean-deviation.hpp"
+
+#include <boost/lexical_cast.hpp>
+
+#include <iomanip>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("ndn.AggregateStrategy");
 
@@ -37,22 +43,89 @@ NFD_REGISTER_STRATEGY(AggregateStrategy);
 AggregateStrategy::AggregateStrategy(Forwarder& forwarder, const Name& name)
   : Strategy(forwarder)
   , m_forwarder(forwarder)
-  , m_nodeId(ns3::NodeContainer::GetGlobal().Get(ns3::Simulator::GetContext())->GetId() + 1)
+  , m_nodeId(ns3::Simulator::GetContext() + 1)
+  , m_nextHops(forwarder.getFib())
 {
+  // StrategyChoiceHelper installs strategies in an event of the node, so the context is
+  // its node ID on every rank; NodeContainer::GetGlobal() would copy the whole node list
+  NS_ABORT_MSG_IF(m_nodeId - 1 >= ns3::NodeList::GetNNodes(),
+                  "AggregateStrategy must be created in the context of its node");
+
+  ParsedInstanceName parsed = parseInstanceName(name);
+  processParams(parsed.parameters);
+
   // Set the instance name explicitly
   this->setInstanceName(name);
 
-  // Determine node role and logical ID for logging
+  // Determine node role and logical ID for logging, once per strategy instance
   uint32_t nodeIndex = m_nodeId - 1;
   m_nodeRole = ns3::ndn::AggregateUtils::determineNodeRole(nodeIndex);
-  std::cout << ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, nodeIndex) 
-            << " initialized AggregateStrategy" << std::endl;
+  m_logicalId = ns3::ndn::AggregateUtils::getLogicalId(nodeIndex);
+  m_nodeRoleString = ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, nodeIndex);
+  NS_LOG_DEBUG(m_nodeRoleString << " initialized AggregateStrategy");
 
   // Register for PIT expiration
   registerPitExpirationCallback();
 
-  std::cout << "AggregateStrategy initialized for Forwarder." << std::endl;
-  std::cout << "Strategy will use virtual method overrides." << std::endl << std::flush;
+  NS_LOG_DEBUG("AggregateStrategy initialized for Forwarder (multipath "
+               << (m_isMultipath ? "on" : "off") << ", deadline " << m_deadline
+               << ", max retx " << m_maxRetx << ").");
+  NS_LOG_DEBUG("Strategy will use virtual method overrides.");
+}
+
+static uint64_t
+getUintParam(const std::string& param, const std::string& value)
+{
+  try {
+    if (value.empty() || value[0] == '-') {
+      NDN_THROW(boost::bad_lexical_cast());
+    }
+    return boost::lexical_cast<uint64_t>(value);
+  }
+  catch (const boost::bad_lexical_cast&) {
+    NDN_THROW(std::invalid_argument("Value of " + param + " must be a non-negative integer"));
+  }
+}
+
+void
+AggregateStrategy::processParams(const PartialName& params)
+{
+  size_t cacheSize = m_valueCache.getCapacity();
+  time::milliseconds cacheTtl = m_valueCache.getTtl();
+  for (const auto& component : params) {
+    std::string param = component.toUri();
+    auto n = param.find('~');
+    if (n == std::string::npos) {
+      NDN_THROW(std::invalid_argument("AggregateStrategy parameter format is <parameter>~<value>"));
+    }
+    std::string key = param.substr(0, n);
+    std::string value = param.substr(n + 1);
+
+    if (key == "multipath" && (value == "on" || value == "off")) {
+      m_isMultipath = (value == "on");
+    }
+    else if (key == "deadline") {
+      m_deadline = time::milliseconds(getUintParam(key, value));
+    }
+    else if (key == "deadline-margin") {
+      m_deadlineMargin = time::milliseconds(getUintParam(key, value));
+    }
+    else if (key == "retx") {
+      m_maxRetx = static_cast<int>(getUintParam(key, value));
+    }
+    else if (key == "cache-size") {
+      cacheSize = getUintParam(key, value);
+    }
+    else if (key == "cache-ttl") {
+      cacheTtl = time::milliseconds(getUintParam(key, value));
+    }
+    else {
+      NDN_THROW(std::invalid_argument("AggregateStrategy parameter should be multipath~on|off, "
+                                      "deadline~<ms>, deadline-margin~<ms>, retx~<n>, "
+                                      "cache-size~<n> or cache-ttl~<ms>"));
+    }
+  }
+  m_valueCache.setLimits(cacheSize, cacheTtl);
 }
 
 // ** Main logic for processing incoming Interests **
@@ -68,6 +141,13 @@ AggregateStrategy::afterReceiveInterest(const ndn::Interest& interest, const Fac
     return;
   }
 
+  // An entry answered by this strategy stays in the PIT; a late or retransmitted
+  // Interest of the same name reopens it as a fresh aggregate
+  if (pitEntry->isSatisfied) {
+    pitEntry->isSatisfied = false;
+    pitEntry->eraseStrategyInfo<AggregatePitInfo>();
+  }
+
   // 3. If not an aggregate Interest, use default behavior
   Name interestName = interest.getName();
   if (interestName.size() < 2 || interestName.get(0).toUri() != "aggregate") {
@@ -76,25 +156,32 @@ AggregateStrategy::afterReceiveInterest(const ndn::Interest& interest, const Fac
   }
 
   // 4. Parse requested IDs and attach to PIT entry
-  std::set<int> requestedIds = ns3::ndn::AggregateUtils::parseNumbersFromName(interestName);
+  IdSet requestedIds = ns3::ndn::AggregateUtils::parseNumbersFromName(interestName);
   AggregatePitInfo* pitInfo = getAggregatePitInfo(pitEntry);
   pitInfo->neededIds = requestedIds;
   pitInfo->pendingIds = requestedIds;
-  pitInfo->partialSum = 0;
-  pitInfo->dependentInterests.clear();
+  pitInfo->partial = ns3::ndn::AggregateState(ns3::ndn::AggregateOpSpec::select(interestName));
+  pitInfo->subtractIds.clear();
+  pitInfo->subtrahend = ns3::ndn::AggregateState(pitInfo->partial.getSpec());
+  m_pitIndex.insert(pitEntry, requestedIds);
 
-  std::cout << ">> Received Interest " << interestName.toUri()
-            << " from face " << ingress.face.getId() 
-            << " requesting IDs = { ";
-  for (int id : requestedIds) {
-    std::cout << id << " ";
-  }
-  std::cout << "}" << std::endl << std::flush;
+  NS_LOG_DEBUG(">> Received Interest " << interestName.toUri()
+               << " from face " << ingress.face.getId() 
+               << " requesting IDs = " << requestedIds);
+  emitEvent(ns3::ndn::AggregateEventType::INTEREST_RECEIVED, interestName,
+            ingress.face.getId(), requestedIds.size());
 
   // 5. Check if this is a self-generated interest from this producer
-  if (isSelfGeneratedInterest(requestedIds)) {
-    std::cout << "  [SelfGenerated] Producer P" << m_nodeId 
-              << " forwarding self-generated interest to the network" << std::endl;
+  if (isSelfGeneratedInterest(requestedIds, ingress.face)) {
+    NS_LOG_DEBUG("  [SelfGenerated] Producer P" << m_nodeId 
+                 << " forwarding self-generated interest to the network");
+    // On a static tree the request enters at this leaf's parent
+    Face* upstream = m_rule ? getRuleUpstream(ingress.face) : nullptr;
+    if (upstream != nullptr) {
+      this->sendInterest(interest, *upstream, pitEntry);
+      pitEntry->insertOrUpdateInRecord(ingress.face, interest);
+      return;
+    }
     // Just forward the interest normally - don't try to optimize or split it
     forwardRegularInterest(interest, ingress, pitEntry);
     return;
@@ -102,8 +189,8 @@ AggregateStrategy::afterReceiveInterest(const ndn::Interest& interest, const Fac
   
   // 6. Check if this is a direct request for this producer's data
   if (isDirectDataRequest(requestedIds)) {
-    std::cout << "  [DirectRequest] Interest requests P" << m_nodeId 
-              << "'s data directly - forwarding to application" << std::endl;
+    NS_LOG_DEBUG("  [DirectRequest] Interest requests P" << m_nodeId 
+                 << "'s data directly - forwarding to application");
     
     // Forward to application via normal forwarding mechanism
     forwardRegularInterest(interest, ingress, pitEntry);
@@ -115,11 +202,12 @@ AggregateStrategy::afterReceiveInterest(const ndn::Interest& interest, const Fac
     return; // Fully satisfied from cache
   }
 
-  // 8. Check for subset/superset relationships with existing interests
-  checkSubsetSupersetRelationships(interest, pitEntry, pitInfo, requestedIds);
+  // 8. Cover what is left with in-flight aggregates of this round
+  planCover(interest, pitEntry, pitInfo);
 
   // 9. Split and forward interests based on routing
   splitAndForwardInterests(interest, ingress, pitEntry, pitInfo);
+  scheduleDeadline(interest, pitEntry, pitInfo);
 
   // 10. Set expiry timer
   this->setExpiryTimer(pitEntry, interest.getInterestLifetime());
@@ -131,47 +219,42 @@ AggregateStrategy::afterReceiveData(const ndn::Data& data, const FaceEndpoint& i
                                     const std::shared_ptr<pit::Entry>& pitEntry)
 {
   // Log node role and processing time of incoming Data
-  std::cout << ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, m_nodeId - 1) 
-            << " - STRATEGY processing Data: " << data.getName() 
-            << " from face " << ingress.face.getId() 
-            << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds() 
-            << "s" << std::endl << std::flush;
+  NS_LOG_DEBUG(m_nodeRoleString 
+               << " - STRATEGY processing Data: " << data.getName() 
+               << " from face " << ingress.face.getId() 
+               << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds() 
+               << "s");
   // Log the current PIT entry in/out counts
-  std::cout << "  Current PIT entry has " << pitEntry->getInRecords().size() 
-            << " in-faces and " << pitEntry->getOutRecords().size() 
-            << " out-faces" << std::endl;
+  NS_LOG_DEBUG("  Current PIT entry has " << pitEntry->getInRecords().size() 
+               << " in-faces and " << pitEntry->getOutRecords().size() 
+               << " out-faces");
 
   Strategy::afterReceiveData(data, ingress, pitEntry);
+  recordRttSample(ingress, pitEntry);
 
   Name dataName = data.getName();
-  std::cout << "<< Data received: " << dataName.toUri() 
-            << " from face " << ingress.face.getId() << std::endl << std::flush;
+  NS_LOG_DEBUG("<< Data received: " << dataName.toUri() 
+               << " from face " << ingress.face.getId());
 
-  // Dump the current PIT entries for debugging
-  std::cout << "Current PIT entries before processing Data:" << std::endl;
-  Pit& pit = m_forwarder.getPit();
-  for (auto it = pit.begin(); it != pit.end(); ++it) {
-    const pit::Entry& entry = *it;
-    std::cout << "  PIT entry: " << entry.getName() 
-              << " (InFaces=" << entry.getInRecords().size() 
-              << ", OutFaces=" << entry.getOutRecords().size() << ")" << std::endl;
-  }
+  // Summarize PIT state (no full-table walk on the data path)
+  NS_LOG_DEBUG("PIT before processing Data: " << m_forwarder.getPit().size()
+               << " entries, " << m_pitIndex.size() << " indexed aggregate entries");
 
   // Process data using our modular approach
   processSubInterestData(data, dataName, ingress, pitEntry);
-  processWaitingInterestData(data, dataName, ingress, pitEntry);
+  processWaitingInterestData(data, dataName);
   processDirectData(data, dataName, ingress, pitEntry);
 
   // ** Forward the Data to any PIT downstreams as usual (if not already handled) **
   int recordCount = 0;
   for (const auto& inRecord : pitEntry->getInRecords()) {
     Face& outFace = inRecord.getFace();
-    std::cout << "[Forward] Sending Data " << data.getName() 
-              << " to face " << outFace.getId() << std::endl;
+    NS_LOG_DEBUG("[Forward] Sending Data " << data.getName() 
+                 << " to face " << outFace.getId());
     this->sendData(data, outFace, pitEntry);
     recordCount++;
   }
-  std::cout << "  [Forward] Forwarding Data to " << recordCount << " downstream faces" << std::endl << std::flush;
+  NS_LOG_DEBUG("  [Forward] Forwarding Data to " << recordCount << " downstream faces");
 }
 
 // Modify beforeSatisfyInterest method:
@@ -181,45 +264,48 @@ AggregateStrategy::beforeSatisfyInterest(const ndn::Data& data, const FaceEndpoi
                                         const std::shared_ptr<pit::Entry>& pitEntry)
 {
   // Print debug info
-  std::cout << "\n!! RAW DATA RECEIVED BY FORWARDER: " 
-            << ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, m_nodeId - 1)
-            << " received data " << data.getName() 
-            << " from face " << ingress.face.getId() << std::endl;
+  NS_LOG_DEBUG("!! RAW DATA RECEIVED BY FORWARDER: " 
+               << m_nodeRoleString
+               << " received data " << data.getName() 
+               << " from face " << ingress.face.getId());
 
   // Print PIT entry state BEFORE it gets cleared
-  std::cout << "  PIT ENTRY BEFORE SATISFACTION: " << pitEntry->getName()
-            << " (InFaces=" << pitEntry->getInRecords().size()
-            << ", OutFaces=" << pitEntry->getOutRecords().size() << ")" << std::endl;
+  NS_LOG_DEBUG("  PIT ENTRY BEFORE SATISFACTION: " << pitEntry->getName()
+               << " (InFaces=" << pitEntry->getInRecords().size()
+               << ", OutFaces=" << pitEntry->getOutRecords().size() << ")");
 
   // Print all InFaces
-  std::cout << "  InFaces:";
-  for (const auto& inRecord : pitEntry->getInRecords()) {
-    std::cout << " " << inRecord.getFace().getId();
+  if (NDN_AGGREGATE_LOG_ENABLED(ns3::LOG_DEBUG)) {
+    std::ostringstream inFaces;
+    for (const auto& inRecord : pitEntry->getInRecords()) {
+      inFaces << " " << inRecord.getFace().getId();
+    }
+    NS_LOG_DEBUG("  InFaces:" << inFaces.str());
   }
-  std::cout << std::endl;
+
+  recordRttSample(ingress, pitEntry);
 
   Name dataName = data.getName();
-  std::cout << "<< [beforeSatisfyInterest] Processing data: " << dataName.toUri() 
-            << " from face " << ingress.face.getId() << std::endl;
+  NS_LOG_DEBUG("<< [beforeSatisfyInterest] Processing data: " << dataName.toUri() 
+               << " from face " << ingress.face.getId());
 
   // Check if this data should be consumed by the strategy
   bool isSubInterestResponse = (m_parentMap.find(dataName) != m_parentMap.end());
   bool hasWaitingInterests = (m_waitingInterests.find(dataName) != m_waitingInterests.end());
 
-  if (isSubInterestResponse || hasWaitingInterests) {
-    std::cout << "  [Consume] Data " << dataName.toUri() 
-              << " is being handled by the strategy - suppressing forwarding" << std::endl;
+  // Waiting Interests only read the Data; it still goes to this entry's own downstreams
+  if (hasWaitingInterests) {
+    processWaitingInterestData(data, dataName);
+  }
 
-    // Process data - now allows both conditions to be handled
-    if (isSubInterestResponse) {
-      processSubInterestData(data, dataName, ingress, pitEntry);
-    }
-    if (hasWaitingInterests) {  // Changed from "else if" to "if"
-      processWaitingInterestData(data, dataName, ingress, pitEntry);
-    }
+  if (isSubInterestResponse) {
+    NS_LOG_DEBUG("  [Consume] Data " << dataName.toUri() 
+                 << " is being handled by the strategy - suppressing forwarding");
+    processSubInterestData(data, dataName, ingress, pitEntry);
 
     // Mark PIT entry as satisfied (this is essential for cleanup)
     pitEntry->isSatisfied = true;
+    m_pitIndex.erase(*pitEntry);
     
     // Clear in-records to prevent normal data forwarding
     while (!pitEntry->getInRecords().empty()) {
@@ -238,8 +324,8 @@ AggregateStrategy::beforeSatisfyInterest(const ndn::Data& data, const FaceEndpoi
       pitEntry->expiryTimer.cancel();
     }
     
-    std::cout << "  [Cleanup] Cleared all records and marked PIT entry for " << dataName.toUri() 
-              << " as satisfied for removal" << std::endl;
+    NS_LOG_DEBUG("  [Cleanup] Cleared all records and marked PIT entry for " << dataName.toUri() 
+                 << " as satisfied for removal");
     
     // Request immediate cleanup
     cleanupSatisfiedPitEntries();
@@ -248,20 +334,20 @@ AggregateStrategy::beforeSatisfyInterest(const ndn::Data& data, const FaceEndpoi
     return;
   }
   else {
-    std::cout << "  [Forward] Data " << dataName.toUri() 
-              << " will be forwarded downstream by forwarder" << std::endl;
+    NS_LOG_DEBUG("  [Forward] Data " << dataName.toUri() 
+                 << " will be forwarded downstream by forwarder");
 
     // Check if this data should be forwarded downstream to satisfy interests
     if (pitEntry->getInRecords().size() > 0) {
-      std::cout << "  [Downstream] Found " << pitEntry->getInRecords().size() 
-                << " downstream interests to satisfy" << std::endl;
+      NS_LOG_DEBUG("  [Downstream] Found " << pitEntry->getInRecords().size() 
+                   << " downstream interests to satisfy");
       
       // Log each downstream face for debugging
       for (const auto& inRecord : pitEntry->getInRecords()) {
-          std::cout << "    Will forward to face: " << inRecord.getFace().getId() << std::endl;
+          NS_LOG_DEBUG("    Will forward to face: " << inRecord.getFace().getId());
       }
     } else {
-        std::cout << "  [Warning] No downstream faces to forward data to!" << std::endl;
+        NS_LOG_DEBUG("  [Warning] No downstream faces to forward data to!");
     }
 
     // Process as direct data
@@ -280,25 +366,23 @@ AggregateStrategy::registerPitExpirationCallback()
   // Register a callback for PIT entry expiration using NFD's signal mechanism
   m_forwarder.beforeExpirePendingInterest.connect(
     [this] (const pit::Entry& pitEntry) {
-      // Get node role and ID for logging
-      uint32_t nodeIndex = m_nodeId - 1;
-      std::string nodeRoleStr = ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, nodeIndex);
-      
-      std::cout << "!! PIT EXPIRED: " << nodeRoleStr << " - " << pitEntry.getName().toUri()
-                << " at " << std::fixed << std::setprecision(2) 
-                << ns3::Simulator::Now().GetSeconds() << "s" << std::endl << std::flush;
+      // Expired entries must not be matched by later Interests
+      m_pitIndex.erase(pitEntry);
+
+      NS_LOG_DEBUG("!! PIT EXPIRED: " << m_nodeRoleString << " - " << pitEntry.getName().toUri()
+                   << " at " << std::fixed << std::setprecision(2) 
+                   << ns3::Simulator::Now().GetSeconds() << "s");
                 
       // Log details of the expired entry
       AggregatePitInfo* pitInfo = pitEntry.getStrategyInfo<AggregatePitInfo>();
       if (pitInfo) {
-        std::cout << "  [Expired] " << pitInfo->pendingIds.size() << " pending IDs: { ";
-        for (int id : pitInfo->pendingIds) {
-          std::cout << id << " ";
-        }
-        std::cout << "}" << std::endl << std::flush;
+        NS_LOG_DEBUG("  [Expired] " << pitInfo->pendingIds.size() << " pending IDs: "
+                     << pitInfo->pendingIds);
+        emitEvent(ns3::ndn::AggregateEventType::PIT_EXPIRED, pitEntry.getName(),
+                  0, pitInfo->pendingIds.size());
       }
     });
-  std::cout << "PIT expiration handler registered!" << std::endl << std::flush;
+  NS_LOG_DEBUG("PIT expiration handler registered!");
 }
 
 // Update the beforeExpirePendingInterest method as well:
@@ -306,23 +390,16 @@ AggregateStrategy::registerPitExpirationCallback()
 void 
 AggregateStrategy::beforeExpirePendingInterest(const std::shared_ptr<pit::Entry>& pitEntry)
 {
-  // Get node role and ID for logging
-  uint32_t nodeIndex = m_nodeId - 1;
-  std::string nodeRoleStr = ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, nodeIndex);
-  
   Name interestName = pitEntry->getName();
-  std::cout << "!! PIT EXPIRED: " << nodeRoleStr << " - " << interestName.toUri()
-            << " at " << std::fixed << std::setprecision(2) 
-            << ns3::Simulator::Now().GetSeconds() << "s" << std::endl << std::flush;
+  NS_LOG_DEBUG("!! PIT EXPIRED: " << m_nodeRoleString << " - " << interestName.toUri()
+               << " at " << std::fixed << std::setprecision(2) 
+               << ns3::Simulator::Now().GetSeconds() << "s");
 
   // Log details about the expired entry
   AggregatePitInfo* pitInfo = pitEntry->getStrategyInfo<AggregatePitInfo>();
   if (pitInfo) {
-    std::cout << "  [Expired] " << pitInfo->pendingIds.size() << " pending IDs: { ";
-    for (int id : pitInfo->pendingIds) {
-      std::cout << id << " ";
-    }
-    std::cout << "}" << std::endl << std::flush;
+    NS_LOG_DEBUG("  [Expired] " << pitInfo->pendingIds.size() << " pending IDs: "
+                 << pitInfo->pendingIds);
   }
 }
 
@@ -331,10 +408,10 @@ AggregateStrategy::processDataForAggregation(const ndn::Data& data, const FaceEn
                                              const std::shared_ptr<pit::Entry>& pitEntry)
 {
   // Log processing of incoming Data and PIT entry state
-  std::cout << "  PROCESSING DATA: " << data.getName()
-            << " for PIT entry: " << pitEntry->getName()
-            << " (InFaces=" << pitEntry->getInRecords().size()
-            << ", OutFaces=" << pitEntry->getOutRecords().size() << ")" << std::endl << std::flush;
+  NS_LOG_DEBUG("  PROCESSING DATA: " << data.getName()
+               << " for PIT entry: " << pitEntry->getName()
+               << " (InFaces=" << pitEntry->getInRecords().size()
+               << ", OutFaces=" << pitEntry->getOutRecords().size() << ")");
 }
 
 void 
@@ -347,138 +424,79 @@ AggregateStrategy::processSubInterestData(const ndn::Data& data, const Name& dat
   if (!parentPit || !parentInfo) {
     return; // Invalid parent entry
   }
+  if (parentPit->isSatisfied) {
+    // Late answer to a parent that already replied at its deadline
+    m_parentMap.erase(dataName);
+    return;
+  }
+  IdSet dataIds = ns3::ndn::AggregateUtils::parseNumbersFromName(dataName);
+  if (!dataIds.isSubsetOf(parentInfo->pendingIds) && !dataIds.isSubsetOf(parentInfo->subtractIds)) {
+    // A retransmission already delivered some of these IDs; merging again would count them twice
+    NS_LOG_DEBUG("  [SubInterest] Ignoring duplicate contribution " << dataName.toUri());
+    return;
+  }
 
   // 2. Update parent with data from this sub-interest
   updateParentWithSubInterestData(data, dataName, parentInfo);
 
   // 3. If all components have arrived, satisfy the parent interest
-  if (parentInfo->pendingIds.empty()) {
+  if (isAggregateComplete(parentInfo)) {
     // Send aggregated data to parent faces
     sendAggregatedDataToParentFaces(parentPit, parentInfo);
-    // Process any piggybacked interests
-    satisfyPiggybackedInterests(parentInfo);
     // Important: Only remove the mapping after we've finished using it
     m_parentMap.erase(dataName);
-    std::cout << "  [SubInterest] Removed parent mapping for " << dataName.toUri() << std::endl << std::flush;
+    NS_LOG_DEBUG("  [SubInterest] Removed parent mapping for " << dataName.toUri());
   }
 }
 
 void 
-AggregateStrategy::processWaitingInterestData(const ndn::Data& data, const Name& dataName, 
-                                              const FaceEndpoint& ingress,
-                                              const std::shared_ptr<pit::Entry>& pitEntry)
+AggregateStrategy::processWaitingInterestData(const ndn::Data& data, const Name& dataName)
 {
   auto waitIt = m_waitingInterests.find(dataName);
   if (waitIt == m_waitingInterests.end()) {
     return; // No waiting interests
   }
+  // Completing a waiting Interest may complete Interests waiting on it in turn
+  std::vector<std::weak_ptr<pit::Entry>> waitingPits = std::move(waitIt->second);
+  m_waitingInterests.erase(waitIt);
 
-  std::cout << "  [WaitingInterest] Found " << waitIt->second.size() 
-            << " interests waiting for Data " << dataName.toUri() << std::endl << std::flush;
-
-  // Extract value from data
-  uint64_t value = ns3::ndn::AggregateUtils::extractValueFromContent(data);
-
-  // Extract IDs covered by this data
-  std::set<int> dataIds = ns3::ndn::AggregateUtils::parseNumbersFromName(dataName);
+  NS_LOG_DEBUG("  [WaitingInterest] Found " << waitingPits.size() 
+               << " interests waiting for Data " << dataName.toUri());
 
-  // Process each waiting interest immediately
-  for (auto& weakPit : waitIt->second) {
+  for (auto& weakPit : waitingPits) {
     auto waitingPit = weakPit.lock();
     if (!waitingPit) continue;
 
     AggregatePitInfo* waitingInfo = waitingPit->getStrategyInfo<AggregatePitInfo>();
-    if (!waitingInfo) continue;
-
-    // Update waiting interest's state with new data
-    waitingInfo->partialSum += value;
-    for (int gotId : dataIds) {
-      waitingInfo->pendingIds.erase(gotId);
-      // Also remove this ID from the waitingFor map if present
-      if (waitingInfo->waitInfo) {
-        // Check if this exact data name was what we were waiting for
-        auto it = waitingInfo->waitInfo->waitingFor.begin();
-        while (it != waitingInfo->waitInfo->waitingFor.end()) {
-          if (it->second == dataName) {
-            std::cout << "    [Tracking] Removed ID " << it->first 
-                      << " from waiting list (data has arrived)" << std::endl;
-            it = waitingInfo->waitInfo->waitingFor.erase(it);
-          } else {
-            ++it;
-          }
-        }
-      }
-    }
-
-    std::cout << "    [Piggyback] Data " << dataName.toUri() << " received for waiting Interest " 
-              << waitingPit->getName().toUri() << std::endl;
-    // Log the remaining IDs for this waiting interest
-    std::cout << "    [Debug] Waiting interest has " << waitingInfo->pendingIds.size() 
-              << " remaining IDs: { ";
-    for (int id : waitingInfo->pendingIds) {
-      std::cout << id << " ";
-    }
-    std::cout << "}" << std::endl << std::flush;
-
-    // If that waiting interest now has no pending IDs left, check if we have all needed data
-    if (waitingInfo->pendingIds.empty()) {
-      // Check if we're still waiting for data from other interests
-      bool stillWaitingForData = false;
-      if (waitingInfo->waitInfo) {
-        // Print waiting IDs for debugging
-        std::cout << "  [WaitingMap] Interest is waiting for " 
-                  << waitingInfo->waitInfo->waitingFor.size() << " IDs from other interests: { ";
-        for (const auto& pair : waitingInfo->waitInfo->waitingFor) {
-          std::cout << pair.first << " (from " << pair.second.toUri() << ") ";
-          stillWaitingForData = true;
-        }
-        std::cout << "}" << std::endl << std::flush;
-      }
-
-      if (stillWaitingForData) {
-        std::cout << "  [WaitingInterest] Interest has empty pendingIds but is still waiting for data from other interests" 
-                  << std::endl << std::flush;
-        continue;
+    if (!waitingInfo || !waitingInfo->waitInfo || waitingPit->isSatisfied) continue;
+
+    // Only the IDs the cover plan assigned to this Data are released; any others it
+    // carries are taken out through the subtrahend
+    size_t nReleased = 0;
+    auto& waitingFor = waitingInfo->waitInfo->waitingFor;
+    for (auto it = waitingFor.begin(); it != waitingFor.end();) {
+      if (it->second == dataName) {
+        it = waitingFor.erase(it);
+        ++nReleased;
       }
-
-      // Only proceed if we have all data (no pendingIds and no waitingFor entries)
-      std::cout << "  [WaitingInterest] All components received for waiting interest, creating final Data" 
-                << std::endl << std::flush;
-
-      if (!stillWaitingForData) {
-        // Create and send the aggregated data
-        Name childName = waitingPit->getName();
-        auto childData = ns3::ndn::AggregateUtils::createDataWithValue(childName, waitingInfo->partialSum);
-        // Identify outgoing faces by examining the original incoming face
-        std::vector<Face*> outFaces;
-        for (const auto& inRec : waitingPit->getInRecords()) {
-          outFaces.push_back(&inRec.getFace());
-        }
-        // Send data directly to each face without using PIT
-        for (Face* outFace : outFaces) {
-          try {
-            outFace->sendData(*childData);
-            std::cout << "<< Sent aggregate Data for waiting Interest " << childName.toUri() 
-                      << " with sum = " << waitingInfo->partialSum
-                      << " to face " << outFace->getId() 
-                      << " (direct send, bypassing PIT)" << std::endl;
-          }
-          catch (const std::exception& e) {
-            std::cout << "  [ERROR] Failed to send waiting interest data: " << e.what() << std::endl;
-          }
-        }
-        if (outFaces.empty()) {
-          std::cout << "  [WARNING] Waiting interest has no InRecords - cannot send data" << std::endl;
-        }
+      else {
+        ++it;
       }
-    } else {
-      std::cout << "  [WaitingInterest] Interest still waiting for " << waitingInfo->pendingIds.size() 
-                << " more IDs" << std::endl << std::flush;
+    }
+    if (nReleased == 0) continue;
+
+    waitingInfo->partial.merge(ns3::ndn::AggregateUtils::extractStateFromContent(
+      data, waitingInfo->partial.getSpec(), waitingInfo->missingIds));
+    NS_LOG_DEBUG("    [Piggyback] Data " << dataName.toUri() << " provides " << nReleased
+                 << " IDs to waiting Interest " << waitingPit->getName().toUri()
+                 << " (" << waitingInfo->pendingIds.size() << " pending, "
+                 << waitingFor.size() << " still waited for)");
+
+    if (isAggregateComplete(waitingInfo)) {
+      NS_LOG_DEBUG("  [WaitingInterest] All components received for waiting interest, creating final Data");
+      sendAggregatedDataToParentFaces(waitingPit, waitingInfo);
     }
   }
-
-  // Remove this entry from waiting list after processing all interests
-  m_waitingInterests.erase(waitIt);
 }
 
 void
@@ -491,21 +509,16 @@ AggregateStrategy::processDirectData(const ndn::Data& data, const Name& dataName
     return;
   }
 
-  std::cout << "  [DirectData] Processing regular Data packet (not sub-interest)" << std::endl << std::flush;
-
-  // If dataName is atomic (e.g., "/aggregate/<id>"), cache its value
-  if (dataName.size() == 2) {
-    std::cout << "  [DirectData] Processing atomic data for single ID" << std::endl << std::flush;
-    try {
-      int id = std::stoi(dataName.get(1).toUri());
-      uint64_t val = ns3::ndn::AggregateUtils::extractValueFromContent(data);
-      // Store in cache
-      m_cachedValues[id] = val;
-      std::cout << "  [CacheStore] Cached value for ID " << id << " = " << val << std::endl << std::flush;
-    } 
-    catch (...) {
-      std::cout << "  [DirectData] Failed to parse ID as integer" << std::endl << std::flush;
-    }
+  NS_LOG_DEBUG("  [DirectData] Processing regular Data packet (not sub-interest)");
+
+  // A raw sample of a single producer is cached for its round, as in updateParentWithSubInterestData
+  IdSet dataIds = ns3::ndn::AggregateUtils::parseNumbersFromName(dataName);
+  if (dataIds.size() == 1 && !ns3::ndn::AggregateOpSpec::select(dataName).isVector() &&
+      ns3::ndn::AggregateState::isScalarContent(data.getContent().value_size())) {
+    int id = dataIds.min();
+    uint64_t value = ns3::ndn::AggregateUtils::extractValueFromContent(data);
+    m_valueCache.insertSample(dataName, id, value);
+    NS_LOG_DEBUG("  [CacheStore] Cached value for ID " << id << " = " << value);
   }
   return;
 }
@@ -514,19 +527,14 @@ AggregateStrategy::processDirectData(const ndn::Data& data, const Name& dataName
 
 AggregateStrategy::AggregatePitInfo* 
 AggregateStrategy::getAggregatePitInfo(const std::shared_ptr<pit::Entry>& pitEntry) {
-  auto infoPair = pitEntry->insertStrategyInfo<AggregatePitInfo>();
-  AggregatePitInfo* info = static_cast<AggregatePitInfo*>(infoPair.first);
-  if (infoPair.second) {
-    // Newly inserted info, initialize fields
-    info->partialSum = 0;
-  }
-  return info;
+  // Newly inserted info starts with an empty SUM state; afterReceiveInterest selects the operator
+  return pitEntry->insertStrategyInfo<AggregatePitInfo>().first;
 }
 
 // Helper for Producer Interest Handling
 
 bool 
-AggregateStrategy::isSelfGeneratedInterest(const std::set<int>& requestedIds)
+AggregateStrategy::isSelfGeneratedInterest(const IdSet& requestedIds, const Face& ingress)
 {
   // 1. Check if this is a producer node
   if (m_nodeRole != ns3::ndn::AggregateUtils::NodeRole::PRODUCER) {
@@ -538,14 +546,16 @@ AggregateStrategy::isSelfGeneratedInterest(const std::set<int>& requestedIds)
   
   // 3. For a self-generated interest, this producer's ID should NOT be in the requested set
   // AND the interest should be requesting multiple IDs (typically all other IDs)
-  bool ownIdNotRequested = (requestedIds.find(producerId) == requestedIds.end());
+  bool ownIdNotRequested = !requestedIds.contains(producerId);
   bool isMultipleIdRequest = (requestedIds.size() > 1);
+  // Allreduce: the local consumer asks for the global aggregate, its own ID included
+  bool isFromLocalApp = ingress.getScope() == ndn::nfd::FACE_SCOPE_LOCAL;
   
-  return (ownIdNotRequested && isMultipleIdRequest);
+  return ((ownIdNotRequested || isFromLocalApp) && isMultipleIdRequest);
 }
 
 bool
-AggregateStrategy::isDirectDataRequest(const std::set<int>& requestedIds)
+AggregateStrategy::isDirectDataRequest(const IdSet& requestedIds)
 {
   // Only applies to producer nodes
   if (m_nodeRole != ns3::ndn::AggregateUtils::NodeRole::PRODUCER) {
@@ -556,7 +566,7 @@ AggregateStrategy::isDirectDataRequest(const std::set<int>& requestedIds)
   int producerId = m_nodeId;
   
   // Interest is a direct request if it ONLY asks for this producer's ID
-  return (requestedIds.size() == 1 && requestedIds.find(producerId) != requestedIds.end());
+  return (requestedIds.size() == 1 && requestedIds.contains(producerId));
 }
 
 // Debug helper functions for afterReceiveInterest
@@ -564,24 +574,25 @@ AggregateStrategy::isDirectDataRequest(const std::set<int>& requestedIds)
 void 
 AggregateStrategy::logDebugInfo(const ndn::Interest& interest, const FaceEndpoint& ingress)
 {
-  std::cout << '\n' << ns3::ndn::AggregateUtils::getNodeRoleString(m_nodeRole, m_nodeId - 1)
-            << " - STRATEGY received Interest: " << interest.getName() 
-            << " via " << ingress.face.getId() 
-            << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds() 
-            << "s" << std::endl << std::flush;
+  if (!NDN_AGGREGATE_LOG_ENABLED(ns3::LOG_DEBUG)) {
+    return;
+  }
+
+  NS_LOG_DEBUG(m_nodeRoleString
+               << " - STRATEGY received Interest: " << interest.getName()
+               << " via " << ingress.face.getId()
+               << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds()
+               << "s");
 
   // Debug: Print PIT info
   printPitDebugInfo(m_forwarder.getPit());
 
-  // Debug: Print FIB info
-  Fib& fib = m_forwarder.getFib();
-  std::cout << "DEBUG: FIB table has " << std::distance(fib.begin(), fib.end()) << " entries" << std::endl << std::flush;
-  std::cout << "DEBUG: Current FIB entries:" << std::endl;
-  for (const auto& fibEntry : fib) {
-    std::cout << "  - Prefix: " << fibEntry.getPrefix() << " (Nexthops: " << fibEntry.getNextHops().size() << ")" << std::endl;
-    for (const auto& nh : fibEntry.getNextHops()) {
-      std::cout << "    * Face: " << nh.getFace().getId() << " Cost: " << nh.getCost() << std::endl;
-    }
+  // Debug: Print only the FIB entry this Interest matches
+  const fib::Entry& fibEntry = m_forwarder.getFib().findLongestPrefixMatch(interest.getName());
+  NS_LOG_DEBUG("DEBUG: FIB match for Interest: " << fibEntry.getPrefix()
+               << " (Nexthops: " << fibEntry.getNextHops().size() << ")");
+  for (const auto& nh : fibEntry.getNextHops()) {
+    NS_LOG_DEBUG("    * Face: " << nh.getFace().getId() << " Cost: " << nh.getCost());
   }
 }
 
@@ -592,40 +603,30 @@ AggregateStrategy::handleSingleFaceForwarding(const Interest& interest, const Fa
                                            const std::map<Face*, std::vector<int>>& faceToIdsMap)
 {
   Face* outFace = faceToIdsMap.begin()->first;
-  std::cout << "OPTIMIZATION: All " << pitInfo->pendingIds.size() 
-            << " IDs route to the same face (ID: " << outFace->getId() 
-            << ")." << std::endl;
+  NS_LOG_DEBUG("OPTIMIZATION: All " << pitInfo->pendingIds.size() 
+               << " IDs route to the same face (ID: " << outFace->getId() 
+               << ").");
   
   // Check if original interest already has exactly what we need
   bool needsRewrite = false;
-  std::set<int> originalInterestIds = ns3::ndn::AggregateUtils::parseNumbersFromName(interest.getName());
+  IdSet originalInterestIds = ns3::ndn::AggregateUtils::parseNumbersFromName(interest.getName());
   if (originalInterestIds != pitInfo->pendingIds) {
     needsRewrite = true;
   }
   
   if (needsRewrite) {
     // Create optimized interest with only pending IDs
-    std::vector<int> pendingIdsList(pitInfo->pendingIds.begin(), pitInfo->pendingIds.end());
-    std::sort(pendingIdsList.begin(), pendingIdsList.end());
-    
     Name optimizedName;
     optimizedName.append("aggregate");
-    for (int id : pendingIdsList) {
-      optimizedName.appendNumber(id);
-    }
+    ns3::ndn::AggregateUtils::appendIdSet(optimizedName, pitInfo->pendingIds);
+    appendRoundComponents(optimizedName, interest.getName());
 
-    // Preserve sequence number if present
-    Name::Component seqComponent = ns3::ndn::AggregateUtils::extractSequenceComponent(interest.getName());
-    if (!seqComponent.empty()) {
-      optimizedName.append(seqComponent);
-    }
-
-    std::cout << "  >> Creating optimized interest with only pending IDs: " 
-              << optimizedName << std::endl;
+    NS_LOG_DEBUG("  >> Creating optimized interest with only pending IDs: " 
+                 << optimizedName);
               
     // Create and forward the optimized interest
     auto optimizedInterest = ns3::ndn::AggregateUtils::createSplitInterest(
-      optimizedName, interest.getInterestLifetime());
+      optimizedName, getSubInterestLifetime(interest));
 
     // Insert into PIT and set up parent relationship
     auto newPitEntry = m_forwarder.getPit().insert(*optimizedInterest).first;
@@ -636,59 +637,69 @@ AggregateStrategy::handleSingleFaceForwarding(const Interest& interest, const Fa
 
     // Add to parent map
     m_parentMap[optimizedName] = pitEntry;
+    m_pitIndex.insert(newPitEntry, pitInfo->pendingIds);
 
     // Send and preserve in-records
     this->sendInterest(*optimizedInterest, *outFace, newPitEntry);
+    emitEvent(ns3::ndn::AggregateEventType::SUB_INTEREST_SENT, optimizedName,
+              outFace->getId(), pitInfo->pendingIds.size());
     
     // Copy original InRecords
     for (const auto& inRecord : pitEntry->getInRecords()) {
       newPitEntry->insertOrUpdateInRecord(inRecord.getFace(), *optimizedInterest);
-      std::cout << "  [PRESERVED] Copied InRecord from original PIT entry (face " 
-                << inRecord.getFace().getId() << ") to optimized PIT entry" << std::endl;
+      NS_LOG_DEBUG("  [PRESERVED] Copied InRecord from original PIT entry (face " 
+                   << inRecord.getFace().getId() << ") to optimized PIT entry");
     }
 
     // If no InRecords, use ingress face
     if (pitEntry->getInRecords().empty()) {
       newPitEntry->insertOrUpdateInRecord(ingress.face, *optimizedInterest);
-      std::cout << "  [PRESERVED] Added ingress face " << ingress.face.getId() 
-                << " as InRecord for optimized PIT entry" << std::endl;
+      NS_LOG_DEBUG("  [PRESERVED] Added ingress face " << ingress.face.getId() 
+                   << " as InRecord for optimized PIT entry");
+    }
+    if (subInfo) {
+      armRetxTimer(newPitEntry, subInfo->retx, *outFace, getSubInterestLifetime(interest));
     }
   } 
   else {
     // Forward original interest directly
-    std::cout << "  >> Forwarding original interest directly - no optimization needed" << std::endl;
-    this->sendInterest(interest, *outFace, pitEntry);
+    NS_LOG_DEBUG("  >> Forwarding original interest directly - no optimization needed");
+    if (m_deadline > 0_ms) {
+      // Same name, but upstream must answer before this hop's deadline
+      ndn::Interest shortened(interest);
+      shortened.setInterestLifetime(getSubInterestLifetime(interest));
+      this->sendInterest(shortened, *outFace, pitEntry);
+    }
+    else {
+      this->sendInterest(interest, *outFace, pitEntry);
+    }
+    emitEvent(ns3::ndn::AggregateEventType::SUB_INTEREST_SENT, interest.getName(), outFace->getId(),
+              pitInfo->pendingIds.size());
 
     // Restore InRecord
     pitEntry->insertOrUpdateInRecord(ingress.face, interest);
-    std::cout << "  [PRESERVED] Restored InRecord for face " << ingress.face.getId() 
-              << " in PIT entry for " << interest.getName() << std::endl;
+    NS_LOG_DEBUG("  [PRESERVED] Restored InRecord for face " << ingress.face.getId() 
+                 << " in PIT entry for " << interest.getName());
+    armRetxTimer(pitEntry, pitInfo->retx, *outFace, getSubInterestLifetime(interest));
   }
 }
 
 void 
 AggregateStrategy::printPitDebugInfo(const Pit& pit)
 {
-  std::cout << "Current PIT entries before forwarding Interest:" << std::endl;
-  for (auto it = pit.begin(); it != pit.end(); ++it) {
-    const pit::Entry& entry = *it;
-    std::cout << "  PIT entry: " << entry.getName() 
-              << " (InFaces=" << entry.getInRecords().size() 
-              << ", OutFaces=" << entry.getOutRecords().size();
-    
-    // Add expiry status - properly checking expiryTimer
-    if (entry.expiryTimer) {
-      std::cout << ", has timer";
-    } else {
-      std::cout << ", no timer";
-    }
-    
-    // Check if entry is satisfied
-    if (entry.isSatisfied) {
-      std::cout << ", SATISFIED";  
-    }
-    
-    std::cout << ")" << std::endl;
+  // Only table-level counters; walking every entry per packet is O(|PIT|)
+  NS_LOG_DEBUG("PIT before forwarding Interest: " << pit.size() << " entries, "
+               << m_pitIndex.size() << " indexed aggregate entries in "
+               << m_pitIndex.getRoundCount() << " rounds");
+}
+
+void
+AggregateStrategy::emitEvent(ns3::ndn::AggregateEventType type, const Name& name,
+                             uint64_t faceId, size_t idCount) const
+{
+  const auto& sink = ns3::ndn::AggregateEventSink::getInstance();
+  if (sink.isEnabled(type)) {
+    sink.emit({ns3::Simulator::Now().GetSeconds(), m_nodeId, type, name, faceId, idCount});
   }
 }
 
@@ -696,6 +707,17 @@ bool
 AggregateStrategy::checkInterestAggregation(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                             const std::shared_ptr<pit::Entry>& pitEntry)
 {
+  // Check #0: the same aggregate is already being assembled here; a split entry has no
+  // OutRecords of its own, and the result goes to every InRecord, the new one included
+  auto assembling = pitEntry->getStrategyInfo<AggregatePitInfo>();
+  if (!pitEntry->isSatisfied && assembling != nullptr && !assembling->neededIds.empty()) {
+    NS_LOG_DEBUG("  [Interest Aggregation] Interest " << interest.getName()
+                 << " joins the aggregate in progress (face " << ingress.face.getId() << ")");
+    emitEvent(ns3::ndn::AggregateEventType::PIGGYBACK, interest.getName(),
+              ingress.face.getId(), assembling->neededIds.size());
+    return true;
+  }
+
   // Check #1: Interest has already been forwarded (has OutRecords)
   if (pitEntry->hasOutRecords()) {
     bool isSameFaceDuplicate = false;
@@ -708,33 +730,30 @@ AggregateStrategy::checkInterestAggregation(const ndn::Interest& interest, const
       }
     }
     if (isSameFaceDuplicate) {
-      std::cout << "  [Interest Aggregation] Duplicate interest from same face detected" << std::endl;
-      std::cout << "  [Interest Aggregation] Interest " << interest.getName() 
-                << " already forwarded - suppressing redundant forwarding" << std::endl;
+      NS_LOG_DEBUG("  [Interest Aggregation] Duplicate interest from same face detected");
+      NS_LOG_DEBUG("  [Interest Aggregation] Interest " << interest.getName() 
+                   << " already forwarded - suppressing redundant forwarding");
       return true;  // Aggregated (no need to forward again)
     }
     if (isDifferentFaceDuplicate) {
-      std::cout << "  [Interest Aggregation] Duplicate interest from different face detected" << std::endl;
-      std::cout << "  [Interest Aggregation] Interest " << interest.getName() 
-                << " aggregated (added face " << ingress.face.getId() 
-                << " to existing PIT entry)" << std::endl;
+      NS_LOG_DEBUG("  [Interest Aggregation] Duplicate interest from different face detected");
+      NS_LOG_DEBUG("  [Interest Aggregation] Interest " << interest.getName() 
+                   << " aggregated (added face " << ingress.face.getId() 
+                   << " to existing PIT entry)");
       return true;  // Aggregated (added another in-face to existing PIT entry)
     }
   }
 
   // Check #2: Another PIT entry exists with the same name that has been forwarded
-  Pit& pitTable = m_forwarder.getPit();
-  for (auto it = pitTable.begin(); it != pitTable.end(); ++it) {
-    const pit::Entry& entryRef = *it;
-    if (&entryRef == pitEntry.get()) {
-      continue;
-    }
-    if (entryRef.getName() == interest.getName() && entryRef.hasOutRecords()) {
-      std::cout << "  [Interest Aggregation] Duplicate interest " << interest.getName() 
-                << " detected across different PIT entries" << std::endl;
-      std::cout << "  [Interest Aggregation] Original PIT entry with "
-                << entryRef.getInRecords().size() << " in-faces and "
-                << entryRef.getOutRecords().size() << " out-faces" << std::endl;
+  if (ns3::ndn::AggregateUtils::isAggregationName(interest.getName())) {
+    IdSet ids = ns3::ndn::AggregateUtils::parseNumbersFromName(interest.getName());
+    auto existing = m_pitIndex.findExact(interest.getName(), ids, pitEntry.get());
+    if (existing && existing->getName() == interest.getName() && existing->hasOutRecords()) {
+      NS_LOG_DEBUG("  [Interest Aggregation] Duplicate interest " << interest.getName() 
+                   << " detected across different PIT entries");
+      NS_LOG_DEBUG("  [Interest Aggregation] Original PIT entry with "
+                   << existing->getInRecords().size() << " in-faces and "
+                   << existing->getOutRecords().size() << " out-faces");
       return true;  // Aggregated (similar interest already forwarded)
     }
   }
@@ -749,18 +768,20 @@ AggregateStrategy::forwardRegularInterest(const ndn::Interest& interest, const F
   // Get the FIB entry
   const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
 
-  // Find a face to forward to (first available nexthop)
+  // Find a face to forward to (first available nexthop, or the least loaded equal-cost one)
   const fib::NextHopList& nexthops = fibEntry.getNextHops();
   if (!nexthops.empty()) {
-    Face& outFace = nexthops.begin()->getFace();
-    std::cout << "[Strategy] Forwarding regular Interest " 
-              << interest.getName() << " to face " << outFace.getId() << std::endl;
+    Face& outFace = m_isMultipath ?
+                    *m_balancer.pick(AggregateMultipathBalancer::getEqualCostFaces(fibEntry, ingress.face)) :
+                    nexthops.begin()->getFace();
+    NS_LOG_DEBUG("[Strategy] Forwarding regular Interest " 
+                 << interest.getName() << " to face " << outFace.getId());
     this->sendInterest(interest, outFace, pitEntry);
 
     // Preserve the InRecord that NDN would remove during forwarding
     pitEntry->insertOrUpdateInRecord(ingress.face, interest);
-    std::cout << "  [PRESERVED] Restored InRecord for face " 
-              << ingress.face.getId() << " in PIT entry for " << interest.getName() << std::endl;
+    NS_LOG_DEBUG("  [PRESERVED] Restored InRecord for face " 
+                 << ingress.face.getId() << " in PIT entry for " << interest.getName());
   }
 }
 
@@ -768,127 +789,130 @@ bool
 AggregateStrategy::processContentStoreHits(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                            const std::shared_ptr<pit::Entry>& pitEntry, AggregatePitInfo* pitInfo)
 {
-  // Check if we can satisfy some requested IDs from cache
-  for (auto it = pitInfo->pendingIds.begin(); it != pitInfo->pendingIds.end();) {
-    int id = *it;
-    if (m_cachedValues.find(id) != m_cachedValues.end()) {
-      uint64_t cachedValue = m_cachedValues[id];
-      pitInfo->partialSum += cachedValue;
-      std::cout << "  [CacheHit] Value for ID " << id << " = " 
-                << cachedValue << " (from CS)" << std::endl << std::flush;
-      it = pitInfo->pendingIds.erase(it);
-      continue;
-    }
-    ++it;
+  // Check if we can satisfy some requested IDs from cached partials and samples of this round
+  IdSet cachedIds = m_valueCache.cover(interest.getName(), pitInfo->pendingIds, pitInfo->partial);
+  pitInfo->pendingIds.subtract(cachedIds);
+  if (!cachedIds.empty()) {
+    NS_LOG_DEBUG("  [CacheHit] IDs " << cachedIds << " answered from cache, partial "
+                 << pitInfo->partial.toString());
+    emitEvent(ns3::ndn::AggregateEventType::CACHE_HIT, interest.getName(),
+              ingress.face.getId(), cachedIds.size());
   }
 
   // If all IDs were satisfied from cache, create a Data packet and satisfy the interest
   if (pitInfo->pendingIds.empty()) {
-    uint64_t totalSum = pitInfo->partialSum;
-    auto data = ns3::ndn::AggregateUtils::createDataWithValue(interest.getName(), totalSum);
+    auto data = ns3::ndn::AggregateUtils::createDataWithState(interest.getName(), pitInfo->partial);
     for (const auto& inRecord : pitEntry->getInRecords()) {
       Face& outFace = inRecord.getFace();
       this->sendData(*data, outFace, pitEntry);
+      emitEvent(ns3::ndn::AggregateEventType::AGGREGATE_SENT, interest.getName(),
+                outFace.getId(), pitInfo->neededIds.size());
     }
-    std::cout << "<< Satisfied Interest " << interest.getName().toUri() 
-              << " from cache with sum = " << totalSum << std::endl << std::flush;
+    NS_LOG_DEBUG("<< Satisfied Interest " << interest.getName().toUri() 
+                 << " from cache with " << pitInfo->partial.toString());
     return true;  // Fully satisfied from cache
   }
 
   return false;  // Not fully satisfied
 }
 
-void 
-AggregateStrategy::checkSubsetSupersetRelationships(const ndn::Interest& interest,
-                                                   const std::shared_ptr<pit::Entry>& pitEntry,
-                                                   AggregatePitInfo* pitInfo,
-                                                   const std::set<int>& requestedIds)
+void
+AggregateStrategy::planCover(const ndn::Interest& interest, const std::shared_ptr<pit::Entry>& pitEntry,
+                             AggregatePitInfo* pitInfo)
 {
-  Name interestName = interest.getName();
-  Pit& pitTable = m_forwarder.getPit();
-  for (auto it = pitTable.begin(); it != pitTable.end(); ++it) {
-    const pit::Entry& entryRef = *it;
-    // Skip if not an aggregate interest or the same PIT entry
-    Name existingName = entryRef.getName();
-    if (existingName.size() < 2 || existingName.get(0).toUri() != "aggregate" ||
-        &entryRef == pitEntry.get()) {
-      continue;
+  const Name& interestName = interest.getName();
+  // The difference form needs an invertible operator and upstream answers without gaps
+  bool canSubtract = pitInfo->partial.isInvertible() && m_deadline == 0_ms;
+
+  std::vector<AggregatePitIndex::Match> candidates =
+    m_pitIndex.findOverlapping(interestName, pitInfo->pendingIds, pitEntry.get());
+  while (!pitInfo->pendingIds.empty() && !candidates.empty()) {
+    // Greedy: take the in-flight aggregate that saves the most upstream ID references
+    size_t best = candidates.size();
+    int64_t bestGain = 0;
+    IdSet bestFetch;
+    ns3::ndn::AggregateState bestCached(pitInfo->partial.getSpec());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      IdSet extra = candidates[i].ids;
+      extra.subtract(pitInfo->pendingIds);
+      int64_t gain = static_cast<int64_t>(candidates[i].ids.size() - extra.size());
+      ns3::ndn::AggregateState cached(pitInfo->partial.getSpec());
+      if (!extra.empty()) {
+        if (!canSubtract) {
+          continue;
+        }
+        // Extra IDs answered by the cache cost nothing; the rest are fetched to be subtracted
+        extra.subtract(m_valueCache.cover(interestName, extra, cached));
+        if (extra.intersects(pitInfo->subtractIds)) {
+          continue; // keep every fetched ID subtracted exactly once
+        }
+        gain -= static_cast<int64_t>(extra.size());
+      }
+      if (gain > bestGain) {
+        best = i;
+        bestGain = gain;
+        bestFetch = extra;
+        bestCached = cached;
+      }
     }
-
-    // Use utility function to check sequence number components
-    bool sequencesMatch = ns3::ndn::AggregateUtils::doSequenceComponentsMatch(existingName, interestName);
-    if (!sequencesMatch) {
-      continue;
+    if (best == candidates.size()) {
+      break;
     }
 
-    // Get IDs from the existing interest
-    std::set<int> existingIds = ns3::ndn::AggregateUtils::parseNumbersFromName(existingName);
-
-    // Check subset/superset relationship
-    bool existingIsSuperset = std::includes(existingIds.begin(), existingIds.end(),
-                                            requestedIds.begin(), requestedIds.end());
-    bool existingIsSubset = std::includes(requestedIds.begin(), requestedIds.end(),
-                                          existingIds.begin(), existingIds.end());
-    if (existingIsSuperset) {
-      // Piggyback on existing (superset) interest
-      std::cout << "  [Piggyback] Interest " << interestName.toUri() 
-                << " piggybacks on superset Interest " << existingName.toUri() << std::endl << std::flush;
-      AggregatePitInfo* supersetInfo = entryRef.getStrategyInfo<AggregatePitInfo>();
-      if (supersetInfo) {
-        supersetInfo->dependentInterests.push_back(pitEntry);
-      }
-      return;  // do not forward the piggybacking interest
+    const Name& coverName = candidates[best].entry->getName();
+    IdSet coveredIds = candidates[best].ids;
+    coveredIds.intersectWith(pitInfo->pendingIds);
+    if (!pitInfo->waitInfo) {
+      pitInfo->waitInfo = std::make_shared<WaitInfo>();
     }
-    else if (existingIsSubset) {
-      std::cout << "  [Subset] Interest " << existingName.toUri() 
-                << " is a subset of new Interest " << interestName.toUri() << std::endl << std::flush;
-      // Create WaitInfo if needed
-      if (!pitInfo->waitInfo) {
-        pitInfo->waitInfo = std::make_shared<WaitInfo>();
-      }
-      // Track IDs that will be provided by the existing interest
-      for (int overlapId : existingIds) {
-        if (pitInfo->pendingIds.erase(overlapId)) {
-          pitInfo->waitInfo->waitingFor[overlapId] = entryRef.getName();
-          std::cout << "  [Tracking] ID " << overlapId << " will come from " 
-                    << entryRef.getName().toUri() << std::endl << std::flush;
-        }
-      }
-      // Link this interest to wait for the subset Data
-      Name subsetDataName = entryRef.getName();
-      m_waitingInterests[subsetDataName].push_back(pitEntry);
+    for (int id : coveredIds) {
+      pitInfo->waitInfo->waitingFor[id] = coverName;
     }
+    pitInfo->pendingIds.subtract(coveredIds);
+    pitInfo->subtrahend.merge(bestCached);
+    pitInfo->subtractIds.unionWith(bestFetch);
+    m_waitingInterests[coverName].push_back(pitEntry);
+
+    NS_LOG_DEBUG("  [Cover] " << coveredIds.size() << " IDs of " << interestName.toUri()
+                 << " come from in-flight " << coverName.toUri()
+                 << (bestFetch.empty() ? "" : ", minus fetched IDs ") << bestFetch);
+    emitEvent(ns3::ndn::AggregateEventType::PIGGYBACK, interestName, 0, coveredIds.size());
+    candidates.erase(candidates.begin() + best);
   }
 }
 
+bool
+AggregateStrategy::isAggregateComplete(const AggregatePitInfo* pitInfo)
+{
+  return pitInfo->pendingIds.empty() && pitInfo->subtractIds.empty() &&
+         (!pitInfo->waitInfo || pitInfo->waitInfo->waitingFor.empty());
+}
+
 void 
 AggregateStrategy::splitAndForwardInterests(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                            const std::shared_ptr<pit::Entry>& pitEntry,
                                            AggregatePitInfo* pitInfo)
 {
+  // Difference cover: fetch the extra IDs of in-flight supersets on their own, so their
+  // Data can be told apart from the IDs this Interest adds
+  if (!pitInfo->subtractIds.empty()) {
+    std::map<Face*, std::vector<int>> subtractFaces;
+    groupIdsByFace(pitInfo->subtractIds, ingress.face, subtractFaces);
+    for (const auto& pair : subtractFaces) {
+      sendSubInterest(interest.getName(), IdSet(pair.second.begin(), pair.second.end()), *pair.first,
+                      getSubInterestLifetime(interest), pitEntry, ingress.face, 0);
+    }
+  }
+
   // Skip if no pending IDs
   if (pitInfo->pendingIds.empty()) {
-    std::cout << "  (No new sub-interests forwarded for " << interest.getName().toUri() << ")" << std::endl << std::flush;
+    NS_LOG_DEBUG("  (No new sub-interests forwarded for " << interest.getName().toUri() << ")");
     return;
   }
 
-  // Group pending IDs by next-hop face (using FIB)
+  // Group pending IDs by next-hop face (cached FIB plan)
   std::map<Face*, std::vector<int>> faceToIdsMap;
-  Fib& fib = m_forwarder.getFib();
-  for (int id : pitInfo->pendingIds) {
-    Name idName("/aggregate");
-    idName.appendNumber(id);
-    std::cout << "DEBUG: Looking up FIB entry for ID " << id << ", Name: " << idName << std::endl << std::flush;
-    const fib::Entry& fibEntry = fib.findLongestPrefixMatch(idName);
-    if (fibEntry.getPrefix().empty() || fibEntry.getNextHops().empty()) {
-      std::cout << "DEBUG: No route found for ID " << id << ", skipping..." << std::endl << std::flush;
-      continue;
-    }
-    const fib::NextHop& nh = *fibEntry.getNextHops().begin();
-    Face& outFace = nh.getFace();
-    std::cout << "DEBUG: Selected Face " << outFace.getId() << " for ID " << id << std::endl << std::flush;
-    faceToIdsMap[&outFace].push_back(id);
-  }
+  groupIdsByFace(pitInfo->pendingIds, ingress.face, faceToIdsMap);
 
   // Optimization: if all IDs go to one face, handle specially
   if (faceToIdsMap.size() == 1 && faceToIdsMap.begin()->second.size() == pitInfo->pendingIds.size()) {
@@ -897,85 +921,325 @@ AggregateStrategy::splitAndForwardInterests(const ndn::Interest& interest, const
   }
 
   // Debug output for face-to-IDs mapping
-  std::cout << "DEBUG: Face-to-IDs mapping results:" << std::endl << std::flush;
-  for (const auto& pair : faceToIdsMap) {
-    std::cout << "  - Face ID " << pair.first->getId() << " will handle IDs: [ ";
-    for (int id : pair.second) {
-      std::cout << id << " ";
+  if (NDN_AGGREGATE_LOG_ENABLED(ns3::LOG_DEBUG)) {
+    NS_LOG_DEBUG("DEBUG: Face-to-IDs mapping results:");
+    for (const auto& pair : faceToIdsMap) {
+      std::ostringstream ids;
+      for (int id : pair.second) {
+        ids << id << " ";
+      }
+      NS_LOG_DEBUG("  - Face ID " << pair.first->getId() << " will handle IDs: [ " << ids.str() << "]");
     }
-    std::cout << "]" << std::endl << std::flush;
   }
 
   // Create and forward sub-interests for each face
   for (const auto& pair : faceToIdsMap) {
-    Face* outFace = pair.first;
-    const std::vector<int>& faceIds = pair.second;
-    if (faceIds.empty()) continue;
-
-    // Build a sub-interest Name containing only this face's IDs
-    Name subInterestName;
-    subInterestName.append("aggregate");
-    for (int id : faceIds) {
-      subInterestName.appendNumber(id);
+    if (pair.second.empty()) continue;
+    sendSubInterest(interest.getName(), IdSet(pair.second.begin(), pair.second.end()), *pair.first,
+                    getSubInterestLifetime(interest), pitEntry, ingress.face, 0);
+  }
+}
+
+void
+AggregateStrategy::sendSubInterest(const Name& parentName, const IdSet& subIds, Face& outFace,
+                                   time::milliseconds lifetime,
+                                   const std::shared_ptr<pit::Entry>& parentEntry,
+                                   Face& inFace, int nRetx)
+{
+  // Build a sub-interest Name containing only this face's IDs
+  Name subInterestName;
+  subInterestName.append("aggregate");
+  ns3::ndn::AggregateUtils::appendIdSet(subInterestName, subIds);
+  appendRoundComponents(subInterestName, parentName);
+  NS_LOG_DEBUG("  >> Creating sub-interest for " << subIds.size() 
+               << " IDs: " << subInterestName << " (face " << outFace.getId() << ")");
+
+  // Create a new Interest and insert into PIT
+  auto subInterest = ns3::ndn::AggregateUtils::createSplitInterest(subInterestName, lifetime);
+  auto newPitEntry = m_forwarder.getPit().insert(*subInterest).first;
+  // Link this sub-interest with its parent
+  AggregateSubInfo* subInfo = newPitEntry->insertStrategyInfo<AggregateSubInfo>().first;
+  if (subInfo) {
+    subInfo->parentEntry = parentEntry;
+    subInfo->retx.nRetx = nRetx;
+  }
+  // Record the mapping to parent
+  m_parentMap[subInterestName] = parentEntry;
+  m_pitIndex.insert(newPitEntry, subIds);
+  // Forward the interest
+  this->sendInterest(*subInterest, outFace, newPitEntry);
+  emitEvent(ns3::ndn::AggregateEventType::SUB_INTEREST_SENT, subInterestName,
+            outFace.getId(), subIds.size());
+  // Copy ingress in-record to sub-interest's PIT entry
+  newPitEntry->insertOrUpdateInRecord(inFace, *subInterest);
+  NS_LOG_DEBUG("  [Sub-Interest] Forwarded Interest " << subInterestName.toUri() 
+               << " via face " << outFace.getId());
+  if (subInfo) {
+    armRetxTimer(newPitEntry, subInfo->retx, outFace, lifetime);
+  }
+}
+
+void
+AggregateStrategy::groupIdsByFace(const IdSet& ids, const Face& ingress,
+                                  std::map<Face*, std::vector<int>>& faceToIdsMap)
+{
+  if (m_rule) {
+    groupIdsByRule(ids, ingress, faceToIdsMap);
+    return;
+  }
+  if (m_isMultipath) {
+    groupIdsByBalancedFace(ids, ingress, faceToIdsMap);
+    return;
+  }
+
+  for (int id : ids) {
+    Face* outFace = m_nextHops.lookup(id);
+    if (outFace == nullptr) {
+      NS_LOG_DEBUG("DEBUG: No route found for ID " << id << ", skipping...");
+      continue;
+    }
+    faceToIdsMap[outFace].push_back(id);
+  }
+}
+
+void
+AggregateStrategy::setAggregationRule(AggregationRule rule)
+{
+  NS_LOG_DEBUG("Aggregation rule: subtree " << rule.subtreeIds << ", " << rule.children.size()
+               << " child faces, parent face " << rule.defaultUpward);
+  m_rule = std::move(rule);
+}
+
+void
+AggregateStrategy::groupIdsByRule(const IdSet& ids, const Face& ingress,
+                                  std::map<Face*, std::vector<int>>& faceToIdsMap)
+{
+  IdSet rest = ids;
+  for (const auto& child : m_rule->children) {
+    IdSet childIds = child.second;
+    childIds.intersectWith(rest);
+    Face* face = childIds.empty() ? nullptr : this->getFace(child.first);
+    if (face == nullptr || face == &ingress) {
+      continue;
     }
-    // Preserve sequence number component
-    Name::Component seqComponent = ns3::ndn::AggregateUtils::extractSequenceComponent(interest.getName());
-    if (!seqComponent.empty()) {
-      subInterestName.append(seqComponent);
+    std::vector<int>& faceIds = faceToIdsMap[face];
+    for (int id : childIds) {
+      faceIds.push_back(id);
     }
-    std::cout << "  >> Creating sub-interest for " << faceIds.size() 
-              << " IDs: " << subInterestName << " (face " << outFace->getId() << ")" << std::endl;
+    rest.subtract(childIds);
+  }
 
-    // Create a new Interest and insert into PIT
-    auto subInterest = ns3::ndn::AggregateUtils::createSplitInterest(subInterestName, interest.getInterestLifetime());
-    auto newPitEntry = m_forwarder.getPit().insert(*subInterest).first;
-    // Link this sub-interest with its parent
-    AggregateSubInfo* subInfo = newPitEntry->insertStrategyInfo<AggregateSubInfo>().first;
-    if (subInfo) {
-      subInfo->parentEntry = pitEntry;
+  // IDs of other subtrees are aggregated further up the tree
+  IdSet upwardIds = rest;
+  upwardIds.subtract(m_rule->subtreeIds);
+  Face* upstream = upwardIds.empty() ? nullptr : getRuleUpstream(ingress);
+  if (upstream != nullptr) {
+    std::vector<int>& faceIds = faceToIdsMap[upstream];
+    for (int id : upwardIds) {
+      faceIds.push_back(id);
+    }
+    rest.subtract(upwardIds);
+  }
+
+  // Whatever the plan does not place (e.g. its face is down) follows the FIB
+  for (int id : rest) {
+    Face* outFace = m_nextHops.lookup(id);
+    if (outFace == nullptr) {
+      NS_LOG_DEBUG("DEBUG: No route found for ID " << id << ", skipping...");
+      continue;
     }
-    // Record the mapping to parent
-    m_parentMap[subInterestName] = pitEntry;
-    // Forward the interest
-    this->sendInterest(*subInterest, *outFace, newPitEntry);
-    // Copy ingress in-record to sub-interest's PIT entry
-    newPitEntry->insertOrUpdateInRecord(ingress.face, *subInterest);
-    std::cout << "  [Sub-Interest] Forwarded Interest " << subInterestName.toUri() 
-              << " via face " << outFace->getId() << std::endl << std::flush;
+    faceToIdsMap[outFace].push_back(id);
   }
 }
 
-// Helper functions for beforeSatisfyInterest
+Face*
+AggregateStrategy::getRuleUpstream(const Face& ingress) const
+{
+  auto it = m_rule->upward.find(ingress.getId());
+  FaceId faceId = it == m_rule->upward.end() ? m_rule->defaultUpward : it->second;
+  Face* face = faceId == face::INVALID_FACEID ? nullptr : this->getFace(faceId);
+  return face == &ingress ? nullptr : face;
+}
+
 void
-AggregateStrategy::cleanupSatisfiedPitEntries()
+AggregateStrategy::groupIdsByBalancedFace(const IdSet& ids, const Face& ingress,
+                                          std::map<Face*, std::vector<int>>& faceToIdsMap)
 {
-  std::cout << "  [PIT-Cleanup] Logging PIT entries status:" << std::endl;
-  
-  // Count entries and report statistics
-  int totalEntries = 0;
-  int satisfiedEntries = 0;
-  int entriesWithNoRecords = 0;
-  
-  for (auto it = m_forwarder.getPit().begin(); it != m_forwarder.getPit().end(); ++it) {
-    totalEntries++;
-    const pit::Entry& entry = *it;
-    
-    if (entry.isSatisfied) {
-      satisfiedEntries++;
-    }
-    
-    if (entry.getInRecords().empty() && entry.getOutRecords().empty()) {
-      entriesWithNoRecords++;
+  // IDs routed by the same FIB entry share its equal-cost next hops
+  std::map<const fib::Entry*, std::vector<int>> entryToIdsMap;
+  for (int id : ids) {
+    const fib::Entry* entry = m_nextHops.lookupEntry(id);
+    if (entry == nullptr) {
+      NS_LOG_DEBUG("DEBUG: No route found for ID " << id << ", skipping...");
+      continue;
     }
+    entryToIdsMap[entry].push_back(id);
   }
-  
-  std::cout << "  [PIT-State] Total entries: " << totalEntries 
-            << ", Satisfied: " << satisfiedEntries
-            << ", No records: " << entriesWithNoRecords << std::endl;
+
+  for (const auto& pair : entryToIdsMap) {
+    m_balancer.assign(pair.second,
+                      AggregateMultipathBalancer::getEqualCostFaces(*pair.first, ingress),
+                      faceToIdsMap);
+  }
+}
+
+void
+AggregateStrategy::recordRttSample(const FaceEndpoint& ingress,
+                                   const std::shared_ptr<pit::Entry>& pitEntry)
+{
+  if (!m_isMultipath && m_maxRetx == 0) {
+    return;
+  }
+  auto outRecord = pitEntry->getOutRecord(ingress.face);
+  if (outRecord == pitEntry->out_end()) {
+    return;
+  }
+
+  // Karn's rule: the out-record was renewed by the retransmission, so an answer to a
+  // retransmitted Interest is not a valid sample for either the balancer or the RTO
+  const RetxState* retx = nullptr;
+  if (auto subInfo = pitEntry->getStrategyInfo<AggregateSubInfo>()) {
+    retx = &subInfo->retx;
+  }
+  else if (auto pitInfo = pitEntry->getStrategyInfo<AggregatePitInfo>()) {
+    retx = &pitInfo->retx;
+  }
+  if (retx != nullptr && retx->nRetx > 0) {
+    return;
+  }
+
+  time::nanoseconds rtt = time::steady_clock::now() - outRecord->getLastRenewed();
+  if (m_isMultipath) {
+    m_balancer.addRttSample(ingress.face, rtt);
+  }
+  if (m_maxRetx > 0) {
+    auto estimator = getRttEstimator(ingress.face.getId());
+    estimator->Measurement(ns3::NanoSeconds(rtt.count()));
+    estimator->ResetMultiplier();
+  }
+}
+
+void
+AggregateStrategy::armRetxTimer(const std::shared_ptr<pit::Entry>& sentEntry, RetxState& retx,
+                                const Face& outFace, time::milliseconds lifetime)
+{
+  if (m_maxRetx == 0 || retx.nRetx >= m_maxRetx) {
+    return;
+  }
+  if (retx.expiry == time::steady_clock::TimePoint()) {
+    retx.expiry = time::steady_clock::now() + lifetime;
+  }
+
+  auto rto = time::nanoseconds(getRttEstimator(outFace.getId())->RetransmitTimeout().GetNanoSeconds());
+  if (time::steady_clock::now() + rto >= retx.expiry) {
+    return; // the Interest expires before a retransmission could help
+  }
+  std::weak_ptr<pit::Entry> weakSentEntry = sentEntry;
+  FaceId outFaceId = outFace.getId();
+  retx.timer = getScheduler().schedule(rto, [this, weakSentEntry, outFaceId] {
+    onRetxTimeout(weakSentEntry, outFaceId);
+  });
+}
+
+void
+AggregateStrategy::onRetxTimeout(const std::weak_ptr<pit::Entry>& weakSentEntry, FaceId outFaceId)
+{
+  auto sentEntry = weakSentEntry.lock();
+  if (!sentEntry || sentEntry->isSatisfied) {
+    return;
+  }
+
+  // The sent Interest is either a sub-Interest or a parent forwarded as is
+  std::shared_ptr<pit::Entry> parentEntry = sentEntry;
+  RetxState* retx = nullptr;
+  if (auto subInfo = sentEntry->getStrategyInfo<AggregateSubInfo>()) {
+    parentEntry = subInfo->parentEntry;
+    retx = &subInfo->retx;
+  }
+  AggregatePitInfo* parentInfo = parentEntry ? parentEntry->getStrategyInfo<AggregatePitInfo>() : nullptr;
+  if (!parentInfo || parentEntry->isSatisfied || parentEntry->getInRecords().empty()) {
+    return;
+  }
+  if (retx == nullptr) {
+    retx = &parentInfo->retx;
+  }
+
+  IdSet sentIds = ns3::ndn::AggregateUtils::parseNumbersFromName(sentEntry->getName());
+  IdSet remainingIds = parentInfo->pendingIds;
+  remainingIds.unionWith(parentInfo->subtractIds);
+  remainingIds.intersectWith(sentIds);
+  auto lifetime = time::duration_cast<time::milliseconds>(retx->expiry - time::steady_clock::now());
+  if (remainingIds.empty() || lifetime <= 0_ms) {
+    return;
+  }
+
+  // Back off, as for a TCP timeout, until the next valid sample
+  getRttEstimator(outFaceId)->IncreaseMultiplier();
+  int nRetx = retx->nRetx + 1;
+  NS_LOG_DEBUG("  [Retx] " << sentEntry->getName() << " unanswered, retry " << nRetx
+               << " for " << remainingIds.size() << " pending IDs");
+
+  Face* outFace = this->getFace(outFaceId);
+  if (remainingIds == sentIds && outFace != nullptr) {
+    // Nothing of it arrived: resend the same name with a fresh nonce
+    ndn::Interest retxInterest(sentEntry->getInterest());
+    retxInterest.refreshNonce();
+    retxInterest.setInterestLifetime(lifetime);
+    retx->nRetx = nRetx;
+    this->sendInterest(retxInterest, *outFace, sentEntry);
+    emitEvent(ns3::ndn::AggregateEventType::SUB_INTEREST_SENT, sentEntry->getName(), outFaceId,
+              remainingIds.size());
+    armRetxTimer(sentEntry, *retx, *outFace, lifetime);
+    return;
+  }
+
+  // Ask only for the IDs still pending, on the current route
+  Face& inFace = parentEntry->getInRecords().front().getFace();
+  std::map<Face*, std::vector<int>> faceToIdsMap;
+  groupIdsByFace(remainingIds, inFace, faceToIdsMap);
+  for (const auto& pair : faceToIdsMap) {
+    sendSubInterest(parentEntry->getName(), IdSet(pair.second.begin(), pair.second.end()),
+                    *pair.first, lifetime, parentEntry, inFace, nRetx);
+  }
+}
+
+ns3::Ptr<ns3::ndn::RttEstimator>
+AggregateStrategy::getRttEstimator(FaceId faceId)
+{
+  auto it = m_rttEstimators.find(faceId);
+  if (it == m_rttEstimators.end()) {
+    it = m_rttEstimators.emplace(faceId, ns3::CreateObject<ns3::ndn::RttMeanDeviation>()).first;
+  }
+  return it->second;
+}
+
+void
+AggregateStrategy::appendRoundComponents(Name& subInterestName, const Name& originalName)
+{
+  // Preserve the operator so upstream aggregators combine with the same operator
+  Name::Component opComponent = ns3::ndn::AggregateUtils::extractOperatorComponent(originalName);
+  if (!opComponent.empty()) {
+    subInterestName.append(opComponent);
+  }
+  // Preserve sequence number component
+  Name::Component seqComponent = ns3::ndn::AggregateUtils::extractSequenceComponent(originalName);
+  if (!seqComponent.empty()) {
+    subInterestName.append(seqComponent);
+  }
+}
+
+// Helper functions for beforeSatisfyInterest
+void
+AggregateStrategy::cleanupSatisfiedPitEntries()
+{
+  // Report table-level counters only; a per-entry walk here would make every
+  // satisfied aggregate cost O(|PIT|)
+  NS_LOG_DEBUG("  [PIT-State] Total entries: " << m_forwarder.getPit().size()
+               << ", Indexed aggregate entries: " << m_pitIndex.size());
             
   // We can't force immediate cleanup, but we can log which entries
   // have been properly marked for cleanup by our code
-  std::cout << "  [PIT-Cleanup] PIT entries will be cleaned up by NFD's normal housekeeping process" << std::endl;
+  NS_LOG_DEBUG("  [PIT-Cleanup] PIT entries will be cleaned up by NFD's normal housekeeping process");
 }
 
 // Helper functions for processing sub-interest Data
@@ -987,50 +1251,64 @@ AggregateStrategy::findParentPitEntry(const Name& dataName)
     return {nullptr, nullptr};  // Not a sub-interest response
   }
 
-  std::cout << "  [SubInterest] Found matching parent for Data " << dataName.toUri() << std::endl << std::flush;
+  NS_LOG_DEBUG("  [SubInterest] Found matching parent for Data " << dataName.toUri());
   // Retrieve the parent PIT entry that initiated this sub-interest
   std::shared_ptr<pit::Entry> parentPit = parentIt->second.lock();
   if (!parentPit) {
-    std::cout << "  [SubInterest] Parent PIT entry already expired" << std::endl << std::flush;
+    NS_LOG_DEBUG("  [SubInterest] Parent PIT entry already expired");
     m_parentMap.erase(dataName);
     return {nullptr, nullptr};
   }
   AggregatePitInfo* parentInfo = parentPit->getStrategyInfo<AggregatePitInfo>();
   if (!parentInfo) {
-    std::cout << "  [SubInterest] No strategy info found for parent PIT entry" << std::endl << std::flush;
+    NS_LOG_DEBUG("  [SubInterest] No strategy info found for parent PIT entry");
     m_parentMap.erase(dataName);
     return {nullptr, nullptr};
   }
-  std::cout << "  [SubInterest] Processing Data for parent Interest " << parentPit->getName().toUri() << std::endl << std::flush;
+  NS_LOG_DEBUG("  [SubInterest] Processing Data for parent Interest " << parentPit->getName().toUri());
   return {parentPit, parentInfo};
 }
 
-uint64_t 
+void 
 AggregateStrategy::updateParentWithSubInterestData(const ndn::Data& data, const Name& dataName, 
                                                   AggregatePitInfo* parentInfo)
 {
-  // Parse content to extract the numeric value
-  uint64_t value = ns3::ndn::AggregateUtils::extractValueFromContent(data);
+  // Decode the content as a partial of the parent's operator
+  IdSet contributionMissing;
+  ns3::ndn::AggregateState contribution =
+    ns3::ndn::AggregateUtils::extractStateFromContent(data, parentInfo->partial.getSpec(),
+                                                      contributionMissing);
   // Determine which IDs this Data covers
-  std::set<int> dataIds = ns3::ndn::AggregateUtils::parseNumbersFromName(dataName);
-  // Update parent's partial sum and mark these IDs as fulfilled
-  parentInfo->partialSum += value;
-  for (int fulfilledId : dataIds) {
-    parentInfo->pendingIds.erase(fulfilledId);
-    // If this Data is atomic (single ID), cache its value
-    if (dataIds.size() == 1) {
-      m_cachedValues[fulfilledId] = value;
-      std::cout << "  [Cache] Stored value " << value << " for single ID " << fulfilledId << std::endl << std::flush;
-    }
+  IdSet dataIds = ns3::ndn::AggregateUtils::parseNumbersFromName(dataName);
+  // Update parent's partial state and mark these IDs as fulfilled
+  if (!dataIds.empty() && dataIds.isSubsetOf(parentInfo->subtractIds)) {
+    // Fetched only to be taken out of an in-flight superset's result (see planCover)
+    parentInfo->subtrahend.merge(contribution);
+    parentInfo->subtractIds.subtract(dataIds);
+  }
+  else {
+    parentInfo->partial.merge(contribution);
+    parentInfo->pendingIds.subtract(dataIds);
   }
-  std::cout << "    [Aggregation] Data " << dataName.toUri() << " contributes value " 
-            << value << " to parent Interest (partialSum=" << parentInfo->partialSum << ")" << std::endl;
-  std::cout << "    Remaining IDs for parent: { ";
-  for (int pid : parentInfo->pendingIds) {
-    std::cout << pid << " ";
+  parentInfo->missingIds.unionWith(contributionMissing);
+  // If this Data is atomic (single ID) and carries a raw scalar sample, cache its value;
+  // otherwise cache the contribution as a partial, unless it is a deadline reply with gaps
+  if (dataIds.size() == 1 && !parentInfo->partial.getSpec().isVector() &&
+      ns3::ndn::AggregateState::isScalarContent(data.getContent().value_size())) {
+    int fulfilledId = dataIds.min();
+    uint64_t value = ns3::ndn::AggregateUtils::extractValueFromContent(data);
+    m_valueCache.insertSample(dataName, fulfilledId, value);
+    NS_LOG_DEBUG("  [Cache] Stored value " << value << " for single ID " << fulfilledId);
   }
-  std::cout << "}" << std::endl << std::flush;
-  return value;
+  else if (contributionMissing.empty()) {
+    m_valueCache.insertPartial(dataName, dataIds, contribution);
+  }
+  NS_LOG_DEBUG("    [Aggregation] Data " << dataName.toUri() << " contributes " 
+               << contribution.toString() << " to parent Interest (partial "
+               << parentInfo->partial.toString() << ")");
+  NS_LOG_DEBUG("    Remaining IDs for parent: " << parentInfo->pendingIds
+               << ", missing upstream: " << parentInfo->missingIds);
+  emitEvent(ns3::ndn::AggregateEventType::DATA_AGGREGATED, dataName, 0, dataIds.size());
 }
 
 std::vector<Face*>
@@ -1041,24 +1319,24 @@ AggregateStrategy::extractFacesFromPitEntry(const std::shared_ptr<pit::Entry>& p
     outFaces.push_back(&inRecord.getFace());
   }
   if (outFaces.empty()) {
-    std::cout << "  [WARNING] PIT entry has no InRecords - cannot send data" << std::endl;
+    NS_LOG_DEBUG("  [WARNING] PIT entry has no InRecords - cannot send data");
   }
   return outFaces;
 }
 
 void 
 AggregateStrategy::sendDataDirectly(const std::shared_ptr<ndn::Data>& data, Face* outFace, 
-                                    const Name& dataName, uint64_t value)
+                                    const Name& dataName, const ns3::ndn::AggregateState& state)
 {
   try {
     outFace->sendData(*data);
-    std::cout << "<< Sent aggregate Data " << dataName.toUri() 
-              << " with sum = " << value 
-              << " to face " << outFace->getId() 
-              << " (direct send, bypassing PIT)" << std::endl << std::flush;
+    NS_LOG_DEBUG("<< Sent aggregate Data " << dataName.toUri() 
+                 << " with " << state.toString()
+                 << " to face " << outFace->getId() 
+                 << " (direct send, bypassing PIT)");
   }
   catch (const std::exception& e) {
-    std::cout << "  [ERROR] Failed to send data: " << e.what() << std::endl;
+    NS_LOG_DEBUG("  [ERROR] Failed to send data: " << e.what());
   }
 }
 
@@ -1066,23 +1344,35 @@ void
 AggregateStrategy::sendAggregatedDataToParentFaces(std::shared_ptr<pit::Entry> parentPit,
                                                   AggregatePitInfo* parentInfo)
 {
-  std::cout << "  [SubInterest] All components received, creating final aggregated Data" << std::endl << std::flush;
-  uint64_t totalSum = parentInfo->partialSum;
+  NS_LOG_DEBUG("  [SubInterest] All components received, creating final aggregated Data");
   Name parentName = parentPit->getName();
-  // Create the aggregated Data packet
-  auto aggData = ns3::ndn::AggregateUtils::createDataWithValue(parentName, totalSum);
+  if (parentInfo->subtrahend.getCount() > 0 && !parentInfo->partial.subtract(parentInfo->subtrahend)) {
+    NS_LOG_DEBUG("  [ERROR] Cannot subtract " << parentInfo->subtrahend.toString()
+                 << " from " << parentInfo->partial.toString());
+    parentInfo->missingIds = parentInfo->neededIds;
+  }
+  parentInfo->subtrahend = ns3::ndn::AggregateState(parentInfo->partial.getSpec());
+  if (parentInfo->missingIds.empty()) {
+    m_valueCache.insertPartial(parentName, parentInfo->neededIds, parentInfo->partial);
+  }
+  // Create the aggregated Data packet, with a descriptor of the IDs it lacks (if any)
+  auto aggData = ns3::ndn::AggregateUtils::createPartialData(parentName, parentInfo->partial,
+                                                            parentInfo->missingIds);
   try {
     std::vector<Face*> outFaces = extractFacesFromPitEntry(parentPit);
     for (Face* outFace : outFaces) {
-      sendDataDirectly(aggData, outFace, parentName, totalSum);
+      sendDataDirectly(aggData, outFace, parentName, parentInfo->partial);
+      emitEvent(ns3::ndn::AggregateEventType::AGGREGATE_SENT, parentName,
+                outFace->getId(), parentInfo->neededIds.size());
     }
   }
   catch (const std::exception& e) {
-    std::cout << "  [ERROR] Failed to process parent PIT: " << e.what() << std::endl;
+    NS_LOG_DEBUG("  [ERROR] Failed to process parent PIT: " << e.what());
   }
 
   // Mark the parent PIT entry as satisfied for cleanup
   parentPit->isSatisfied = true;
+  m_pitIndex.erase(*parentPit);
   
   // Clear all in-records
   while (!parentPit->getInRecords().empty()) {
@@ -1101,57 +1391,74 @@ AggregateStrategy::sendAggregatedDataToParentFaces(std::shared_ptr<pit::Entry> p
     parentPit->expiryTimer.cancel();
   }
   
-  std::cout << "  [Cleanup] Cleared all records and marked parent PIT entry for " 
-            << parentPit->getName() << " as satisfied for removal" << std::endl;
+  NS_LOG_DEBUG("  [Cleanup] Cleared all records and marked parent PIT entry for " 
+               << parentPit->getName() << " as satisfied for removal");
 
   // Request immediate cleanup
   cleanupSatisfiedPitEntries();
+
+  // Interests whose cover plan waits on this locally built aggregate
+  processWaitingInterestData(*aggData, parentName);
 }
 
-void 
-AggregateStrategy::satisfyPiggybackedInterests(AggregatePitInfo* parentInfo)
+time::milliseconds
+AggregateStrategy::getSubInterestLifetime(const ndn::Interest& interest) const
+{
+  if (m_deadline == 0_ms) {
+    return interest.getInterestLifetime();
+  }
+  time::milliseconds budget = std::min(m_deadline, interest.getInterestLifetime());
+  return std::max(1_ms, budget - m_deadlineMargin);
+}
+
+void
+AggregateStrategy::scheduleDeadline(const ndn::Interest& interest,
+                                    const std::shared_ptr<pit::Entry>& pitEntry,
+                                    AggregatePitInfo* pitInfo)
 {
-  if (parentInfo->dependentInterests.empty()) {
+  if (m_deadline == 0_ms || pitEntry->isSatisfied || isAggregateComplete(pitInfo)) {
     return;
   }
-  std::cout << "  [SubInterest] Satisfying " << parentInfo->dependentInterests.size() 
-            << " piggybacked child interests" << std::endl << std::flush;
-  for (auto& weakChildPit : parentInfo->dependentInterests) {
-    auto childPit = weakChildPit.lock();
-    if (!childPit) continue;
-    // Compute subset sum for the child (if parent had extra IDs beyond child's)
-    AggregatePitInfo* childInfo = childPit->getStrategyInfo<AggregatePitInfo>();
-    if (!childInfo) continue;
-    uint64_t childSum = 0;
-    for (int cid : childInfo->neededIds) {
-      if (m_cachedValues.find(cid) != m_cachedValues.end()) {
-        childSum += m_cachedValues[cid];
-      }
-    }
-    // Extract child faces before invalidating PIT
-    std::vector<Face*> childFaces = extractFacesFromPitEntry(childPit);
-    if (childFaces.empty()) continue;
-    // Create Data with child's sum
-    Name childName = childPit->getName();
-    auto childData = ns3::ndn::AggregateUtils::createDataWithValue(childName, childSum);
-    // Send to each face via a safe temporary PIT entry
-    for (Face* outFace : childFaces) {
-      try {
-        ndn::Interest tempInterest(childName);
-        auto tempPitEntry = m_forwarder.getPit().insert(tempInterest).first;
-        tempPitEntry->insertOrUpdateInRecord(*outFace, tempInterest);
-        this->sendData(*childData, *outFace, tempPitEntry);
-        std::cout << "<< Satisfied piggybacked Interest " << childName.toUri() 
-                  << " with sum = " << childSum 
-                  << " to face " << outFace->getId()
-                  << " (via safe temp PIT entry)" << std::endl;
-      }
-      catch (const std::exception& e) {
-        std::cout << "  [ERROR] Failed to send piggybacked data: " << e.what() << std::endl;
-      }
+
+  // The Interest's lifetime already carries the downstream budget minus one margin
+  time::milliseconds budget = std::min(m_deadline, interest.getInterestLifetime());
+  std::weak_ptr<pit::Entry> weakPitEntry = pitEntry;
+  pitInfo->deadlineTimer = getScheduler().schedule(budget, [this, weakPitEntry] {
+    onDeadline(weakPitEntry);
+  });
+}
+
+void
+AggregateStrategy::onDeadline(const std::weak_ptr<pit::Entry>& weakPitEntry)
+{
+  auto pitEntry = weakPitEntry.lock();
+  if (!pitEntry || pitEntry->isSatisfied) {
+    return;
+  }
+  AggregatePitInfo* pitInfo = pitEntry->getStrategyInfo<AggregatePitInfo>();
+  if (!pitInfo) {
+    return;
+  }
+
+  // Everything not answered by now is reported missing, along with what upstream reported
+  pitInfo->missingIds.unionWith(pitInfo->pendingIds);
+  pitInfo->pendingIds.clear();
+  if (pitInfo->waitInfo) {
+    for (const auto& pair : pitInfo->waitInfo->waitingFor) {
+      pitInfo->missingIds.insert(pair.first);
     }
+    pitInfo->waitInfo->waitingFor.clear();
+  }
+  if (pitInfo->missingIds.empty()) {
+    return;
   }
+
+  NS_LOG_DEBUG("  [Deadline] " << pitEntry->getName() << " replies without "
+               << pitInfo->missingIds.size() << " IDs: " << pitInfo->missingIds);
+  emitEvent(ns3::ndn::AggregateEventType::DEADLINE_REPLY, pitEntry->getName(), 0,
+            pitInfo->missingIds.size());
+  sendAggregatedDataToParentFaces(pitEntry, pitInfo);
 }
 
 } // namespace fw
-} // namespace nfd
\ No newline at end of file
+} // namespace nfd
@@ -7,19 +7,27 @@
 #include "ns3/ndnSIM/NFD/daemon/table/cs.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/face-endpoint.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
-#include <set>
+#include <map>
+#include <optional>
 #include <vector>
 #include <stdint.h>
 #include <iostream>
 #include <unordered_map>
 
 #include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+#include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
+#include "AggregateMultipathBalancer.hpp"
+#include "AggregateNextHopCache.hpp"
+#include "AggregatePitIndex.hpp"
+#include "AggregateValueCache.hpp"
 
 namespace nfd {
 namespace fw {
 
 class AggregateStrategy : public Strategy {
 public:
+  using IdSet = ns3::ndn::AggregateIdSet;
+
   // Register the strategy with a unique name so it can be used in StrategyChoiceHelper
   AggregateStrategy(Forwarder& forwarder, const Name& name = getStrategyName());
 
@@ -36,21 +44,38 @@ public:
   void processDataForAggregation(const Data& data, const FaceEndpoint& ingress,
                                  const std::shared_ptr<pit::Entry>& pitEntry);
 
+  // Static aggregation tree: where this node sends each ID, see ns3::ndn::AggregateTreePlanner
+  struct AggregationRule {
+    IdSet subtreeIds; // aggregated at or below this node
+    // Face toward the producers of each ID set, most specific first; an ID takes the first match
+    std::vector<std::pair<FaceId, IdSet>> children;
+    // Face toward the tree parent, by ingress face; defaultUpward for any other ingress
+    std::map<FaceId, FaceId> upward;
+    FaceId defaultUpward = face::INVALID_FACEID; // invalid at the root
+  };
+
+  // Follow rule instead of per-ID FIB routes; IDs the rule does not place still use the FIB
+  void setAggregationRule(AggregationRule rule);
+
 private:
+  // Parse "multipath~on|off", "deadline~<ms>", "deadline-margin~<ms>", "retx~<n>",
+  // "cache-size~<n>" and "cache-ttl~<ms>" strategy parameters
+  void processParams(const PartialName& params);
+
   // Store our own reference to the Forwarder
   Forwarder& m_forwarder;
   uint32_t m_nodeId;
   ns3::ndn::AggregateUtils::NodeRole m_nodeRole;
   int m_logicalId;  // 1-based ID within role group
+  std::string m_nodeRoleString;  // e.g. "R2", looked up once for logging
 
   void registerPitExpirationCallback();
 
   void processSubInterestData(const Data& data, const Name& dataName,
                               const FaceEndpoint& ingress,
                               const std::shared_ptr<pit::Entry>& pitEntry);
-  void processWaitingInterestData(const Data& data, const Name& dataName,
-                                  const FaceEndpoint& ingress,
-                                  const std::shared_ptr<pit::Entry>& pitEntry);
+  // Fold Data of an in-flight aggregate into the Interests whose cover plan waits for it
+  void processWaitingInterestData(const Data& data, const Name& dataName);
   void processDirectData(const Data& data, const Name& dataName,
                          const FaceEndpoint& ingress,
                          const std::shared_ptr<pit::Entry>& pitEntry);
@@ -61,17 +86,29 @@ private:
     std::unordered_map<int, ndn::Name> waitingFor;
   };
 
+  // Retransmission state of an Interest this node sent upstream
+  struct RetxState {
+    scheduler::ScopedEventId timer;
+    int nRetx = 0;
+    time::steady_clock::TimePoint expiry; // retransmissions must not outlive the first send
+  };
+
   // Structure to hold strategy-specific info for each PIT entry
   struct AggregatePitInfo : public StrategyInfo {
     static constexpr int getTypeId() {
       return 1000; // unique ID for this custom strategy info
     }
 
-    std::set<int> neededIds;
-    std::set<int> pendingIds;
-    uint64_t partialSum;
-    std::vector<std::weak_ptr<pit::Entry>> dependentInterests;
+    IdSet neededIds;
+    IdSet pendingIds;
+    ns3::ndn::AggregateState partial; // operator selected from the name or per-prefix default
     std::shared_ptr<WaitInfo> waitInfo;
+    // Difference cover: IDs fetched only to be taken out again, and what was taken so far
+    IdSet subtractIds;
+    ns3::ndn::AggregateState subtrahend;
+    IdSet missingIds; // reported missing by upstream deadline replies
+    scheduler::ScopedEventId deadlineTimer;
+    RetxState retx; // when the Interest itself was forwarded upstream
   };
 
   struct AggregateSubInfo : public StrategyInfo {
@@ -79,13 +116,14 @@ private:
       return 1001; // unique ID different from AggregatePitInfo
     }
     std::shared_ptr<pit::Entry> parentEntry;
+    RetxState retx;
   };
 
   // Helper to retrieve (and create if not exists) the AggregatePitInfo for a PIT entry
   AggregatePitInfo* getAggregatePitInfo(const std::shared_ptr<pit::Entry>& pitEntry);
   // Helper for Producer Interest Handling
-  bool isSelfGeneratedInterest(const std::set<int>& requestedIds);
-  bool isDirectDataRequest(const std::set<int>& requestedIds);
+  bool isSelfGeneratedInterest(const IdSet& requestedIds, const Face& ingress);
+  bool isDirectDataRequest(const IdSet& requestedIds);
 
   // Debug helper functions for afterReceiveInterest
   void logDebugInfo(const ndn::Interest& interest, const FaceEndpoint& ingress);
@@ -95,32 +133,91 @@ private:
                               const std::shared_ptr<pit::Entry>& pitEntry);
   bool processContentStoreHits(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                const std::shared_ptr<pit::Entry>& pitEntry, AggregatePitInfo* pitInfo);
-  void checkSubsetSupersetRelationships(const ndn::Interest& interest, const std::shared_ptr<pit::Entry>& pitEntry,
-                                        AggregatePitInfo* pitInfo, const std::set<int>& requestedIds);
+  // Cover pending IDs with in-flight aggregates of the same round, leaving only the rest to fetch
+  void planCover(const ndn::Interest& interest, const std::shared_ptr<pit::Entry>& pitEntry,
+                 AggregatePitInfo* pitInfo);
+  // All pending, subtracted and waited-for IDs have arrived
+  static bool isAggregateComplete(const AggregatePitInfo* pitInfo);
   void splitAndForwardInterests(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                 const std::shared_ptr<pit::Entry>& pitEntry, AggregatePitInfo* pitInfo);
   void handleSingleFaceForwarding(const ndn::Interest& interest, const FaceEndpoint& ingress,
                                   const std::shared_ptr<pit::Entry>& pitEntry,
                                   AggregatePitInfo* pitInfo,
                                   const std::map<Face*, std::vector<int>>& faceToIdsMap);
+  // Group ids by the face their sub-Interest goes out on
+  void groupIdsByFace(const IdSet& ids, const Face& ingress,
+                      std::map<Face*, std::vector<int>>& faceToIdsMap);
+  // Static tree: send ids to child faces, the rest outside the subtree toward the parent
+  void groupIdsByRule(const IdSet& ids, const Face& ingress,
+                      std::map<Face*, std::vector<int>>& faceToIdsMap);
+  // Static tree: face toward the tree parent for a request from ingress, if any
+  Face* getRuleUpstream(const Face& ingress) const;
+  // Multipath mode: split each FIB entry's share of ids over its equal-cost next hops
+  void groupIdsByBalancedFace(const IdSet& ids, const Face& ingress,
+                              std::map<Face*, std::vector<int>>& faceToIdsMap);
+  // Create, register and send one sub-Interest for subIds of parentEntry's round
+  void sendSubInterest(const Name& parentName, const IdSet& subIds, Face& outFace,
+                       time::milliseconds lifetime, const std::shared_ptr<pit::Entry>& parentEntry,
+                       Face& inFace, int nRetx);
+  // Feed the RTT of the out-record answered by ingress to m_balancer and the RTO estimator
+  void recordRttSample(const FaceEndpoint& ingress, const std::shared_ptr<pit::Entry>& pitEntry);
+  // Retransmission: arm retx to fire after the RTO of outFace, if that is within the lifetime
+  void armRetxTimer(const std::shared_ptr<pit::Entry>& sentEntry, RetxState& retx,
+                    const Face& outFace, time::milliseconds lifetime);
+  void onRetxTimeout(const std::weak_ptr<pit::Entry>& weakSentEntry, FaceId outFaceId);
+  ns3::Ptr<ns3::ndn::RttEstimator> getRttEstimator(FaceId faceId);
   void printPitDebugInfo(const Pit& pit);
+  // Report a structured event to AggregateEventSink if its type is enabled
+  void emitEvent(ns3::ndn::AggregateEventType type, const Name& name,
+                 uint64_t faceId, size_t idCount) const;
 
   // Helper functions for beforeSatisfyInterest
   void cleanupSatisfiedPitEntries();
 
   // Helper functions for processing sub-interest Data
   std::pair<std::shared_ptr<pit::Entry>, AggregatePitInfo*> findParentPitEntry(const Name& dataName);
-  uint64_t updateParentWithSubInterestData(const ndn::Data& data, const Name& dataName, AggregatePitInfo* parentInfo);
+  void updateParentWithSubInterestData(const ndn::Data& data, const Name& dataName, AggregatePitInfo* parentInfo);
   void sendAggregatedDataToParentFaces(std::shared_ptr<pit::Entry> parentPit, AggregatePitInfo* parentInfo);
-  void satisfyPiggybackedInterests(AggregatePitInfo* parentInfo);
+  // Deadline mode: lifetime of sub-Interests, one margin shorter than this hop's budget
+  time::milliseconds getSubInterestLifetime(const ndn::Interest& interest) const;
+  // Deadline mode: reply with the partial aggregate once this hop's budget runs out
+  void scheduleDeadline(const ndn::Interest& interest, const std::shared_ptr<pit::Entry>& pitEntry,
+                        AggregatePitInfo* pitInfo);
+  void onDeadline(const std::weak_ptr<pit::Entry>& weakPitEntry);
   std::vector<Face*> extractFacesFromPitEntry(const std::shared_ptr<pit::Entry>& pitEntry);
   void sendDataDirectly(const std::shared_ptr<ndn::Data>& data, Face* outFace,
-                        const Name& dataName, uint64_t value);
+                        const Name& dataName, const ns3::ndn::AggregateState& state);
+  // Append the operator and sequence components of the original name to a sub-interest name
+  void appendRoundComponents(Name& subInterestName, const Name& originalName);
 
   // ** Data structures for coordinating sub-Interests and piggybacking **
   std::map<Name, std::weak_ptr<pit::Entry>> m_parentMap;
   std::map<Name, std::vector<std::weak_ptr<pit::Entry>>> m_waitingInterests;
-  std::unordered_map<int, uint64_t> m_cachedValues;
+  // Per-round raw samples and complete partial aggregates, bounded by TTL and LRU
+  AggregateValueCache m_valueCache;
+
+  // Secondary index over live aggregate PIT entries (replaces full-PIT scans)
+  AggregatePitIndex m_pitIndex;
+
+  // FIB entry per producer ID, kept in sync with the FIB
+  AggregateNextHopCache m_nextHops;
+
+  // Static aggregation tree installed by AggregateSimulationHelper (none: FIB routes only)
+  std::optional<AggregationRule> m_rule;
+
+  // Spread sub-Interests over equal-cost next hops instead of always using the first one
+  bool m_isMultipath = false;
+  AggregateMultipathBalancer m_balancer;
+
+  // Deadline mode: reply with a partial aggregate and its missing IDs after at most
+  // m_deadline per hop; each hop gives upstream m_deadlineMargin less (0 disables)
+  time::milliseconds m_deadline = 0_ms;
+  time::milliseconds m_deadlineMargin = 2_ms;
+
+  // Retransmission: resend an unanswered Interest after the RTO of its out-face, asking
+  // only for IDs still pending, up to m_maxRetx times (0 disables)
+  int m_maxRetx = 0;
+  std::unordered_map<FaceId, ns3::Ptr<ns3::ndn::RttEstimator>> m_rttEstimators;
 };
 
 } // namespace fw
@@ -0,0 +1,220 @@
+#include "AggregateValueCache.hpp"
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+
+#include <algorithm>
+
+namespace nfd {
+namespace fw {
+
+AggregateValueCache::AggregateValueCache(size_t capacity, time::milliseconds ttl)
+  : m_capacity(capacity)
+  , m_ttl(ttl)
+{
+}
+
+void
+AggregateValueCache::setLimits(size_t capacity, time::milliseconds ttl)
+{
+  m_capacity = capacity;
+  m_ttl = ttl;
+  while (m_lru.size() > m_capacity) {
+    eraseEntry(std::prev(m_lru.end()));
+  }
+}
+
+void
+AggregateValueCache::insertSample(const Name& name, int id, uint64_t value)
+{
+  Entry entry;
+  entry.round = makeRoundKey(name, false);
+  entry.ids.insert(id);
+  entry.isSample = true;
+  entry.sample = value;
+  insertEntry(std::move(entry));
+}
+
+void
+AggregateValueCache::insertPartial(const Name& name, const IdSet& ids,
+                                   const ns3::ndn::AggregateState& partial)
+{
+  if (ids.empty()) {
+    return;
+  }
+  Entry entry;
+  entry.round = makeRoundKey(name, true);
+  entry.ids = ids;
+  entry.isSample = false;
+  entry.sample = 0;
+  entry.partial = partial;
+  insertEntry(std::move(entry));
+}
+
+AggregateValueCache::IdSet
+AggregateValueCache::cover(const Name& name, const IdSet& ids, ns3::ndn::AggregateState& partial)
+{
+  IdSet covered;
+  auto now = time::steady_clock::now();
+  // Expired entries are dropped after the lookup so that no bucket goes away under it
+  std::vector<EntryList::iterator> expired;
+
+  auto bucketIt = m_buckets.find(makeRoundKey(name, true));
+  if (bucketIt != m_buckets.end()) {
+    Bucket& bucket = bucketIt->second;
+    std::unordered_set<const Entry*> seen;
+    auto exactIt = bucket.partials.find(ids);
+    if (exactIt != bucket.partials.end()) {
+      if (touch(exactIt->second, now, expired)) {
+        partial.merge(exactIt->second->partial);
+        return ids;
+      }
+      seen.insert(&*exactIt->second);
+    }
+
+    // Greedy disjoint cover, largest cached partial first
+    std::vector<EntryList::iterator> candidates;
+    for (int id : ids) {
+      auto postingIt = bucket.partialsById.find(id);
+      if (postingIt == bucket.partialsById.end()) {
+        continue;
+      }
+      for (const Entry* entry : postingIt->second) {
+        if (seen.insert(entry).second && entry->ids.isSubsetOf(ids)) {
+          candidates.push_back(bucket.partials.at(entry->ids));
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(), [] (EntryList::iterator a, EntryList::iterator b) {
+      return a->ids.size() > b->ids.size();
+    });
+    for (auto it : candidates) {
+      if (!covered.intersects(it->ids) && touch(it, now, expired)) {
+        partial.merge(it->partial);
+        covered.unionWith(it->ids);
+      }
+    }
+  }
+
+  // Raw samples are scalar and operator independent
+  bucketIt = m_buckets.find(makeRoundKey(name, false));
+  if (bucketIt != m_buckets.end() && !partial.getSpec().isVector() &&
+      covered.size() < ids.size()) {
+    const auto& samples = bucketIt->second.samples;
+    IdSet sampled;
+    for (int id : ids) {
+      if (covered.contains(id)) {
+        continue;
+      }
+      auto sampleIt = samples.find(id);
+      if (sampleIt != samples.end() && touch(sampleIt->second, now, expired)) {
+        partial.addSample(sampleIt->second->sample);
+        sampled.insert(id);
+      }
+    }
+    covered.unionWith(sampled);
+  }
+
+  for (auto it : expired) {
+    eraseEntry(it);
+  }
+  return covered;
+}
+
+bool
+AggregateValueCache::touch(EntryList::iterator it, time::steady_clock::TimePoint now,
+                           std::vector<EntryList::iterator>& expired)
+{
+  if (it->expiry <= now) {
+    expired.push_back(it);
+    return false;
+  }
+  m_lru.splice(m_lru.begin(), m_lru, it);
+  return true;
+}
+
+void
+AggregateValueCache::insertEntry(Entry&& entry)
+{
+  if (m_capacity == 0) {
+    return;
+  }
+  entry.expiry = time::steady_clock::now() + m_ttl;
+
+  Bucket& bucket = m_buckets[entry.round];
+  if (entry.isSample) {
+    auto it = bucket.samples.find(entry.ids.min());
+    if (it != bucket.samples.end()) {
+      it->second->sample = entry.sample;
+      it->second->expiry = entry.expiry;
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return;
+    }
+  }
+  else {
+    auto it = bucket.partials.find(entry.ids);
+    if (it != bucket.partials.end()) {
+      it->second->partial = std::move(entry.partial);
+      it->second->expiry = entry.expiry;
+      m_lru.splice(m_lru.begin(), m_lru, it->second);
+      return;
+    }
+  }
+
+  m_lru.push_front(std::move(entry));
+  auto it = m_lru.begin();
+  if (it->isSample) {
+    bucket.samples.emplace(it->ids.min(), it);
+  }
+  else {
+    bucket.partials.emplace(it->ids, it);
+    for (int id : it->ids) {
+      bucket.partialsById[id].insert(&*it);
+    }
+  }
+
+  while (m_lru.size() > m_capacity) {
+    eraseEntry(std::prev(m_lru.end()));
+  }
+}
+
+void
+AggregateValueCache::eraseEntry(EntryList::iterator it)
+{
+  auto bucketIt = m_buckets.find(it->round);
+  if (bucketIt != m_buckets.end()) {
+    Bucket& bucket = bucketIt->second;
+    if (it->isSample) {
+      bucket.samples.erase(it->ids.min());
+    }
+    else {
+      bucket.partials.erase(it->ids);
+      for (int id : it->ids) {
+        auto postingIt = bucket.partialsById.find(id);
+        if (postingIt != bucket.partialsById.end()) {
+          postingIt->second.erase(&*it);
+          if (postingIt->second.empty()) {
+            bucket.partialsById.erase(postingIt);
+          }
+        }
+      }
+    }
+    if (bucket.samples.empty() && bucket.partials.empty()) {
+      m_buckets.erase(bucketIt);
+    }
+  }
+  m_lru.erase(it);
+}
+
+Name
+AggregateValueCache::makeRoundKey(const Name& name, bool withOperator)
+{
+  Name key;
+  key.append(ns3::ndn::AggregateUtils::extractSequenceComponent(name));
+  if (withOperator) {
+    key.append(ns3::ndn::AggregateUtils::extractOperatorComponent(name));
+  }
+  return key;
+}
+
+} // namespace fw
+} // namespace nfd
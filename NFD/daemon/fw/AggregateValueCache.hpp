@@ -0,0 +1,142 @@
+#ifndef AGGREGATE_VALUE_CACHE_HPP
+#define AGGREGATE_VALUE_CACHE_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/table/pit-entry.hpp"
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-operator.hpp"
+
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Bounded, round-aware cache of aggregation results owned by AggregateStrategy
+ *
+ * Two kinds of entries share one LRU list:
+ *  - raw samples of single producers, bucketed by round (sequence component) only,
+ *    since a raw sample is valid under every operator;
+ *  - partial aggregates over an ID set, bucketed by round and operator component.
+ *
+ * Rounds never share entries, so a value of round k cannot answer round k+1. Every
+ * entry expires after a TTL (by default the freshness period of aggregation Data)
+ * and the least recently used entry is evicted once the capacity is reached, so memory
+ * stays flat over long multi-round runs.
+ *
+ * Partials are reachable by exact ID set and through per-ID posting lists, so a new
+ * ID set can be covered by cached partials of overlapping queries (see cover()).
+ */
+class AggregateValueCache
+{
+public:
+  using IdSet = ns3::ndn::AggregateIdSet;
+
+  explicit
+  AggregateValueCache(size_t capacity = 4096, time::milliseconds ttl = 1_s);
+
+  /**
+   * @brief Change the bounds, evicting entries above the new capacity
+   */
+  void
+  setLimits(size_t capacity, time::milliseconds ttl);
+
+  /**
+   * @brief Store the raw sample of producer @p id for the round of @p name
+   */
+  void
+  insertSample(const Name& name, int id, uint64_t value);
+
+  /**
+   * @brief Store the complete partial aggregate over @p ids for the round and operator of @p name
+   */
+  void
+  insertPartial(const Name& name, const IdSet& ids, const ns3::ndn::AggregateState& partial);
+
+  /**
+   * @brief Fold cached values for a disjoint subset of @p ids into @p partial
+   *
+   * Cached partials contained in @p ids are taken greedily, largest first, as long as
+   * they do not overlap what is already covered. The rest is filled from raw samples,
+   * unless @p partial is a vector state.
+   *
+   * @param name Name whose sequence and operator components select the round
+   * @return The IDs now accounted for in @p partial
+   */
+  IdSet
+  cover(const Name& name, const IdSet& ids, ns3::ndn::AggregateState& partial);
+
+  size_t
+  getCapacity() const
+  {
+    return m_capacity;
+  }
+
+  time::milliseconds
+  getTtl() const
+  {
+    return m_ttl;
+  }
+
+  /**
+   * @return Number of cached entries (including expired ones not yet purged)
+   */
+  size_t
+  size() const
+  {
+    return m_lru.size();
+  }
+
+private:
+  struct Entry
+  {
+    Name round;
+    IdSet ids;
+    bool isSample;
+    uint64_t sample;
+    ns3::ndn::AggregateState partial;
+    time::steady_clock::TimePoint expiry;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct Bucket
+  {
+    std::unordered_map<int, EntryList::iterator> samples;
+    std::unordered_map<IdSet, EntryList::iterator> partials;
+    std::unordered_map<int, std::unordered_set<const Entry*>> partialsById;
+  };
+
+  /**
+   * @brief Move a fresh entry to the front of the LRU list, or queue an expired one in @p expired
+   * @return Whether the entry is still valid
+   */
+  bool
+  touch(EntryList::iterator it, time::steady_clock::TimePoint now,
+        std::vector<EntryList::iterator>& expired);
+
+  void
+  insertEntry(Entry&& entry);
+
+  void
+  eraseEntry(EntryList::iterator it);
+
+  /**
+   * @return Round key made of the sequence and (if @p withOperator) operator components
+   */
+  static Name
+  makeRoundKey(const Name& name, bool withOperator);
+
+private:
+  size_t m_capacity;
+  time::milliseconds m_ttl;
+  EntryList m_lru; // most recently used first
+  std::map<Name, Bucket> m_buckets;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // AGGREGATE_VALUE_CACHE_HPP
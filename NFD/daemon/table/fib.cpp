@@ -118,6 +118,7 @@ Fib::erase(const Name& prefix)
   name_tree::Entry* nte = m_nameTree.findExactMatch(prefix);
   if (nte != nullptr) {
     this->erase(nte);
+    this->afterUpdateNextHops(prefix);
   }
 }
 
@@ -129,7 +130,9 @@ Fib::erase(const Entry& entry)
     BOOST_ASSERT(&entry == s_emptyEntry.get());
     return;
   }
+  Name prefix = entry.getPrefix();
   this->erase(nte);
+  this->afterUpdateNextHops(prefix);
 }
 
 void
@@ -141,6 +144,8 @@ Fib::addOrUpdateNextHop(Entry& entry, Face& face, uint64_t cost)
 
   if (isNew)
     this->afterNewNextHop(entry.getPrefix(), *it);
+  else
+    this->afterUpdateNextHops(entry.getPrefix());
 }
 
 Fib::RemoveNextHopResult
@@ -151,14 +156,16 @@ Fib::removeNextHop(Entry& entry, const Face& face)
   if (!isRemoved) {
     return RemoveNextHopResult::NO_SUCH_NEXTHOP;
   }
-  else if (!entry.hasNextHops()) {
+
+  Name prefix = entry.getPrefix();
+  RemoveNextHopResult result = RemoveNextHopResult::NEXTHOP_REMOVED;
+  if (!entry.hasNextHops()) {
     name_tree::Entry* nte = m_nameTree.getEntry(entry);
     this->erase(nte, false);
-    return RemoveNextHopResult::FIB_ENTRY_REMOVED;
-  }
-  else {
-    return RemoveNextHopResult::NEXTHOP_REMOVED;
+    result = RemoveNextHopResult::FIB_ENTRY_REMOVED;
   }
+  this->afterUpdateNextHops(prefix);
+  return result;
 }
 
 Fib::Range
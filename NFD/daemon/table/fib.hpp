@@ -150,6 +150,10 @@ public: // signal
    */
   signal::Signal<Fib, Name, NextHop> afterNewNextHop;
 
+  /** \brief signals on Fib entry nexthop cost update or removal, and on Fib entry erasure
+   */
+  signal::Signal<Fib, Name> afterUpdateNextHops;
+
 private:
   /** \tparam K a parameter acceptable to NameTree::findLongestPrefixMatch
    */
@@ -2,11 +2,15 @@
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"        // This includes IntegerValue
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/type-id.h"        // For TypeId
 #include "ns3/ndnSIM/helper/ndn-fib-helper.hpp"
 // Add this include at the top with other includes
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
 #include <endian.h> // For htobe64
+#include <charconv>
 
 // Remove the non-existent include:
 // #include "ns3/integer-value.h"  // For IntegerValue 
@@ -29,6 +33,12 @@ ns3::ndn::ValueProducer::ValueProducer()
   m_payloadSize = 1024;
   m_freshness = Seconds(10.0);
   m_seqNo = 0; // Initialize sequence counter
+  m_roundRate = 0;
+  m_maxRounds = 0;
+  m_maxOutstanding = 1;
+  m_nRoundsIssued = 0;
+  m_isRoundDeferred = false;
+  m_isAllReduce = false;
   NS_LOG_FUNCTION(this);
 }
 
@@ -60,7 +70,29 @@ ValueProducer::GetTypeId()
                                   "LifeTime for interest packets",
                                   StringValue("2s"),
                                   MakeTimeAccessor(&ValueProducer::m_interestLifetime),
-                                  MakeTimeChecker());
+                                  MakeTimeChecker())
+                      .AddAttribute("RoundRate",
+                                  "Aggregation rounds per second when acting as consumer "
+                                  "(0 for a single round)",
+                                  DoubleValue(0.0),
+                                  MakeDoubleAccessor(&ValueProducer::m_roundRate),
+                                  MakeDoubleChecker<double>(0.0))
+                      .AddAttribute("MaxRounds",
+                                  "Number of rounds to issue (0 for unlimited)",
+                                  UintegerValue(0),
+                                  MakeUintegerAccessor(&ValueProducer::m_maxRounds),
+                                  MakeUintegerChecker<uint32_t>())
+                      .AddAttribute("MaxOutstandingRounds",
+                                  "Maximum number of rounds in flight at once",
+                                  UintegerValue(1),
+                                  MakeUintegerAccessor(&ValueProducer::m_maxOutstanding),
+                                  MakeUintegerChecker<uint32_t>(1))
+                      .AddAttribute("AllReduce",
+                                  "Prefix asks for the global aggregate including this node; "
+                                  "its own value is taken out of invertible results",
+                                  BooleanValue(false),
+                                  MakeBooleanAccessor(&ValueProducer::m_isAllReduce),
+                                  MakeBooleanChecker());
   return tid;
 }
 
@@ -72,9 +104,9 @@ void ValueProducer::StartApplication()
     m_nodeId = GetNode()->GetId() + 1; // default to NS-3 node ID if not set
   }
   
-  // Register prefix using binary format (BUG FIX)
+  // Register the production prefix /aggregate/<nodeId>
   ::ndn::Name binName("/aggregate");
-  binName.appendNumber(m_nodeId); // Binary format (will create /aggregate/<nodeId>)
+  ns3::ndn::AggregateUtils::appendId(binName, m_nodeId);
   std::string prefixUri = binName.toUri();
   
   // Add a FIB entry for the local production prefix
@@ -85,13 +117,70 @@ void ValueProducer::StartApplication()
   // ::ndn::Name seqPrefix = ::ndn::Name(binName).append("seq=");
   // this->SetInterestFilter(seqPrefix);
   
-  std::cout << "Node " << m_nodeId << " registered prefix (FIB route) for: " 
-            << binName.toUri() << std::endl;
+  NS_LOG_DEBUG("Node " << m_nodeId << " registered prefix (FIB route) for: " 
+               << binName.toUri());
   
-  // If we have a consumer prefix set, schedule sending one interest
+  // If we have a consumer prefix set, schedule the first round
   if (m_prefix.size() > 0) {
-    Simulator::Schedule(Seconds(1.0), &ValueProducer::SendOneInterest, this);
-    std::cout << "Node " << m_nodeId << " will request: " << m_prefix << std::endl;
+    m_roundEvent = Simulator::Schedule(Seconds(1.0), &ValueProducer::ScheduleNextRound, this);
+    NS_LOG_DEBUG("Node " << m_nodeId << " will request: " << m_prefix);
+  }
+}
+
+void
+ValueProducer::StopApplication()
+{
+  Simulator::Cancel(m_roundEvent);
+  for (auto& round : m_outstandingRounds) {
+    Simulator::Cancel(round.second);
+  }
+  m_outstandingRounds.clear();
+  m_isRoundDeferred = false;
+
+  App::StopApplication();
+}
+
+void
+ValueProducer::ScheduleNextRound()
+{
+  if (m_maxRounds > 0 && m_nRoundsIssued >= m_maxRounds) {
+    return;
+  }
+
+  if (m_outstandingRounds.size() < m_maxOutstanding) {
+    SendOneInterest();
+  }
+  else if (!m_isRoundDeferred) {
+    // Sent by FinishRound once a slot frees up; further ticks meanwhile are dropped
+    m_isRoundDeferred = true;
+    NS_LOG_DEBUG("Node " << m_nodeId << " deferring round: " << m_outstandingRounds.size()
+                 << " rounds in flight");
+  }
+
+  if (m_roundRate > 0) {
+    m_roundEvent = Simulator::Schedule(Seconds(1.0 / m_roundRate),
+                                       &ValueProducer::ScheduleNextRound, this);
+  }
+}
+
+void
+ValueProducer::FinishRound(uint32_t seq, bool isTimeout)
+{
+  auto it = m_outstandingRounds.find(seq);
+  if (it == m_outstandingRounds.end()) {
+    return;
+  }
+  if (isTimeout) {
+    NS_LOG_WARN("Node " << m_nodeId << " round seq=" << seq << " timed out");
+  }
+  else {
+    Simulator::Cancel(it->second);
+  }
+  m_outstandingRounds.erase(it);
+
+  if (m_isRoundDeferred) {
+    m_isRoundDeferred = false;
+    SendOneInterest();
   }
 }
 
@@ -105,22 +194,26 @@ ValueProducer::SendOneInterest()
   ::ndn::Name interestName = m_prefix;
   
   // Add sequence component - use proper marker
-  interestName.append("seq=" + std::to_string(m_seqNo++));
+  uint32_t seq = m_seqNo++;
+  interestName.append("seq=" + std::to_string(seq));
+  ++m_nRoundsIssued;
+  m_outstandingRounds[seq] = Simulator::Schedule(m_interestLifetime, &ValueProducer::FinishRound,
+                                                 this, seq, true);
   
   auto interest = std::make_shared<::ndn::Interest>(interestName);
   
   // Convert NS3 Time to NDN Time when setting interest lifetime
   interest->setInterestLifetime(::ndn::time::milliseconds(m_interestLifetime.GetMilliSeconds()));
   
-  std::cout << "Node " << m_nodeId << " sending Interest: " 
-            << interest->getName() 
-            << " at " << std::fixed << std::setprecision(2)
-            << Simulator::Now().GetSeconds() << "s" << std::endl;
+  NS_LOG_DEBUG("Node " << m_nodeId << " sending Interest: " 
+               << interest->getName() 
+               << " at " << std::fixed << std::setprecision(2)
+               << Simulator::Now().GetSeconds() << "s");
             
   // Log transmission using your custom transmitter
   m_transmittedInterests(interest, this, static_cast<nfd::face::Face*>(m_face.get()));
   m_face->sendInterest(*interest);
-  std::cout << "Interest sent via application face " << m_face->getId() << std::endl;
+  NS_LOG_DEBUG("Interest sent via application face " << m_face->getId());
   
   /*
   // ----- Modification: Send via a network face -----
@@ -132,8 +225,8 @@ ValueProducer::SendOneInterest()
       for (const auto &face : faceTable) {
           if (face.getId() != m_face->getId() && face.getId() != 0) { // Exclude app face and internal face
               nfd::Face* netFace = const_cast<nfd::Face*>(&face);
-              std::cout << "Using network face " << netFace->getId() 
-                        << " to send Interest" << std::endl;
+              NS_LOG_DEBUG("Using network face " << netFace->getId() 
+                           << " to send Interest");
               netFace->sendInterest(*interest);
               interestSent = true;
               break;
@@ -142,8 +235,8 @@ ValueProducer::SendOneInterest()
   }
   if (!interestSent) {
       // Fallback: if no network face is found, send via m_face (may cause a local loop)
-      std::cout << "No network face found, falling back to app face " 
-                << m_face->getId() << std::endl;
+      NS_LOG_DEBUG("No network face found, falling back to app face " 
+                   << m_face->getId());
       m_face->sendInterest(*interest);
   }
   */
@@ -157,50 +250,55 @@ ValueProducer::OnInterest(std::shared_ptr<const ::ndn::Interest> interest)
   ::ndn::Name interestName = interest->getName();
   uint32_t appFaceId = m_face->getId();
   
-  std::cout << "\nNode " << m_nodeId << " received Interest: " 
-            << interestName << " via app face " << appFaceId << std::endl;
+  NS_LOG_DEBUG("Node " << m_nodeId << " received Interest: " 
+               << interestName << " via app face " << appFaceId);
   
   // Define our local producer prefix, e.g. "/aggregate/<m_nodeId>"
   ::ndn::Name localPrefix("/aggregate");
-  localPrefix.appendNumber(m_nodeId);
+  ns3::ndn::AggregateUtils::appendId(localPrefix, m_nodeId);
   
-  // Remove any sequence components for a fair comparison
-  ::ndn::Name nameWithoutSeq = ns3::ndn::AggregateUtils::getNameWithoutSequence(interestName);
-  ::ndn::Name localPrefixWithoutSeq = ns3::ndn::AggregateUtils::getNameWithoutSequence(localPrefix);
+  // Compare the requested IDs, ignoring sequence and operator components
+  AggregateIdSet requestedIds = ns3::ndn::AggregateUtils::extractIdsFromName(interestName);
   
   // If this interest is for our own data, process it
-  if (nameWithoutSeq == localPrefixWithoutSeq) {
-    std::cout << "* Node " << m_nodeId << " received direct request for its data" << std::endl;
+  if (requestedIds.size() == 1 && requestedIds.contains(static_cast<int>(m_nodeId))) {
+    NS_LOG_DEBUG("* Node " << m_nodeId << " received direct request for its data");
     
-    auto data = std::make_shared<::ndn::Data>(interestName);
+    // Encode and sign through the shared pre-encoded Data template
     uint64_t val = static_cast<uint64_t>(m_nodeId);
-    uint64_t netVal = htobe64(val);
-    auto buffer = std::make_shared<::ndn::Buffer>(
-      reinterpret_cast<const uint8_t*>(&netVal), sizeof(netVal));
-    data->setContent(buffer);
-    data->setFreshnessPeriod(::ndn::time::seconds(1));
-    
-    ns3::ndn::StackHelper::getKeyChain().sign(*data);
+    AggregateOpSpec spec = AggregateOpSpec::select(interestName);
+    std::shared_ptr<::ndn::Data> data;
+    if (spec.isVector()) {
+      // Vector rounds carry one element per position instead of a single value
+      data = ns3::ndn::AggregateUtils::getDataTemplate().makeData(
+        interestName, ns3::ndn::AggregateUtils::makeVectorSample(spec, val));
+    }
+    else {
+      data = ns3::ndn::AggregateUtils::createDataWithValue(interestName, val);
+    }
     
     m_transmittedDatas(data, this, m_face);
     m_face->sendData(*data);
+    EmitEvent(AggregateEventType::PRODUCER_DATA, interestName, 1);
     
-    std::cout << "Node " << m_nodeId << " produced Data with value = " 
-              << val << " at " << std::fixed << std::setprecision(2)
-              << ns3::Simulator::Now().GetSeconds() << "s" << std::endl << std::flush;
+    NS_LOG_DEBUG("Node " << m_nodeId << " produced Data with value = " 
+                 << val << " at " << std::fixed << std::setprecision(2)
+                 << ns3::Simulator::Now().GetSeconds() << "s");
     return;
   }
   
   // IMPORTANT CHANGE: For non-self interests, use ForwardToStrategy
-  std::cout << "* Node " << m_nodeId 
-            << " directly forwarding interest to NFD" << std::endl;
+  NS_LOG_DEBUG("* Node " << m_nodeId 
+               << " directly forwarding interest to NFD");
   
   // Debug face states and FIB entries
   DebugFibEntries("Before forwarding interest");
   ForwardToStrategy(interest);
   
   // Schedule face statistics check
-  Simulator::Schedule(MilliSeconds(100), &ValueProducer::DebugFaceStats, this);
+  if (NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    Simulator::Schedule(MilliSeconds(100), &ValueProducer::DebugFaceStats, this);
+  }
 }
 
 
@@ -209,7 +307,7 @@ void
 ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
 { 
   ::ndn::Name dataName = data->getName();
-  std::cout << "\nNode " << m_nodeId << " received Data: " << dataName << std::endl << std::flush;
+  NS_LOG_DEBUG("Node " << m_nodeId << " received Data: " << dataName);
   
   // NEW: Check if this is a response to our self-generated interest
   bool isResponseToMyInterest = false;
@@ -220,17 +318,40 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
     
     if (prefix1 == prefix2) {
       isResponseToMyInterest = true;
-      std::cout << "✓ Node " << m_nodeId << " received response to self-generated interest!" << std::endl;
+      NS_LOG_DEBUG("Node " << m_nodeId << " received response to self-generated interest!");
       
-      // Extract the aggregated value
-      if (data->getContent().value_size() >= sizeof(uint64_t)) {
-        uint64_t netBytes;
-        std::memcpy(&netBytes, data->getContent().value(), sizeof(uint64_t));
-        uint64_t aggregatedValue = be64toh(netBytes);
+      // Extract the aggregated result for the operator carried in the name
+      AggregateIdSet missingIds;
+      if (data->getContent().value_size() > 0) {
+        AggregateState result = ns3::ndn::AggregateUtils::extractStateFromContent(
+          *data, AggregateOpSpec::select(dataName), missingIds);
+        // Allreduce: the shared global result, minus this node's own value where possible
+        if (m_isAllReduce && result.isInvertible() && !missingIds.contains(m_nodeId)) {
+          AggregateState own(result.getSpec());
+          own.addSample(static_cast<uint64_t>(m_nodeId));
+          result.subtract(own);
+        }
         
-        std::cout << "❗ FINAL RESULT: Node " << m_nodeId << " received aggregated value: " 
-                  << aggregatedValue << " at " << std::fixed << std::setprecision(2)
-                  << ns3::Simulator::Now().GetSeconds() << "s" << std::endl;
+        NS_LOG_INFO("FINAL RESULT: Node " << m_nodeId << " received aggregated value: " 
+                    << result.toString() << " at " << std::fixed << std::setprecision(2)
+                    << ns3::Simulator::Now().GetSeconds() << "s");
+        if (!missingIds.empty()) {
+          NS_LOG_INFO("  partial result, missing " << missingIds.size() << " IDs: " << missingIds);
+        }
+      }
+      // Only the IDs that contributed
+      AggregateIdSet resultIds = ns3::ndn::AggregateUtils::extractIdsFromName(dataName);
+      resultIds.subtract(missingIds);
+      EmitEvent(AggregateEventType::RESULT, dataName, resultIds.size());
+
+      // The name comes from the network: ignore a sequence component that is not a number
+      std::string seq = ns3::ndn::AggregateUtils::extractSequenceComponent(dataName).toUri();
+      uint32_t round = 0;
+      if (seq.compare(0, 4, "seq=") == 0) {
+        auto result = std::from_chars(seq.data() + 4, seq.data() + seq.size(), round);
+        if (result.ec == std::errc() && result.ptr == seq.data() + seq.size() && seq.size() > 4) {
+          FinishRound(round, false);
+        }
       }
       
       // Let standard NDN processing occur for PIT cleanup
@@ -241,16 +362,10 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
 
   // Check if this is our own data
   bool isSelfProduced = false;
-  if (dataName.size() >= 2 && dataName.get(0).toUri() == "aggregate") {
-    try {
-      uint64_t dataNodeId = dataName.get(1).toNumber();
-      if (dataNodeId == static_cast<uint64_t>(m_nodeId)) {
-        isSelfProduced = true;
-      }
-    }
-    catch (const std::exception&) {
-      // Not a numeric component or not our data
-    }
+  int dataNodeId = 0;
+  if (dataName.size() >= 2 && dataName.get(0).toUri() == "aggregate" &&
+      ns3::ndn::AggregateUtils::decodeIdComponent(dataName.get(1), dataNodeId)) {
+    isSelfProduced = dataNodeId == m_nodeId;
   }
   
   if (isSelfProduced) {
@@ -260,19 +375,19 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
     
     // Skip if we've already processed this data packet
     if (processedDataNames.find(dataNameStr) != processedDataNames.end()) {
-      std::cout << "* Node " << m_nodeId << " already processed data " << dataNameStr << " - skipping to avoid loops" << std::endl;
+      NS_LOG_DEBUG("* Node " << m_nodeId << " already processed data " << dataNameStr << " - skipping to avoid loops");
       return; // Skip further processing
     }
     
     // Mark this data as processed
     processedDataNames.insert(dataNameStr);
     
-    std::cout << "* Node " << m_nodeId << " received self-produced data - forwarding to network" << std::endl;
+    NS_LOG_DEBUG("* Node " << m_nodeId << " received self-produced data - forwarding to network");
     
     // Get access to L3 protocol and faces
     auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
     if (!l3proto) {
-      std::cout << "ERROR: Could not get L3Protocol!" << std::endl;
+      NS_LOG_ERROR("Could not get L3Protocol!");
       return;
     }
   
@@ -291,33 +406,21 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
         std::string uriStr = transport->getLocalUri().toString();
         if (uriStr.find("netdev://") == 0) {
           networkFace = const_cast<nfd::Face*>(&face);
-          std::cout << "  Found network face " << face.getId() << " for data injection" << std::endl;
+          NS_LOG_DEBUG("  Found network face " << face.getId() << " for data injection");
           break;
         }
       }
     }
     
     if (networkFace) {
-      // Create a properly formatted & signed Data packet
-      std::cout << "  Creating properly formatted Data packet for: " << data->getName() << std::endl;
-      
-      // The key fix: Create a fresh Data packet with the same content but ensure proper signing
-      auto freshData = std::make_shared<::ndn::Data>(data->getName());
-      freshData->setContent(data->getContent());
-      freshData->setFreshnessPeriod(data->getFreshnessPeriod());
-      
-      // This is critical - use the KeyChain to properly sign the data packet
-      // This is the simplest and most reliable approach
-      ns3::ndn::StackHelper::getKeyChain().sign(*freshData);
-      
-      // Send it via the network face
-      std::cout << "  Sending properly formatted Data packet via face " << networkFace->getId() << std::endl;
-      networkFace->sendData(*freshData);
+      // The Data was signed when it was produced, so its wire encoding is sent as is
+      NS_LOG_DEBUG("  Sending Data packet via face " << networkFace->getId());
+      networkFace->sendData(*data);
       
       // Record that we've processed this data
       dataForwarded = true;
     } else {
-      std::cout << "  WARNING: No suitable network face found for data injection" << std::endl;
+      NS_LOG_WARN("No suitable network face found for data injection");
     }
     
     // Important: Don't call App::OnData, as this could re-process the data
@@ -326,7 +429,7 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
   }
   
   // This is data from other nodes - extract and process the content
-  std::cout << "* Node " << m_nodeId << " processing received data" << std::endl;
+  NS_LOG_DEBUG("* Node " << m_nodeId << " processing received data");
   
   // Standard processing of data content
   if (data->getContent().value_size() >= sizeof(uint64_t)) {
@@ -336,15 +439,15 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
     
     // For aggregated results with multiple node IDs
     if (dataName.size() >= 3) {
-      std::cout << "✓ Node " << m_nodeId << " received AGGREGATED result: " 
-                << value << " at " << std::fixed << std::setprecision(2)
-                << ns3::Simulator::Now().GetSeconds() << "s" << std::endl;
+      NS_LOG_INFO("Node " << m_nodeId << " received AGGREGATED result: " 
+                  << value << " at " << std::fixed << std::setprecision(2)
+                  << ns3::Simulator::Now().GetSeconds() << "s");
     } 
     // For single node data
     else {
-      std::cout << "Node " << m_nodeId << " received individual value: " 
-                << value << " at " << std::fixed << std::setprecision(2)
-                << ns3::Simulator::Now().GetSeconds() << "s" << std::endl;
+      NS_LOG_DEBUG("Node " << m_nodeId << " received individual value: " 
+                   << value << " at " << std::fixed << std::setprecision(2)
+                   << ns3::Simulator::Now().GetSeconds() << "s");
     }
   }
   
@@ -356,12 +459,16 @@ ValueProducer::OnData(std::shared_ptr<const ::ndn::Data> data)
 void
 ValueProducer::DebugPitState(const ::ndn::Name& interestName)
 {
-  std::cout << "PRODUCER " << m_nodeId << ": Before sending data, checking local PIT:" << std::endl;
+  if (!NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    return;
+  }
+
+  NS_LOG_DEBUG("PRODUCER " << m_nodeId << ": Before sending data, checking local PIT:");
 
   // Get the L3Protocol from the node
   auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
   if (!l3proto) {
-    std::cout << "  ERROR: Could not get L3Protocol from node!" << std::endl;
+    NS_LOG_ERROR("Could not get L3Protocol from node!");
     return;
   }
   
@@ -370,27 +477,27 @@ ValueProducer::DebugPitState(const ::ndn::Name& interestName)
   
   // Now access the PIT
   const auto& pit = forwarder->getPit();
-  std::cout << "  Found " << std::distance(pit.begin(), pit.end()) << " total PIT entries" << std::endl;
+  NS_LOG_DEBUG("  Found " << std::distance(pit.begin(), pit.end()) << " total PIT entries");
   
   for (const auto& pitEntry : pit) {
-    std::cout << "  PIT entry: " << pitEntry.getName() 
-              << " (InFaces=" << pitEntry.getInRecords().size()
-              << ", OutFaces=" << pitEntry.getOutRecords().size() 
-              << ")" << std::endl;
+    NS_LOG_DEBUG("  PIT entry: " << pitEntry.getName() 
+                 << " (InFaces=" << pitEntry.getInRecords().size()
+                 << ", OutFaces=" << pitEntry.getOutRecords().size() 
+                 << ")");
               
     // For matching entries, print details about each face
     if (pitEntry.getName().isPrefixOf(interestName) || 
         interestName.isPrefixOf(pitEntry.getName())) {
-      std::cout << "    MATCH for current interest! Details:" << std::endl;
+      NS_LOG_DEBUG("    MATCH for current interest! Details:");
       
       // Print IN faces
       for (const auto& inRecord : pitEntry.getInRecords()) {
-        std::cout << "    IN face: " << inRecord.getFace().getId() << std::endl;
+        NS_LOG_DEBUG("    IN face: " << inRecord.getFace().getId());
       }
       
       // Print OUT faces
       for (const auto& outRecord : pitEntry.getOutRecords()) {
-        std::cout << "    OUT face: " << outRecord.getFace().getId() << std::endl;
+        NS_LOG_DEBUG("    OUT face: " << outRecord.getFace().getId());
       }
     }
   }
@@ -399,15 +506,19 @@ ValueProducer::DebugPitState(const ::ndn::Name& interestName)
 void
 ValueProducer::DebugFibEntries(const std::string& message)
 {
-  std::cout << "--- FIB DEBUG for Node " << m_nodeId 
-            << " at " << std::fixed << std::setprecision(2) 
-            << Simulator::Now().GetSeconds() << "s ---" << std::endl;
-  std::cout << message << std::endl;
+  if (!NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    return;
+  }
+
+  NS_LOG_DEBUG("--- FIB DEBUG for Node " << m_nodeId 
+               << " at " << std::fixed << std::setprecision(2) 
+               << Simulator::Now().GetSeconds() << "s ---");
+  NS_LOG_DEBUG(message);
 
   // Get the L3Protocol from the node
   auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
   if (!l3proto) {
-    std::cout << "  ERROR: Could not get L3Protocol from node!" << std::endl;
+    NS_LOG_ERROR("Could not get L3Protocol from node!");
     return;
   }
   
@@ -416,18 +527,18 @@ ValueProducer::DebugFibEntries(const std::string& message)
   
   // Access the FIB
   const auto& fib = forwarder->getFib();
-  std::cout << "  Found " << std::distance(fib.begin(), fib.end()) << " total FIB entries" << std::endl;
+  NS_LOG_DEBUG("  Found " << std::distance(fib.begin(), fib.end()) << " total FIB entries");
   
   // Track unique faces seen in FIB entries
   std::set<uint32_t> uniqueFaces;
   
   for (const auto& fibEntry : fib) {
-    std::cout << "  FIB entry: " << fibEntry.getPrefix() << std::endl;
+    NS_LOG_DEBUG("  FIB entry: " << fibEntry.getPrefix());
     
     // Print nexthops
     for (const auto& nexthop : fibEntry.getNextHops()) {
-      std::cout << "    NextHop face: " << nexthop.getFace().getId() 
-                << " (cost: " << nexthop.getCost() << ")" << std::endl;
+      NS_LOG_DEBUG("    NextHop face: " << nexthop.getFace().getId() 
+                   << " (cost: " << nexthop.getCost() << ")");
       
       // Keep track of unique faces
       uniqueFaces.insert(nexthop.getFace().getId());
@@ -435,7 +546,7 @@ ValueProducer::DebugFibEntries(const std::string& message)
   }
   
   // Print summary of unique faces found in FIB
-  std::cout << "  Found " << uniqueFaces.size() << " unique faces in FIB entries:" << std::endl;
+  NS_LOG_DEBUG("  Found " << uniqueFaces.size() << " unique faces in FIB entries:");
   for (uint32_t faceId : uniqueFaces) {
     std::string faceType;
     if (faceId == 0)
@@ -445,26 +556,30 @@ ValueProducer::DebugFibEntries(const std::string& message)
     else
       faceType = "app/net";
       
-    std::cout << "    Face ID: " << faceId << " (" << faceType << ")" << std::endl;
+    NS_LOG_DEBUG("    Face ID: " << faceId << " (" << faceType << ")");
   }
   
-  std::cout << "--- END FIB DEBUG ---" << std::endl;
+  NS_LOG_DEBUG("--- END FIB DEBUG ---");
 }
 
 void
 ValueProducer::DebugFaceStats()
 {
-  std::cout << "\n----- FACE STATS FOR NODE " << m_nodeId << " -----" << std::endl;
+  if (!NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    return;
+  }
+
+  NS_LOG_DEBUG("----- FACE STATS FOR NODE " << m_nodeId << " -----");
   
   auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
   if (!l3proto) {
-    std::cout << "  ERROR: Could not get L3Protocol" << std::endl;
+    NS_LOG_ERROR("Could not get L3Protocol");
     return;
   }
   
   // Iterate through all faces (using the correct type)
   const nfd::FaceTable& faceTable = l3proto->getFaceTable();
-  std::cout << "  Face Table size: " << faceTable.size() << std::endl;
+  NS_LOG_DEBUG("  Face Table size: " << faceTable.size());
   
   // Start from 1 (not 0) - face 0 causes segfault
   for (uint32_t faceId = 1; faceId < 300; faceId++) {
@@ -476,16 +591,16 @@ ValueProducer::DebugFaceStats()
       if (faceTable.get(faceId) != nullptr) {
         facePtr = faceTable.get(faceId)->shared_from_this();
         
-        std::cout << "  Face ID: " << faceId << std::endl;
-        std::cout << "    nInInterests: " << facePtr->getCounters().nInInterests << std::endl;
-        std::cout << "    nOutInterests: " << facePtr->getCounters().nOutInterests << std::endl;
-        std::cout << "    nInData: " << facePtr->getCounters().nInData << std::endl;
-        std::cout << "    nOutData: " << facePtr->getCounters().nOutData << std::endl;
+        NS_LOG_DEBUG("  Face ID: " << faceId);
+        NS_LOG_DEBUG("    nInInterests: " << facePtr->getCounters().nInInterests);
+        NS_LOG_DEBUG("    nOutInterests: " << facePtr->getCounters().nOutInterests);
+        NS_LOG_DEBUG("    nInData: " << facePtr->getCounters().nInData);
+        NS_LOG_DEBUG("    nOutData: " << facePtr->getCounters().nOutData);
         
         auto transport = facePtr->getTransport();
         if (transport) {
-          std::cout << "    LocalUri: " << transport->getLocalUri() << std::endl;
-          std::cout << "    RemoteUri: " << transport->getRemoteUri() << std::endl;
+          NS_LOG_DEBUG("    LocalUri: " << transport->getLocalUri());
+          NS_LOG_DEBUG("    RemoteUri: " << transport->getRemoteUri());
         }
       }
     }
@@ -494,7 +609,7 @@ ValueProducer::DebugFaceStats()
     }
   }
   
-  std::cout << "------------------------------" << std::endl << std::flush;
+  NS_LOG_DEBUG("------------------------------");
 }
 
 // Add this function to the ValueProducer class:
@@ -502,18 +617,18 @@ ValueProducer::DebugFaceStats()
 void
 ValueProducer::ForwardDataToNetwork(std::shared_ptr<const ::ndn::Data> data)
 {
-  std::cout << "Node " << m_nodeId << " attempting explicit forwarding of " 
-            << data->getName() << std::endl;
+  NS_LOG_DEBUG("Node " << m_nodeId << " attempting explicit forwarding of " 
+               << data->getName());
             
   auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
   if (!l3proto) {
-    std::cout << "ERROR: Could not get L3Protocol!" << std::endl;
+    NS_LOG_ERROR("Could not get L3Protocol!");
     return;
   }
   
   // Get the FaceTable
   const nfd::FaceTable& faceTable = l3proto->getFaceTable();
-  std::cout << "  Face Table size: " << faceTable.size() << std::endl;
+  NS_LOG_DEBUG("  Face Table size: " << faceTable.size());
   
   // We need to use forEachFace instead of trying to iterate directly
   std::shared_ptr<nfd::Face> networkFace;
@@ -530,42 +645,43 @@ ValueProducer::ForwardDataToNetwork(std::shared_ptr<const ::ndn::Data> data)
             // This is a network face
             networkFace = l3proto->getFaceById(faceId.getId());
             networkFaceId = faceId.getId();
-            std::cout << "  Found network interface: " << uriStr 
-                      << " (ID: " << networkFaceId << ")" << std::endl;
+            NS_LOG_DEBUG("  Found network interface: " << uriStr 
+                         << " (ID: " << networkFaceId << ")");
             break;
           }
         }
       }
     }
     catch (const std::exception& e) {
-      std::cout << "  Error processing face: " << e.what() << std::endl;
+      NS_LOG_DEBUG("  Error processing face: " << e.what());
     }
   }
   
   if (networkFace) {
-    std::cout << "Node " << m_nodeId << " EXPLICITLY forwarding data " 
-              << data->getName() << " to network face " << networkFaceId 
-              << std::endl;
+    NS_LOG_DEBUG("Node " << m_nodeId << " EXPLICITLY forwarding data " 
+                 << data->getName() << " to network face " << networkFaceId);
               
     // Send the data packet on the network face
     networkFace->sendData(*data);
     
     // Debug to verify
-    Simulator::Schedule(MilliSeconds(10), &ValueProducer::DebugFaceStats, this);
+    if (NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+      Simulator::Schedule(MilliSeconds(10), &ValueProducer::DebugFaceStats, this);
+    }
   }
   else {
-    std::cout << "ERROR: No suitable network face found for forwarding!" << std::endl;
+    NS_LOG_ERROR("No suitable network face found for forwarding!");
     
     // List all available faces to help diagnose
-    std::cout << "  Available faces:" << std::endl;
+    NS_LOG_DEBUG("  Available faces:");
     for (const auto& f : faceTable) {
       try {
         auto transport = f.getTransport();
         std::string uriStr = transport ? transport->getLocalUri().toString() : "no-transport";
-        std::cout << "    Face ID " << f.getId() << ": " << uriStr << std::endl;
+        NS_LOG_DEBUG("    Face ID " << f.getId() << ": " << uriStr);
       }
       catch (const std::exception& e) {
-        std::cout << "    Face ID " << f.getId() << ": <error: " << e.what() << ">" << std::endl;
+        NS_LOG_DEBUG("    Face ID " << f.getId() << ": <error: " << e.what() << ">");
       }
     }
   }
@@ -573,21 +689,31 @@ ValueProducer::ForwardDataToNetwork(std::shared_ptr<const ::ndn::Data> data)
 
 // Update the ForwardToStrategy method:
 
+void
+ValueProducer::EmitEvent(AggregateEventType type, const ::ndn::Name& name, size_t idCount)
+{
+  const auto& sink = AggregateEventSink::getInstance();
+  if (sink.isEnabled(type)) {
+    sink.emit({Simulator::Now().GetSeconds(), static_cast<uint32_t>(m_nodeId), type, name,
+               m_face->getId(), idCount});
+  }
+}
+
 void
 ValueProducer::ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest)
 {
-  std::cout << "* Node " << m_nodeId << " DIRECT FORWARDING to strategy" << std::endl;
+  NS_LOG_DEBUG("* Node " << m_nodeId << " DIRECT FORWARDING to strategy");
   
   // Get the NFD pipeline directly
   auto l3proto = GetNode()->GetObject<ns3::ndn::L3Protocol>();
   if (!l3proto) {
-    std::cout << "ERROR: Could not get L3Protocol!" << std::endl;
+    NS_LOG_ERROR("Could not get L3Protocol!");
     return;
   }
   
   auto forwarder = l3proto->getForwarder();
   if (!forwarder) {
-    std::cout << "ERROR: Could not get Forwarder!" << std::endl;
+    NS_LOG_ERROR("Could not get Forwarder!");
     return;
   }
   
@@ -602,15 +728,15 @@ ValueProducer::ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest
   // Add this app face as an IN record in the PIT entry
   pitEntry->insertOrUpdateInRecord(*m_face, *newInterest);
   
-  std::cout << "  [IMPORTANT] Created PIT entry for " << newInterest->getName() 
-            << " with app face " << m_face->getId() << " as InRecord" << std::endl;
+  NS_LOG_DEBUG("  [IMPORTANT] Created PIT entry for " << newInterest->getName() 
+               << " with app face " << m_face->getId() << " as InRecord");
   
   // Look up the FIB entry for this interest
   const auto& fib = forwarder->getFib();
   const auto& fibEntry = fib.findLongestPrefixMatch(newInterest->getName());
   
   if (fibEntry.getNextHops().empty()) {
-    std::cout << "ERROR: No next hops found in FIB for " << newInterest->getName() << std::endl;
+    NS_LOG_ERROR("No next hops found in FIB for " << newInterest->getName());
     return;
   }
   
@@ -631,9 +757,9 @@ ValueProducer::ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest
       
       // Only use network faces (netdev://)
       if (uriStr.find("netdev://") == 0) {
-        std::cout << "  Using FIB entry: " << fibEntry.getPrefix() 
-                  << " → sending via face " << face.getId() 
-                  << " (cost: " << nextHop.getCost() << ")" << std::endl;
+        NS_LOG_DEBUG("  Using FIB entry: " << fibEntry.getPrefix() 
+                     << " → sending via face " << face.getId() 
+                     << " (cost: " << nextHop.getCost() << ")");
         
         // IMPORTANT: Add an OUT record to the PIT entry
         nfd::Face* mutableFace = const_cast<nfd::Face*>(&face);
@@ -643,9 +769,9 @@ ValueProducer::ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest
         mutableFace->sendInterest(*newInterest);
         
         // DEBUG: Verify PIT entry after sending
-        std::cout << "  [PIT-VERIFY] After sending, PIT entry has " 
-                  << pitEntry->getInRecords().size() << " in-records and "
-                  << pitEntry->getOutRecords().size() << " out-records" << std::endl;
+        NS_LOG_DEBUG("  [PIT-VERIFY] After sending, PIT entry has " 
+                     << pitEntry->getInRecords().size() << " in-records and "
+                     << pitEntry->getOutRecords().size() << " out-records");
                 
         sentInterest = true;
         break;
@@ -654,17 +780,19 @@ ValueProducer::ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest
   }
   
   if (!sentInterest) {
-    std::cout << "ERROR: Could not find suitable network face to send interest" << std::endl;
-    std::cout << "  Available next hops for " << fibEntry.getPrefix() << ":" << std::endl;
+    NS_LOG_ERROR("Could not find suitable network face to send interest");
+    NS_LOG_DEBUG("  Available next hops for " << fibEntry.getPrefix() << ":");
     for (const auto& nh : fibEntry.getNextHops()) {
-      std::cout << "    Face " << nh.getFace().getId() 
-                << " (cost: " << nh.getCost() << ")" << std::endl;
+      NS_LOG_DEBUG("    Face " << nh.getFace().getId() 
+                   << " (cost: " << nh.getCost() << ")");
     }
   }
   
   // Verify PIT entries after forwarding
-  Simulator::Schedule(MilliSeconds(5), &ValueProducer::DebugPitState, 
-                     this, newInterest->getName());
+  if (NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    Simulator::Schedule(MilliSeconds(5), &ValueProducer::DebugPitState,
+                        this, newInterest->getName());
+  }
 }
 
 } // namespace ndn
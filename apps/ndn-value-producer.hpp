@@ -3,13 +3,25 @@
 
 #include "ns3/ndnSIM/apps/ndn-app.hpp"
 #include "ns3/nstime.h"
+#include "ns3/event-id.h"
 #include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
 
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
 /**
  * @brief NDN application that combines producer and consumer functionality
+ *
+ * As a consumer it requests Prefix once, at 1s. With RoundRate > 0 it instead issues a
+ * new round (a new "seq=" component) every 1/RoundRate seconds, with at most
+ * MaxOutstandingRounds rounds in flight. A round that finds the window full is sent as
+ * soon as an earlier round completes or times out.
+ *
+ * With AllReduce, every node requests the same global aggregate, so the network can
+ * coalesce the requests and multicast one result; each node then takes its own value
+ * out of the result when the operator is invertible.
  */
 class ValueProducer : public App {
 public:
@@ -35,7 +47,7 @@ public:
 protected:
   // Overridden from Application base class
   virtual void StartApplication() override;
-  // virtual void StopApplication() override;
+  virtual void StopApplication() override;
   
   /**
    * @brief Callback for Interest reception
@@ -57,22 +69,45 @@ protected:
   void DebugFaceStats();
 
   /**
-   * @brief Sends a single Interest (for consumer functionality)
+   * @brief Forward data to network
+   */
+  void ForwardDataToNetwork(std::shared_ptr<const ::ndn::Data> data);
+
+  void ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest);
+
+  /**
+   * @brief Sends a single Interest for the next round (for consumer functionality)
    */
   void SendOneInterest();
 
   /**
-   * @brief Forward data to network
+   * @brief Issue the next round if the window allows, and schedule the following one
    */
-  void ForwardDataToNetwork(std::shared_ptr<const ::ndn::Data> data);
+  void ScheduleNextRound();
 
-  void ForwardToStrategy(std::shared_ptr<const ::ndn::Interest> interest);
+  /**
+   * @brief Release the window slot of round @p seq
+   */
+  void FinishRound(uint32_t seq, bool isTimeout);
+
+  /**
+   * @brief Report a structured event to AggregateEventSink if its type is enabled
+   */
+  void EmitEvent(AggregateEventType type, const ::ndn::Name& name, size_t idCount);
 
 private:
   int m_nodeId;               ///< Node ID to return as value
   ::ndn::Name m_prefix;       ///< Interest prefix to use for consumer role
   ns3::Time m_interestLifetime; ///< Interest lifetime as ns3::Time
   uint32_t m_seqNo; // Per-instance sequence number counter
+  double m_roundRate;            ///< Rounds per second, 0 for a single round
+  uint32_t m_maxRounds;          ///< Number of rounds to issue, 0 for unlimited
+  uint32_t m_maxOutstanding;     ///< Window of rounds in flight
+  uint32_t m_nRoundsIssued;
+  bool m_isRoundDeferred;        ///< A round is waiting for a free window slot
+  EventId m_roundEvent;
+  std::map<uint32_t, EventId> m_outstandingRounds; ///< seq -> round timeout
+  bool m_isAllReduce;            ///< Prefix includes this node's own ID
   
   // Add these missing member variables:
   int m_payloadSize;          ///< Size of payload in Data packet
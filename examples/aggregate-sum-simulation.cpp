@@ -29,13 +29,28 @@ static ns3::GlobalValue g_nodeCount("NodeCount",
  * Initialize simulation: parse command line args and set up logging
  */
 void 
-initializeSimulation(int argc, char* argv[], int& nodeCount) 
+initializeSimulation(int argc, char* argv[], int& nodeCount, std::string& op, std::string& signing,
+                     std::string& eventLog, std::string& events, double& roundRate, int& window,
+                     bool& multipath, Time& deadline, uint32_t& retx) 
 {
   std::cout << "=== INITIALIZING SIMULATION ===" << std::endl;
   
   // Parse command line arguments
   CommandLine cmd;
   cmd.AddValue("nodeCount", "Number of consumer-producer in the network", nodeCount);
+  cmd.AddValue("op", "Aggregation operator: sum, min, max, count, mean or hist,<lower>,<width>,<buckets>; "
+               "sum, min and max take ,<i32|i64|f32|f64>,<length> for element-wise vectors", op);
+  cmd.AddValue("signing", "Signing of aggregation Data: keychain, digest, fake or none", signing);
+  cmd.AddValue("roundRate", "Aggregation rounds per second per consumer (0 for a single round)",
+               roundRate);
+  cmd.AddValue("window", "Rounds a consumer may have in flight at once", window);
+  cmd.AddValue("multipath", "Spread sub-Interests over equal-cost next hops", multipath);
+  cmd.AddValue("deadline", "Per-hop deadline after which aggregators send partial results (0 = off)",
+               deadline);
+  cmd.AddValue("retx", "Retransmissions per unanswered sub-Interest (0 = off)", retx);
+  cmd.AddValue("eventLog", "Write aggregation events to this tab-separated file", eventLog);
+  cmd.AddValue("events", "Comma-separated event types to log (e.g. sub-interest-sent,cache-hit) or all",
+               events);
   cmd.Parse(argc, argv);
 
   // Bind to global value
@@ -68,16 +83,48 @@ configureTimeMarkers()
 int 
 main(int argc, char* argv[]) 
 {
-  // Default node count
+  // Default node count, operator and signing policy
   int nodeCount = 5;
+  std::string op = "sum";
+  std::string signing = "keychain";
+  std::string eventLog;
+  std::string events = "all";
+  double roundRate = 0;
+  int window = 1;
+  bool multipath = false;
+  Time deadline(0);
+  uint32_t retx = 0;
   
   // Initialize simulation
-  initializeSimulation(argc, argv, nodeCount);
+  initializeSimulation(argc, argv, nodeCount, op, signing, eventLog, events, roundRate, window,
+                       multipath, deadline, retx);
+
+  ns3::ndn::AggregateOpSpec opSpec;
+  if (!ns3::ndn::AggregateOpSpec::fromComponent(::ndn::Name::Component("op=" + op), opSpec)) {
+    NS_FATAL_ERROR("Unknown aggregation operator: " << op);
+  }
+  ns3::ndn::AggregateSigningPolicy signingPolicy;
+  if (!ns3::ndn::AggregateDataTemplate::parseSigningPolicy(signing, signingPolicy)) {
+    NS_FATAL_ERROR("Unknown signing policy: " << signing);
+  }
+  uint32_t eventMask = 0;
+  if (!ns3::ndn::AggregateEventSink::parseMask(events, eventMask)) {
+    NS_FATAL_ERROR("Unknown aggregation event type in: " << events);
+  }
 
   // Create a single helper for our entire simulation
   // Use the fully qualified namespace to avoid ambiguity
   ns3::ndn::AggregateSimulationHelper helper;
   helper.SetNodeCount(nodeCount);
+  helper.SetOperator(opSpec);
+  helper.SetSigningPolicy(signingPolicy);
+  helper.SetRoundSchedule(roundRate, 0, window);
+  helper.SetMultipath(multipath);
+  helper.SetDeadline(deadline);
+  helper.SetRetransmission(retx);
+  if (!eventLog.empty()) {
+    helper.EnableEventLog(eventLog, eventMask);
+  }
   
   // Create topology
   NodeContainer nodes = helper.CreateTopology();
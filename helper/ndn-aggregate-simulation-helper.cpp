@@ -1,10 +1,32 @@
 #include "ndn-aggregate-simulation-helper.hpp"
 
+#include <fstream>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.AggregateSimulationHelper");
+
 namespace ns3 {
 namespace ndn {
 
 AggregateSimulationHelper::AggregateSimulationHelper()
   : m_nodeCount(5)
+  , m_fanIn(4)
+  , m_roundRate(0)
+  , m_maxRounds(0)
+  , m_maxOutstandingRounds(1)
+  , m_isMultipath(false)
+  , m_deadline(0)
+  , m_deadlineMargin(MilliSeconds(2))
+  , m_maxRetx(0)
+  , m_hasCacheLimits(false)
+  , m_cacheCapacity(0)
+  , m_cacheTtl(0)
+  , m_treeFanIn(4)
+  , m_treeLevels(0)
+  , m_treeObjective(AggregateTreePlanner::Objective::LATENCY)
+  , m_isAllReduce(false)
+  , m_systemCount(1)
+  , m_systemId(0)
 {
 }
 
@@ -18,106 +40,232 @@ AggregateSimulationHelper::SetNodeCount(int count)
   m_nodeCount = count;
 }
 
+void
+AggregateSimulationHelper::SetFanIn(int racksPerCore)
+{
+  m_fanIn = std::max(1, racksPerCore);
+}
+
+void
+AggregateSimulationHelper::SetFatTree(uint32_t k, uint32_t hostsPerRack)
+{
+  m_topology = AggregateTopology::makeFatTree(k, hostsPerRack);
+}
+
+void
+AggregateSimulationHelper::SetLeafSpine(uint32_t leafCount, uint32_t spineCount,
+                                        uint32_t hostsPerRack)
+{
+  m_topology = AggregateTopology::makeLeafSpine(leafCount, spineCount, hostsPerRack);
+}
+
+void
+AggregateSimulationHelper::SetTreeTopology(uint32_t degree, uint32_t levels, uint32_t hostsPerRack)
+{
+  m_topology = AggregateTopology::makeTree(degree, levels, hostsPerRack);
+}
+
+void
+AggregateSimulationHelper::SetIdEncoding(AggregateUtils::IdEncoding encoding)
+{
+  AggregateUtils::setIdEncoding(encoding);
+}
+
+void
+AggregateSimulationHelper::SetSigningPolicy(AggregateSigningPolicy policy)
+{
+  AggregateUtils::getDataTemplate().setSigningPolicy(policy);
+}
+
+void
+AggregateSimulationHelper::SetOperator(const AggregateOpSpec& spec)
+{
+  m_operator = spec;
+}
+
+void
+AggregateSimulationHelper::SetRoundSchedule(double roundsPerSecond, uint32_t maxRounds,
+                                            uint32_t maxOutstanding)
+{
+  m_roundRate = roundsPerSecond;
+  m_maxRounds = maxRounds;
+  m_maxOutstandingRounds = std::max(1u, maxOutstanding);
+}
+
+void
+AggregateSimulationHelper::SetMultipath(bool isEnabled)
+{
+  m_isMultipath = isEnabled;
+}
+
+void
+AggregateSimulationHelper::SetDeadline(Time deadline, Time margin)
+{
+  m_deadline = deadline;
+  m_deadlineMargin = margin;
+}
+
+void
+AggregateSimulationHelper::SetRetransmission(uint32_t maxRetx)
+{
+  m_maxRetx = maxRetx;
+}
+
+void
+AggregateSimulationHelper::SetValueCache(uint32_t capacity, Time ttl)
+{
+  m_hasCacheLimits = true;
+  m_cacheCapacity = capacity;
+  m_cacheTtl = ttl;
+}
+
+void
+AggregateSimulationHelper::SetAggregationTree(uint32_t fanIn, uint32_t levels,
+                                              AggregateTreePlanner::Objective objective)
+{
+  m_treeFanIn = fanIn;
+  m_treeLevels = levels;
+  m_treeObjective = objective;
+}
+
+void
+AggregateSimulationHelper::SetAllReduce(bool isEnabled)
+{
+  m_isAllReduce = isEnabled;
+}
+
+void
+AggregateSimulationHelper::SetPartitions(uint32_t systemCount, uint32_t systemId)
+{
+  NS_ABORT_MSG_IF(systemId >= std::max(1u, systemCount), "Rank " << systemId << " out of " << systemCount);
+  m_systemCount = std::max(1u, systemCount);
+  m_systemId = systemId;
+}
+
 NodeContainer
 AggregateSimulationHelper::CreateTopology()
 {
   std::cout << "=== CREATING TOPOLOGY ===" << std::endl;
   
-  // Exactly one consumer/producer node per rack as requested
-  int numRacks = m_nodeCount; 
-  int numRackAggregators = numRacks;
-  int numCoreAggregators = (numRacks > 1) ? std::max(1, numRacks / 4) : 0;
-  
-  int totalNodes = m_nodeCount + numRackAggregators + numCoreAggregators;
-  
-  std::cout << "Topology configuration:" << std::endl
-            << "  " << m_nodeCount << " producer/consumer nodes (1 per rack)" << std::endl
-            << "  " << numRacks << " racks" << std::endl
-            << "  " << numRackAggregators << " rack-level aggregators" << std::endl
-            << "  " << numCoreAggregators << " core aggregators" << std::endl
-            << "  " << totalNodes << " total nodes" << std::endl;
+  // Without a generator, one consumer/producer node per rack under fanIn-sized core groups
+  AggregateTopology topology = m_topology ? *m_topology :
+                                            AggregateTopology::makeRacks(m_nodeCount, m_fanIn);
+  const auto& layout = topology.getNodes();
+  
+  int totalNodes = layout.size();
+  uint32_t numRacks = topology.count(AggregateUtils::NodeRole::RACK_AGG);
+  m_nodeCount = topology.count(AggregateUtils::NodeRole::PRODUCER);
+  // With partitions, only the first rank reports the topology
+  bool isVerbose = m_systemId == 0;
+  
+  if (isVerbose) {
+    std::cout << "Topology configuration:" << std::endl
+              << "  " << m_nodeCount << " producer/consumer nodes" << std::endl
+              << "  " << numRacks << " racks" << std::endl
+              << "  " << numRacks << " rack-level aggregators" << std::endl
+              << "  " << topology.count(AggregateUtils::NodeRole::POD_AGG) << " pod aggregators"
+              << std::endl
+              << "  " << topology.count(AggregateUtils::NodeRole::CORE_AGG) << " core aggregators"
+              << std::endl
+              << "  " << totalNodes << " total nodes" << std::endl;
+    if (m_systemCount > 1) {
+      std::cout << "  " << m_systemCount << " ranks, racks in contiguous blocks" << std::endl;
+    }
+  }
   
-  // Create all nodes
+  // Create all nodes, each on the rank that simulates it; hosts and their rack
+  // aggregator stay together, so only links above the racks can cross ranks
   NodeContainer nodes;
-  nodes.Create(totalNodes);
+  uint32_t upperIndex = 0;
+  for (const auto& node : layout) {
+    uint32_t systemId;
+    if (node.rack >= 0) {
+      systemId = static_cast<uint64_t>(node.rack) * m_systemCount / numRacks;
+    }
+    else {
+      systemId = upperIndex++ % m_systemCount;
+    }
+    nodes.Add(CreateObject<Node>(systemId));
+  }
   
   // Clear and repopulate node IDs
   m_producerIds.clear();
   m_rackAggregatorIds.clear();
   m_coreAggregatorIds.clear();
-  
-  // Assign node IDs
-  for (int i = 0; i < m_nodeCount; i++) {
-    m_producerIds.push_back(i);
+  m_podAggregatorIds.clear();
+  
+  for (int i = 0; i < totalNodes; i++) {
+    switch (layout[i].role) {
+      case AggregateUtils::NodeRole::PRODUCER:
+        m_producerIds.push_back(i);
+        break;
+      case AggregateUtils::NodeRole::RACK_AGG:
+        m_rackAggregatorIds.push_back(i);
+        break;
+      case AggregateUtils::NodeRole::POD_AGG:
+        m_podAggregatorIds.push_back(i);
+        break;
+      default:
+        m_coreAggregatorIds.push_back(i);
+        break;
+    }
   }
   
-  for (int i = 0; i < numRackAggregators; i++) {
-    m_rackAggregatorIds.push_back(m_nodeCount + i);
-  }
-  
-  for (int i = 0; i < numCoreAggregators; i++) {
-    m_coreAggregatorIds.push_back(m_nodeCount + numRackAggregators + i);
-  }
+  RegisterNodeRoles();
   
   // Set up network links
   PointToPointHelper p2p;
   p2p.SetChannelAttribute("Delay", StringValue("2ms"));
   p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
   
-  std::cout << "=== CREATING LINKS ===" << std::endl;
-  
-  // 1. Connect producer nodes to their rack aggregator (1:1 mapping)
-  for (int i = 0; i < numRacks; i++) {
-    int producerId = m_producerIds[i];
-    int rackAggregatorId = m_rackAggregatorIds[i];
-    
-    NodeContainer link(nodes.Get(producerId), nodes.Get(rackAggregatorId));
-    NetDeviceContainer devices = p2p.Install(link);
-    std::cout << "  Created link: Producer " << (i + 1) 
-              << " ←→ Rack Aggregator " << (i + 1) << std::endl;
-  }
-  
-  // 2. Connect rack aggregators to core aggregators (if applicable)
-  if (numCoreAggregators > 0) {
-    for (int i = 0; i < numRacks; i++) {
-      int rackAggregatorId = m_rackAggregatorIds[i];
-      int coreAggregatorId = m_coreAggregatorIds[i % numCoreAggregators];
-      
-      NodeContainer link(nodes.Get(rackAggregatorId), nodes.Get(coreAggregatorId));
-      NetDeviceContainer devices = p2p.Install(link);
-      std::cout << "  Created link: Rack Aggregator " << (i + 1) 
-                << " ←→ Core Aggregator " << ((i % numCoreAggregators) + 1) << std::endl;
-    }
+  if (isVerbose) {
+    std::cout << "=== CREATING LINKS ===" << std::endl;
   }
   
-  // 3. If multiple core aggregators, connect them in a ring
-  if (numCoreAggregators > 1) {
-    for (int i = 0; i < numCoreAggregators; i++) {
-      int j = (i + 1) % numCoreAggregators;
-      int coreId1 = m_coreAggregatorIds[i];
-      int coreId2 = m_coreAggregatorIds[j];
-      
-      NodeContainer link(nodes.Get(coreId1), nodes.Get(coreId2));
-      NetDeviceContainer devices = p2p.Install(link);
-      std::cout << "  Created link: Core Aggregator " << (i + 1) 
-                << " ←→ Core Aggregator " << (j + 1) << std::endl;
+  for (const auto& link : topology.getLinks()) {
+    p2p.Install(nodes.Get(link.first), nodes.Get(link.second));
+    if (isVerbose) {
+      std::cout << "  Created link: "
+                << AggregateUtils::getNodeRoleString(layout[link.first].role, link.first)
+                << " ←→ "
+                << AggregateUtils::getNodeRoleString(layout[link.second].role, link.second)
+                << std::endl;
     }
   }
   
   // Node index explanation
-  std::cout << "\n=== NODE INDEX MAPPING ===" << std::endl;
-  std::cout << "Producer/Consumer nodes:       Indices 0-" << (m_nodeCount-1)
-            << " (Logical IDs 1-" << m_nodeCount << ")" << std::endl;
-  std::cout << "Rack Aggregator nodes:         Indices " << m_nodeCount << "-" 
-            << (m_nodeCount+numRackAggregators-1) << std::endl;
-  std::cout << "Core Aggregator nodes:         Indices " << (m_nodeCount+numRackAggregators) << "-" 
-            << (totalNodes-1) << std::endl;
+  if (isVerbose && !m_producerIds.empty()) {
+    int firstSwitch = m_producerIds.size();
+    std::cout << "\n=== NODE INDEX MAPPING ===" << std::endl;
+    std::cout << "Producer/Consumer nodes:       Indices 0-" << (m_nodeCount-1)
+              << " (Logical IDs 1-" << m_nodeCount << ")" << std::endl;
+    std::cout << "Rack Aggregator nodes:         Indices " << firstSwitch << "-" 
+              << (firstSwitch + numRacks - 1) << std::endl;
+    std::cout << "Upper Aggregator nodes:        Indices " << (firstSwitch + numRacks) << "-" 
+              << (totalNodes-1) << std::endl;
+  }
   
   // Store the nodes
   m_nodes = nodes;
   return nodes;
 }
 
+void
+AggregateSimulationHelper::RegisterNodeRoles() const
+{
+  // Roles come from the layout, not from index ranges; logical IDs follow the ID lists
+  AggregateUtils::clearNodeRoles();
+  auto registerRole = [] (const std::vector<int>& indices, AggregateUtils::NodeRole role) {
+    for (size_t i = 0; i < indices.size(); ++i) {
+      AggregateUtils::registerNodeRole(indices[i], role, i + 1);
+    }
+  };
+  registerRole(m_producerIds, AggregateUtils::NodeRole::PRODUCER);
+  registerRole(m_rackAggregatorIds, AggregateUtils::NodeRole::RACK_AGG);
+  registerRole(m_podAggregatorIds, AggregateUtils::NodeRole::POD_AGG);
+  registerRole(m_coreAggregatorIds, AggregateUtils::NodeRole::CORE_AGG);
+}
+
 void 
 AggregateSimulationHelper::PrintTopologyDiagram() const
 {
@@ -193,6 +341,9 @@ AggregateSimulationHelper::InstallProducers(const NodeContainer& nodes)
   // Install consumer/producer applications
   for (int i = 0; i < m_producerIds.size(); ++i) {
     int nodeId = m_producerIds[i];
+    if (!IsLocal(nodes.Get(nodeId))) {
+      continue; // simulated by another rank
+    }
     
     // Create ValueProducer for each node
     ns3::ndn::AppHelper producerHelper("ns3::ndn::ValueProducer");
@@ -203,12 +354,15 @@ AggregateSimulationHelper::InstallProducers(const NodeContainer& nodes)
     producerHelper.SetAttribute("Freshness", TimeValue(Seconds(10.0)));
     
     // Construct a consumer prefix that includes all other node IDs
-    std::string consumerPrefix = "/aggregate";
+    // (IDs use the same encoding as InstallConsumers)
+    AggregateIdSet otherIds;
     for (int j = 1; j <= m_producerIds.size(); ++j) {
-        if (j == i + 1) continue; // Skip the local node's own ID
-        consumerPrefix += "/" + std::to_string(j);
+        if (j == i + 1 && !m_isAllReduce) continue; // Skip the local node's own ID
+        otherIds.insert(j);
     }
-    producerHelper.SetPrefix(consumerPrefix);
+    ::ndn::Name consumerPrefix("/aggregate");
+    AggregateUtils::appendIdSet(consumerPrefix, otherIds);
+    producerHelper.SetPrefix(consumerPrefix.toUri());
     
     // Install on the node
     producerHelper.Install(nodes.Get(nodeId));
@@ -241,9 +395,9 @@ AggregateSimulationHelper::ConfigureRouting(const NodeContainer& nodes)
     int nodeId = m_producerIds[i];
     int producerId = i + 1;  // 1-based ID
     
-    // Create the prefix with proper binary encoding
+    // Same encoding as the Interests for a single ID
     ::ndn::Name binName("/aggregate");
-    binName.appendNumber(producerId);
+    AggregateUtils::appendId(binName, producerId);
     
     // Add origin with the binary name
     ndnGlobalRoutingHelper.AddOrigin(binName.toUri(), nodes.Get(nodeId));
@@ -259,7 +413,7 @@ AggregateSimulationHelper::ConfigureRouting(const NodeContainer& nodes)
   
   // Calculate and install FIBs
   std::cout << "  Calculating and installing all possible routes..." << std::endl;
-  ndnGlobalRoutingHelper.CalculateAllPossibleRoutes();
+  ndnGlobalRoutingHelper.CalculateAllPossibleRoutesParallel();
   
   // IMPORTANT: Add a short delay for routes to propagate
   std::cout << "  Waiting for routes to propagate..." << std::endl;
@@ -275,16 +429,25 @@ AggregateSimulationHelper::InstallConsumers(const NodeContainer& nodes)
     for (int i = 0; i < m_producerIds.size(); ++i) {
         int nodeId = m_producerIds[i];
         Ptr<Node> node = nodes.Get(nodeId);
+        if (!IsLocal(node)) {
+            continue; // simulated by another rank
+        }
         
         // Use 1-based node IDs for consistency with original code
         int consumerId = i + 1;
         
-        // Build interest name containing all other node IDs
-        ::ndn::Name interestName("/aggregate");
+        // Build interest name containing all other node IDs (all IDs in allreduce mode)
+        // (one compact ID-set component unless IdEncoding::PER_COMPONENT is selected)
+        AggregateIdSet otherIds;
         for (int j = 0; j < m_producerIds.size(); ++j) {
             int otherId = j + 1;  // 1-based ID
-            if (otherId == consumerId) continue; // exclude itself
-            interestName.appendNumber(otherId);
+            if (otherId == consumerId && !m_isAllReduce) continue; // exclude itself
+            otherIds.insert(otherId);
+        }
+        ::ndn::Name interestName("/aggregate");
+        AggregateUtils::appendIdSet(interestName, otherIds);
+        if (m_operator != AggregateOpSpec()) {
+            interestName.append(m_operator.toComponent());
         }
         
         std::cout << "Node " << consumerId << " (index " << nodeId 
@@ -297,6 +460,10 @@ AggregateSimulationHelper::InstallConsumers(const NodeContainer& nodes)
         if (producer) {
             // Configure the consumer behavior by setting the prefix
             producer->SetAttribute("Prefix", NameValue(interestName));
+            producer->SetAttribute("RoundRate", DoubleValue(m_roundRate));
+            producer->SetAttribute("MaxRounds", UintegerValue(m_maxRounds));
+            producer->SetAttribute("MaxOutstandingRounds", UintegerValue(m_maxOutstandingRounds));
+            producer->SetAttribute("AllReduce", BooleanValue(m_isAllReduce));
             // Don't need to start it separately - StartApplication handles this when prefix is set
             std::cout << "  Configured ValueProducer on node " << consumerId 
                       << " to request: " << interestName.toUri() << std::endl;
@@ -313,8 +480,9 @@ AggregateSimulationHelper::InstallConsumers(const NodeContainer& nodes)
 bool 
 AggregateSimulationHelper::ShouldMonitorNode(ns3::ndn::AggregateUtils::NodeRole role)
 {
-  // Only monitor rack and core aggregator nodes
+  // Only monitor aggregator nodes
   return (role == ns3::ndn::AggregateUtils::NodeRole::RACK_AGG || 
+          role == ns3::ndn::AggregateUtils::NodeRole::POD_AGG ||
           role == ns3::ndn::AggregateUtils::NodeRole::CORE_AGG);
 }
 
@@ -322,8 +490,12 @@ void
 AggregateSimulationHelper::ProcessReceivedData(const ::ndn::Data& data, const std::string& roleString, 
                                               uint32_t faceId, Ptr<ns3::ndn::L3Protocol> ndnProtocol)
 {
-  std::cout << "\n!!! " << roleString << " RECEIVED DATA ON FACE " << faceId 
-            << ": " << data.getName() << std::endl;
+  // Walks the whole PIT for every received Data, so only when debug logging is on
+  if (!NDN_AGGREGATE_LOG_ENABLED(LOG_DEBUG)) {
+    return;
+  }
+
+  NS_LOG_DEBUG(roleString << " RECEIVED DATA ON FACE " << faceId << ": " << data.getName());
   
   if (!ndnProtocol) return;
   
@@ -332,33 +504,32 @@ AggregateSimulationHelper::ProcessReceivedData(const ::ndn::Data& data, const st
   
   const auto& pit = forwarder->getPit();
   
-  std::cout << "  === PIT STATE ON " << roleString << " ===" << std::endl;
-  std::cout << "  Total PIT entries: " << std::distance(pit.begin(), pit.end()) << std::endl;
+  NS_LOG_DEBUG("  === PIT STATE ON " << roleString << " ===");
+  NS_LOG_DEBUG("  Total PIT entries: " << pit.size());
   
   bool foundMatch = false;
   for (const auto& pitEntry : pit) {
-    std::cout << "    PIT entry: " << pitEntry.getName() 
-              << " (InFaces=" << pitEntry.getInRecords().size()
-              << ", OutFaces=" << pitEntry.getOutRecords().size() 
-              << ")" << std::endl;
+    NS_LOG_DEBUG("    PIT entry: " << pitEntry.getName() 
+                 << " (InFaces=" << pitEntry.getInRecords().size()
+                 << ", OutFaces=" << pitEntry.getOutRecords().size() 
+                 << ")");
               
     // Check if data name matches PIT entry name
     if (pitEntry.getName().isPrefixOf(data.getName()) || 
         pitEntry.getName() == data.getName()) {
       foundMatch = true;
-      std::cout << "    **** MATCH FOUND **** for data: " << data.getName() << std::endl;
-      
-      std::cout << "      In faces: ";
+      std::ostringstream inFaces;
       for (const auto& inRecord : pitEntry.getInRecords()) {
-        std::cout << inRecord.getFace().getId() << " ";
+        inFaces << inRecord.getFace().getId() << " ";
       }
-      std::cout << std::endl;
+      NS_LOG_DEBUG("    **** MATCH FOUND **** for data: " << data.getName());
+      NS_LOG_DEBUG("      In faces: " << inFaces.str());
     }
   }
   
   if (!foundMatch) {
-    std::cout << "    **** NO MATCHING PIT ENTRY **** for data: " << data.getName() << std::endl;
-    std::cout << "    This data will be dropped by the forwarder" << std::endl;
+    NS_LOG_DEBUG("    **** NO MATCHING PIT ENTRY **** for data: " << data.getName());
+    NS_LOG_DEBUG("    This data will be dropped by the forwarder");
   }
 }
 
@@ -411,6 +582,10 @@ AggregateSimulationHelper::SetupDataMonitoring()
   std::cout << "\n=== ENABLING DATA PACKET MONITORING ===" << std::endl;
   
   for (uint32_t i = 0; i < m_nodes.GetN(); ++i) {
+    if (!IsLocal(m_nodes.Get(i))) {
+      continue;
+    }
+
     // Determine node role using the utility class
     auto role = ns3::ndn::AggregateUtils::determineNodeRole(i);
     
@@ -432,13 +607,13 @@ AggregateSimulationHelper::SetupDataMonitoring()
 void
 AggregateSimulationHelper::MacTxTrace(std::string context, Ptr<const Packet> packet)
 {
-  std::cout << "MAC TX: " << context << " size=" << packet->GetSize() << std::endl;
+  NS_LOG_DEBUG("MAC TX: " << context << " size=" << packet->GetSize());
 }
 
 void
 AggregateSimulationHelper::MacRxTrace(std::string context, Ptr<const Packet> packet)
 {
-  std::cout << "MAC RX: " << context << " size=" << packet->GetSize() << std::endl;
+  NS_LOG_DEBUG("MAC RX: " << context << " size=" << packet->GetSize());
 }
 
 void 
@@ -460,11 +635,32 @@ AggregateSimulationHelper::InstallStrategy()
 {
   // Get the exact strategy name with version
   ::ndn::Name strategyName = nfd::fw::AggregateStrategy::getStrategyName();
+  if (m_isMultipath) {
+    strategyName.append("multipath~on");
+  }
+  if (m_deadline.IsStrictlyPositive()) {
+    strategyName.append("deadline~" + std::to_string(m_deadline.GetMilliSeconds()));
+    strategyName.append("deadline-margin~" + std::to_string(m_deadlineMargin.GetMilliSeconds()));
+  }
+  if (m_maxRetx > 0) {
+    strategyName.append("retx~" + std::to_string(m_maxRetx));
+  }
+  if (m_hasCacheLimits) {
+    strategyName.append("cache-size~" + std::to_string(m_cacheCapacity));
+    strategyName.append("cache-ttl~" + std::to_string(m_cacheTtl.GetMilliSeconds()));
+  }
   std::cout << "\n=== INSTALLING STRATEGY ===" << std::endl;
   std::cout << "Strategy name from class: " << strategyName << std::endl;
 
   // Install with the exact name including version
   ns3::ndn::StrategyChoiceHelper::InstallAll("/aggregate", strategyName.toUri());
+  if (m_isAllReduce && m_treeLevels == 0) {
+    // Identical requests only meet if they climb the same tree
+    m_treeLevels = 2;
+  }
+  if (m_treeLevels > 0) {
+    InstallAggregationTree();
+  }
 
   // Then install for specific prefixes with the same exact name
   // for (int i = 1; i <= m_nodeCount; i++) {
@@ -475,6 +671,88 @@ AggregateSimulationHelper::InstallStrategy()
   // }
 }
 
+void
+AggregateSimulationHelper::InstallAggregationTree()
+{
+  AggregateTreePlanner planner(m_treeFanIn, m_treeLevels, m_treeObjective);
+  for (uint32_t i = 0; i < m_nodes.GetN(); ++i) {
+    Ptr<Node> node = m_nodes.Get(i);
+    for (uint32_t d = 0; d < node->GetNDevices(); ++d) {
+      Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+      for (std::size_t c = 0; channel != nullptr && c < channel->GetNDevices(); ++c) {
+        uint32_t peer = channel->GetDevice(c)->GetNode()->GetId();
+        if (peer > node->GetId()) {
+          planner.addLink(node->GetId(), peer);
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < m_producerIds.size(); ++i) {
+    planner.addProducer(m_nodes.Get(m_producerIds[i])->GetId(), static_cast<int>(i + 1));
+  }
+  for (int index : m_rackAggregatorIds) {
+    planner.addCandidate(m_nodes.Get(index)->GetId());
+  }
+  for (int index : m_podAggregatorIds) {
+    planner.addCandidate(m_nodes.Get(index)->GetId());
+  }
+  for (int index : m_coreAggregatorIds) {
+    planner.addCandidate(m_nodes.Get(index)->GetId());
+  }
+  if (!planner.plan()) {
+    NS_FATAL_ERROR("Cannot plan an aggregation tree: some producer reaches no aggregator");
+  }
+
+  std::cout << "\n=== AGGREGATION TREE ===" << std::endl
+            << "  Root: node " << planner.getRoot() << ", " << planner.getLevelCount()
+            << " level(s), fan-in " << m_treeFanIn << std::endl;
+
+  for (const auto& entry : planner.getRules()) {
+    Ptr<Node> node = NodeList::GetNode(entry.first);
+    Ptr<L3Protocol> l3 = node->GetObject<L3Protocol>();
+    NS_ASSERT_MSG(l3 != nullptr, "Install the NDN stack before the aggregation tree");
+
+    // Neighbor node index -> face of the link toward it
+    auto getFaceToward = [&] (uint32_t neighbor) {
+      for (uint32_t d = 0; d < node->GetNDevices(); ++d) {
+        Ptr<NetDevice> device = node->GetDevice(d);
+        Ptr<Channel> channel = device->GetChannel();
+        for (std::size_t c = 0; channel != nullptr && c < channel->GetNDevices(); ++c) {
+          if (channel->GetDevice(c)->GetNode()->GetId() == neighbor) {
+            auto face = l3->getFaceByNetDevice(device);
+            return face == nullptr ? nfd::face::INVALID_FACEID : face->getId();
+          }
+        }
+      }
+      return nfd::face::INVALID_FACEID;
+    };
+
+    const AggregateTreePlanner::NodeRule& planned = entry.second;
+    nfd::fw::AggregateStrategy::AggregationRule rule;
+    rule.subtreeIds = planned.subtreeIds;
+    for (const auto& child : planned.children) {
+      rule.children.emplace_back(getFaceToward(child.first), child.second);
+    }
+    for (const auto& upward : planned.upward) {
+      rule.upward[getFaceToward(upward.first)] = getFaceToward(upward.second);
+    }
+    if (planned.hasParent) {
+      rule.defaultUpward = getFaceToward(planned.defaultUpward);
+    }
+
+    auto& strategy = l3->getForwarder()->getStrategyChoice().findEffectiveStrategy(::ndn::Name("/aggregate"));
+    auto aggregateStrategy = dynamic_cast<nfd::fw::AggregateStrategy*>(&strategy);
+    NS_ASSERT_MSG(aggregateStrategy != nullptr, "AggregateStrategy is not installed for /aggregate");
+    aggregateStrategy->setAggregationRule(std::move(rule));
+
+    if (planned.level > 0) {
+      std::cout << "  Node " << entry.first << ": level " << planned.level << ", "
+                << planned.children.size() << " child link(s), subtree "
+                << planned.subtreeIds << std::endl;
+    }
+  }
+}
+
 void
 AggregateSimulationHelper::VerifyStrategyInstallation(const NodeContainer& nodes)
 {
@@ -491,7 +769,7 @@ AggregateSimulationHelper::VerifyStrategyInstallation(const NodeContainer& nodes
     for (int i = 0; i <= m_nodeCount; i++) {
       ::ndn::Name prefix("/aggregate");
       if (i > 0) {
-        prefix.appendNumber(i);
+        AggregateUtils::appendId(prefix, i);
       }
       // Retrieve the effective strategy (returns a reference)
       const nfd::fw::Strategy& strategy = strategyChoice.findEffectiveStrategy(prefix);
@@ -509,6 +787,9 @@ AggregateSimulationHelper::VerifyFibEntries(const NodeContainer& nodes)
   
   for (int i = 0; i < m_nodeCount; i++) {
     Ptr<Node> node = nodes.Get(i);
+    if (!IsLocal(node)) {
+      continue;
+    }
     Ptr<ns3::ndn::ValueProducer> app = DynamicCast<ns3::ndn::ValueProducer>(node->GetApplication(0));
     if (app) {
       app->PrintFibState("Initial FIB state");
@@ -527,13 +808,64 @@ AggregateSimulationHelper::InstallTracers(const std::string& tracePath)
     NS_LOG_ERROR("Failed to create directory: " << tracePath);
   }
   
-  // Install tracers
-  ns3::ndn::L3RateTracer::InstallAll(tracePath + "rate-trace.txt", Seconds(0.1));
-  ns3::ndn::CsTracer::InstallAll(tracePath + "cs-trace.txt", Seconds(0.5));
-  ns3::ndn::AppDelayTracer::InstallAll(tracePath + "app-delays-trace.txt");
+  // Install tracers (on this rank's nodes only, each rank has its own files)
+  NodeContainer localNodes = GetLocalNodes(m_nodes);
+  ns3::ndn::L3RateTracer::Install(localNodes, GetRankPath(tracePath + "rate-trace.txt"), Seconds(0.1));
+  ns3::ndn::CsTracer::Install(localNodes, GetRankPath(tracePath + "cs-trace.txt"), Seconds(0.5));
+  ns3::ndn::AppDelayTracer::Install(localNodes, GetRankPath(tracePath + "app-delays-trace.txt"));
   
   std::cout << "Tracers installed in " << tracePath << std::endl;
 }
 
+void
+AggregateSimulationHelper::EnableEventLog(const std::string& path, uint32_t mask)
+{
+  std::string rankPath = GetRankPath(path);
+  auto os = std::make_shared<std::ofstream>(rankPath);
+  if (!os->is_open()) {
+    NS_LOG_ERROR("Failed to open event log: " << rankPath);
+    return;
+  }
+  *os << "Time\tNode\tEvent\tName\tFace\tIds\n";
+
+  AggregateEventSink::getInstance().setCallback([os] (const AggregateEvent& event) {
+    AggregateEventSink::writeTsv(*os, event);
+  }, mask);
+  std::cout << "Aggregation events logged to " << rankPath << std::endl;
+}
+
+bool
+AggregateSimulationHelper::IsLocal(Ptr<Node> node) const
+{
+  return m_systemCount == 1 || node->GetSystemId() == m_systemId;
+}
+
+NodeContainer
+AggregateSimulationHelper::GetLocalNodes(const NodeContainer& nodes) const
+{
+  NodeContainer localNodes;
+  for (auto node = nodes.Begin(); node != nodes.End(); ++node) {
+    if (IsLocal(*node)) {
+      localNodes.Add(*node);
+    }
+  }
+  return localNodes;
+}
+
+std::string
+AggregateSimulationHelper::GetRankPath(const std::string& path) const
+{
+  if (m_systemCount == 1) {
+    return path;
+  }
+  std::string suffix = ".rank" + std::to_string(m_systemId);
+  size_t slash = path.find_last_of('/');
+  size_t dot = path.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return path + suffix;
+  }
+  return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
 } // namespace ndn
 } // namespace ns3
\ No newline at end of file
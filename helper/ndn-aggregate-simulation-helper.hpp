@@ -15,6 +15,11 @@
 // Include the utility class
 #include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
 
+#include "ndn-aggregate-topology.hpp"
+#include "ndn-aggregate-tree-planner.hpp"
+
+#include <optional>
+
 namespace ns3 {
 namespace ndn {
 
@@ -37,6 +42,145 @@ public:
    * @brief Set number of producer-consumer nodes
    */
   void SetNodeCount(int count);
+
+  /**
+   * @brief Set how many rack aggregators share one core aggregator (default: 4)
+   */
+  void SetFanIn(int racksPerCore);
+
+  /**
+   * @brief Build a k-ary fat-tree instead of the default rack/core layout
+   *
+   * Edge switches act as rack aggregators, the aggregation switches of the pods as
+   * pod aggregators and the (k/2)^2 core switches as core aggregators. Overrides
+   * SetNodeCount and SetFanIn; the node count becomes the number of hosts.
+   *
+   * @param k Even switch port count
+   * @param hostsPerRack Hosts under each edge switch, 0 for k/2
+   */
+  void SetFatTree(uint32_t k, uint32_t hostsPerRack = 0);
+
+  /**
+   * @brief Build a leaf-spine fabric: every leaf (rack) switch connects to every spine
+   */
+  void SetLeafSpine(uint32_t leafCount, uint32_t spineCount, uint32_t hostsPerRack = 1);
+
+  /**
+   * @brief Build a complete d-ary tree of switches with degree^(levels - 1) racks
+   */
+  void SetTreeTopology(uint32_t degree, uint32_t levels, uint32_t hostsPerRack = 1);
+
+  /**
+   * @brief Select how multi-ID aggregate names are encoded (default: compact)
+   */
+  void SetIdEncoding(AggregateUtils::IdEncoding encoding);
+
+  /**
+   * @brief Select how aggregation Data are signed (default: KeyChain)
+   *
+   * Applies to intermediate aggregates and producer values alike.
+   */
+  void SetSigningPolicy(AggregateSigningPolicy policy);
+
+  /**
+   * @brief Set the aggregation operator requested by consumers (default: SUM)
+   *
+   * Anything but scalar SUM is carried as an "op=" component in the consumer names.
+   */
+  void SetOperator(const AggregateOpSpec& spec);
+
+  /**
+   * @brief Make consumers issue rounds periodically instead of once (default: one round)
+   * @param roundsPerSecond Round rate of each consumer, 0 for a single round
+   * @param maxRounds Rounds per consumer, 0 for unlimited
+   * @param maxOutstanding Rounds a consumer may have in flight at once
+   */
+  void SetRoundSchedule(double roundsPerSecond, uint32_t maxRounds, uint32_t maxOutstanding);
+
+  /**
+   * @brief Spread sub-Interests over equal-cost next hops (default: off)
+   *
+   * Each sub-Interest carries a disjoint ID subset; subsets are sized by the measured
+   * RTT and send-queue backlog of each path. Takes effect in InstallStrategy.
+   */
+  void SetMultipath(bool isEnabled);
+
+  /**
+   * @brief Let aggregators reply with a partial aggregate when a deadline passes (default: off)
+   *
+   * Each aggregator waits at most @p deadline for its upstream and then replies with what
+   * it has plus the IDs that are missing. It gives its own upstream @p margin less time,
+   * so that partial replies arrive before the downstream deadline. Takes effect in
+   * InstallStrategy.
+   *
+   * @param deadline Per-hop deadline, 0 to disable
+   * @param margin Time reserved on each hop for the reply to travel back
+   */
+  void SetDeadline(Time deadline, Time margin = MilliSeconds(2));
+
+  /**
+   * @brief Retransmit unanswered sub-Interests after an RTO (default: 0, never)
+   *
+   * The RTO comes from a per-face RttMeanDeviation estimator (see the
+   * ns3::ndn::RttEstimator attributes for its bounds). A retry asks only for the IDs
+   * that are still pending. Takes effect in InstallStrategy.
+   *
+   * @param maxRetx Retransmissions per sub-Interest
+   */
+  void SetRetransmission(uint32_t maxRetx);
+
+  /**
+   * @brief Bound the per-node cache of samples and partial aggregates
+   *
+   * Without this call the strategy keeps up to 4096 entries for 1 s each.
+   * Takes effect in InstallStrategy.
+   *
+   * @param capacity Maximum number of cached entries (0 disables caching)
+   * @param ttl Lifetime of a cached entry
+   */
+  void SetValueCache(uint32_t capacity, Time ttl);
+
+  /**
+   * @brief Aggregate along a static tree planned from the topology (default: off)
+   *
+   * AggregateTreePlanner builds the tree over rack and core aggregators once; every
+   * node then sends each ID toward the child that aggregates it, or toward its tree
+   * parent, instead of splitting per ID along FIB routes. IDs the plan cannot place
+   * fall back to the FIB. Takes effect in InstallStrategy.
+   *
+   * @param fanIn Maximum children per aggregator below the root
+   * @param levels Maximum aggregation levels above the producers, 0 to disable
+   * @param objective What parent selection minimises
+   */
+  void SetAggregationTree(uint32_t fanIn, uint32_t levels,
+                          AggregateTreePlanner::Objective objective =
+                            AggregateTreePlanner::Objective::LATENCY);
+  
+  /**
+   * @brief Let every node request one global aggregate instead of the sum of all others
+   *
+   * All consumers ask for the same ID set of a round, so the network coalesces their
+   * Interests and multicasts a single result back down; each node takes its own value
+   * out of the result when the operator is invertible. Without SetAggregationTree the
+   * requests climb a two-level tree with the default fan-in. Affects InstallProducers,
+   * InstallConsumers and InstallStrategy.
+   */
+  void SetAllReduce(bool isEnabled);
+
+  /**
+   * @brief Split the topology over the ranks of a distributed (MPI) simulation
+   *
+   * Racks (the producers with their rack aggregator) are assigned to ranks in contiguous
+   * blocks and the switches above them round-robin, so links between ranks are the rack
+   * uplinks and the links between upper switches. Every rank builds the full topology,
+   * stack, strategy and routes, but installs applications, monitoring and tracers only on
+   * its own nodes and writes its files with a ".rank<id>" suffix. Call before any other
+   * setup.
+   *
+   * @param systemCount Number of ranks (MpiInterface::GetSize())
+   * @param systemId Rank of this process (MpiInterface::GetSystemId())
+   */
+  void SetPartitions(uint32_t systemCount, uint32_t systemId);
   
   /**
    * @brief Create the topology with all nodes
@@ -110,12 +254,39 @@ public:
    */
   void InstallTracers(const std::string& tracePath);
 
+  /**
+   * @brief Write aggregation events to a tab-separated file
+   * @param path Output file; one line per event (time, node, event, name, face, IDs)
+   * @param mask Event types to record, see AggregateEventSink::parseMask
+   */
+  void EnableEventLog(const std::string& path, uint32_t mask = AggregateEventSink::ALL_EVENTS);
+
 private:
   // Topology variables
   int m_nodeCount;
+  int m_fanIn;
+  AggregateOpSpec m_operator;
+  double m_roundRate;
+  uint32_t m_maxRounds;
+  uint32_t m_maxOutstandingRounds;
+  bool m_isMultipath;
+  Time m_deadline;
+  Time m_deadlineMargin;
+  uint32_t m_maxRetx;
+  bool m_hasCacheLimits;
+  uint32_t m_cacheCapacity;
+  Time m_cacheTtl;
+  uint32_t m_treeFanIn;
+  uint32_t m_treeLevels;
+  AggregateTreePlanner::Objective m_treeObjective;
+  bool m_isAllReduce;
+  uint32_t m_systemCount;
+  uint32_t m_systemId;
   std::vector<int> m_producerIds;
   std::vector<int> m_rackAggregatorIds;
   std::vector<int> m_coreAggregatorIds;
+  std::vector<int> m_podAggregatorIds;
+  std::optional<AggregateTopology> m_topology;
   NodeContainer m_nodes;
   
   // Monitoring helpers
@@ -125,6 +296,21 @@ private:
   void SetupFaceMonitoring(const nfd::Face& face, Ptr<ns3::ndn::L3Protocol> ndnProtocol,
                           uint32_t nodeId, const std::string& roleString);
   void SetupNodeMonitoring(Ptr<Node> node, uint32_t nodeIndex, const std::string& roleString);
+
+  // Plan the static aggregation tree and hand each node's rule to its strategy
+  void InstallAggregationTree();
+
+  // Whether this rank simulates the node (always true without partitions)
+  bool IsLocal(Ptr<Node> node) const;
+
+  // Nodes of this rank among @p nodes
+  NodeContainer GetLocalNodes(const NodeContainer& nodes) const;
+
+  // @p path with this rank's suffix before the extension, unchanged without partitions
+  std::string GetRankPath(const std::string& path) const;
+
+  // Fill the AggregateUtils role table from the node ID lists
+  void RegisterNodeRoles() const;
   
   // Trace callback functions
   static void MacTxTrace(std::string context, Ptr<const Packet> packet);
@@ -0,0 +1,128 @@
+#include "ndn-aggregate-topology.hpp"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+AggregateTopology
+AggregateTopology::makeRacks(uint32_t nodeCount, uint32_t fanIn)
+{
+  AggregateTopology topology;
+  uint32_t racks = topology.addRacks(nodeCount, 1);
+  uint32_t coreCount = nodeCount > 1 ? std::max(1u, nodeCount / std::max(1u, fanIn)) : 0;
+  uint32_t cores = topology.addNodes(coreCount, NodeRole::CORE_AGG);
+
+  for (uint32_t i = 0; coreCount > 0 && i < nodeCount; ++i) {
+    topology.addLink(racks + i, cores + i % coreCount);
+  }
+  // Cores form a ring (two parallel links for two cores)
+  for (uint32_t i = 0; coreCount > 1 && i < coreCount; ++i) {
+    topology.addLink(cores + i, cores + (i + 1) % coreCount);
+  }
+  return topology;
+}
+
+AggregateTopology
+AggregateTopology::makeFatTree(uint32_t k, uint32_t hostsPerRack)
+{
+  k = std::max(2u, k - k % 2);
+  uint32_t half = k / 2;
+  AggregateTopology topology;
+  uint32_t edges = topology.addRacks(k * half, hostsPerRack == 0 ? half : hostsPerRack);
+  uint32_t aggregations = topology.addNodes(k * half, NodeRole::POD_AGG);
+  uint32_t cores = topology.addNodes(half * half, NodeRole::CORE_AGG);
+
+  for (uint32_t pod = 0; pod < k; ++pod) {
+    for (uint32_t a = 0; a < half; ++a) {
+      for (uint32_t e = 0; e < half; ++e) {
+        topology.addLink(edges + pod * half + e, aggregations + pod * half + a);
+      }
+    }
+  }
+  for (uint32_t pod = 0; pod < k; ++pod) {
+    for (uint32_t a = 0; a < half; ++a) {
+      for (uint32_t c = 0; c < half; ++c) {
+        topology.addLink(aggregations + pod * half + a, cores + a * half + c);
+      }
+    }
+  }
+  return topology;
+}
+
+AggregateTopology
+AggregateTopology::makeLeafSpine(uint32_t leafCount, uint32_t spineCount, uint32_t hostsPerRack)
+{
+  AggregateTopology topology;
+  uint32_t leaves = topology.addRacks(std::max(1u, leafCount), std::max(1u, hostsPerRack));
+  uint32_t spines = topology.addNodes(spineCount, NodeRole::CORE_AGG);
+
+  for (uint32_t l = 0; l < std::max(1u, leafCount); ++l) {
+    for (uint32_t s = 0; s < spineCount; ++s) {
+      topology.addLink(leaves + l, spines + s);
+    }
+  }
+  return topology;
+}
+
+AggregateTopology
+AggregateTopology::makeTree(uint32_t degree, uint32_t levels, uint32_t hostsPerRack)
+{
+  degree = std::max(1u, degree);
+  levels = std::max(1u, levels);
+  uint32_t rackCount = 1;
+  for (uint32_t level = 1; level < levels; ++level) {
+    rackCount *= degree;
+  }
+
+  AggregateTopology topology;
+  uint32_t children = topology.addRacks(rackCount, std::max(1u, hostsPerRack));
+  uint32_t childCount = rackCount;
+  for (uint32_t level = 2; level <= levels; ++level) {
+    uint32_t parentCount = childCount / degree;
+    uint32_t parents = topology.addNodes(parentCount, level == levels ? NodeRole::CORE_AGG :
+                                                                        NodeRole::POD_AGG);
+    for (uint32_t i = 0; i < childCount; ++i) {
+      topology.addLink(children + i, parents + i / degree);
+    }
+    children = parents;
+    childCount = parentCount;
+  }
+  return topology;
+}
+
+uint32_t
+AggregateTopology::count(NodeRole role) const
+{
+  return static_cast<uint32_t>(std::count_if(m_nodes.begin(), m_nodes.end(), [role] (const Node& node) {
+    return node.role == role;
+  }));
+}
+
+uint32_t
+AggregateTopology::addNodes(uint32_t n, NodeRole role)
+{
+  uint32_t first = static_cast<uint32_t>(m_nodes.size());
+  m_nodes.insert(m_nodes.end(), n, Node{role, -1});
+  return first;
+}
+
+uint32_t
+AggregateTopology::addRacks(uint32_t rackCount, uint32_t hostsPerRack)
+{
+  uint32_t hosts = static_cast<uint32_t>(m_nodes.size());
+  for (uint32_t i = 0; i < rackCount * hostsPerRack; ++i) {
+    m_nodes.push_back(Node{NodeRole::PRODUCER, static_cast<int>(i / hostsPerRack)});
+  }
+  uint32_t racks = static_cast<uint32_t>(m_nodes.size());
+  for (uint32_t i = 0; i < rackCount; ++i) {
+    m_nodes.push_back(Node{NodeRole::RACK_AGG, static_cast<int>(i)});
+  }
+  for (uint32_t i = 0; i < rackCount * hostsPerRack; ++i) {
+    addLink(hosts + i, racks + i / hostsPerRack);
+  }
+  return racks;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,117 @@
+#ifndef NDN_AGGREGATE_TOPOLOGY_HPP
+#define NDN_AGGREGATE_TOPOLOGY_HPP
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Abstract layout of an aggregation topology: node roles and links
+ *
+ * Every generator lists the hosts (producers) first, then the rack-level switches,
+ * then the layers above them, so node index i + 1 is the producer ID of host i. A node
+ * that belongs to a rack (a host or its rack switch) carries the index of that rack,
+ * which is what partitioning over MPI ranks keeps together.
+ */
+class AggregateTopology
+{
+public:
+  using NodeRole = AggregateUtils::NodeRole;
+
+  struct Node
+  {
+    NodeRole role;
+    int rack; ///< index of the rack, -1 above the rack switches
+  };
+
+  /**
+   * @brief One host per rack, racks spread over fanIn-sized groups of cores in a ring
+   *
+   * The shape AggregateSimulationHelper has always built: nodeCount racks and
+   * max(1, nodeCount / fanIn) core aggregators (none for a single rack).
+   */
+  static AggregateTopology
+  makeRacks(uint32_t nodeCount, uint32_t fanIn);
+
+  /**
+   * @brief k-ary fat-tree: k pods of k/2 edge (rack) and k/2 aggregation switches,
+   * and (k/2)^2 core switches
+   *
+   * Aggregation switch a of every pod connects to cores a*k/2 ... a*k/2 + k/2 - 1.
+   *
+   * @param k Even switch port count, at least 2
+   * @param hostsPerRack Hosts per edge switch, 0 for k/2
+   */
+  static AggregateTopology
+  makeFatTree(uint32_t k, uint32_t hostsPerRack = 0);
+
+  /**
+   * @brief Two-tier leaf-spine: every leaf (rack) switch connects to every spine
+   */
+  static AggregateTopology
+  makeLeafSpine(uint32_t leafCount, uint32_t spineCount, uint32_t hostsPerRack);
+
+  /**
+   * @brief Complete d-ary tree of switches with racks as its leaves
+   *
+   * Level 1 holds degree^(levels - 1) rack switches, each level above has degree
+   * times fewer switches, and level @p levels is the single root.
+   */
+  static AggregateTopology
+  makeTree(uint32_t degree, uint32_t levels, uint32_t hostsPerRack);
+
+  const std::vector<Node>&
+  getNodes() const
+  {
+    return m_nodes;
+  }
+
+  /**
+   * @return Links as pairs of node indices, in installation order
+   */
+  const std::vector<std::pair<uint32_t, uint32_t>>&
+  getLinks() const
+  {
+    return m_links;
+  }
+
+  /**
+   * @return Number of nodes with role @p role
+   */
+  uint32_t
+  count(NodeRole role) const;
+
+private:
+  /**
+   * @brief Add @p n nodes of role @p role above the racks
+   * @return Index of the first added node
+   */
+  uint32_t
+  addNodes(uint32_t n, NodeRole role);
+
+  /**
+   * @brief Add @p hostsPerRack hosts per rack and the rack switches, linked together
+   * @return Index of the first rack switch
+   */
+  uint32_t
+  addRacks(uint32_t rackCount, uint32_t hostsPerRack);
+
+  void
+  addLink(uint32_t a, uint32_t b)
+  {
+    m_links.emplace_back(a, b);
+  }
+
+private:
+  std::vector<Node> m_nodes;
+  std::vector<std::pair<uint32_t, uint32_t>> m_links;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_AGGREGATE_TOPOLOGY_HPP
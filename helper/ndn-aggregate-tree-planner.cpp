@@ -0,0 +1,307 @@
+#include "ndn-aggregate-tree-planner.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <tuple>
+
+namespace ns3 {
+namespace ndn {
+
+AggregateTreePlanner::AggregateTreePlanner(uint32_t fanIn, uint32_t levels, Objective objective)
+  : m_fanIn(std::max(2u, fanIn))
+  , m_levels(std::max(1u, levels))
+  , m_objective(objective)
+{
+}
+
+void
+AggregateTreePlanner::addLink(uint32_t a, uint32_t b)
+{
+  ensureNode(std::max(a, b));
+  m_adjacency[a].push_back(b);
+  m_adjacency[b].push_back(a);
+  m_distances.clear();
+}
+
+void
+AggregateTreePlanner::addProducer(uint32_t node, int id)
+{
+  ensureNode(node);
+  m_producers.emplace_back(id, node);
+}
+
+void
+AggregateTreePlanner::addCandidate(uint32_t node)
+{
+  ensureNode(node);
+  m_candidates.push_back(node);
+}
+
+bool
+AggregateTreePlanner::parseObjective(const std::string& text, Objective& objective)
+{
+  if (text == "latency") {
+    objective = Objective::LATENCY;
+  }
+  else if (text == "link-load") {
+    objective = Objective::LINK_LOAD;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+bool
+AggregateTreePlanner::plan()
+{
+  m_vertices.clear();
+  m_parentLoad.clear();
+  m_rules.clear();
+  m_levelCount = 0;
+  if (m_producers.empty()) {
+    return false;
+  }
+
+  // Neighbor lists in index order make every tie-break below deterministic
+  for (auto& neighbors : m_adjacency) {
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  }
+  m_aggregators = m_candidates;
+  if (m_aggregators.empty()) {
+    std::vector<bool> isProducer(m_adjacency.size(), false);
+    for (const auto& producer : m_producers) {
+      isProducer[producer.second] = true;
+    }
+    for (uint32_t node = 0; node < m_adjacency.size(); ++node) {
+      if (!isProducer[node]) {
+        m_aggregators.push_back(node);
+      }
+    }
+  }
+  std::sort(m_aggregators.begin(), m_aggregators.end());
+  m_aggregators.erase(std::unique(m_aggregators.begin(), m_aggregators.end()), m_aggregators.end());
+  std::sort(m_producers.begin(), m_producers.end());
+
+  std::vector<size_t> frontier;
+  for (const auto& producer : m_producers) {
+    frontier.push_back(m_vertices.size());
+    m_vertices.push_back(Vertex{producer.second, AggregateIdSet{producer.first}, 0, -1});
+  }
+
+  for (uint32_t level = 1; level <= m_levels && frontier.size() > 1; ++level) {
+    std::vector<std::vector<size_t>> groups;
+    if (level == m_levels || frontier.size() <= m_fanIn) {
+      groups.push_back(frontier);
+    }
+    else {
+      groups = cluster(frontier);
+    }
+
+    // A node parents at most one group per level, unless no other candidate is left
+    std::vector<bool> isUsed(m_adjacency.size(), false);
+    std::vector<size_t> nextFrontier;
+    for (const auto& group : groups) {
+      int64_t parent = pickParent(group, isUsed);
+      if (parent < 0) {
+        return false;
+      }
+      isUsed[parent] = true;
+      ++m_parentLoad[parent];
+
+      Vertex vertex{static_cast<uint32_t>(parent), AggregateIdSet(), level, -1};
+      for (size_t child : group) {
+        vertex.ids.unionWith(m_vertices[child].ids);
+        m_vertices[child].parent = static_cast<int>(m_vertices.size());
+      }
+      nextFrontier.push_back(m_vertices.size());
+      m_vertices.push_back(std::move(vertex));
+    }
+    frontier = std::move(nextFrontier);
+    m_levelCount = level;
+  }
+
+  m_root = m_vertices[frontier.front()].node;
+  buildRules();
+  return true;
+}
+
+const std::vector<int>&
+AggregateTreePlanner::getDistances(uint32_t node)
+{
+  auto it = m_distances.find(node);
+  if (it != m_distances.end()) {
+    return it->second;
+  }
+
+  std::vector<int> distances(m_adjacency.size(), -1);
+  std::deque<uint32_t> queue{node};
+  distances[node] = 0;
+  while (!queue.empty()) {
+    uint32_t current = queue.front();
+    queue.pop_front();
+    for (uint32_t neighbor : m_adjacency[current]) {
+      if (distances[neighbor] < 0) {
+        distances[neighbor] = distances[current] + 1;
+        queue.push_back(neighbor);
+      }
+    }
+  }
+  return m_distances.emplace(node, std::move(distances)).first->second;
+}
+
+std::vector<std::vector<size_t>>
+AggregateTreePlanner::cluster(const std::vector<size_t>& frontier)
+{
+  // Greedy: the first unassigned vertex takes its fan-in - 1 nearest unassigned peers
+  std::vector<std::vector<size_t>> groups;
+  std::vector<bool> isAssigned(frontier.size(), false);
+  for (size_t seed = 0; seed < frontier.size(); ++seed) {
+    if (isAssigned[seed]) {
+      continue;
+    }
+    isAssigned[seed] = true;
+    const std::vector<int>& distances = getDistances(m_vertices[frontier[seed]].node);
+
+    std::vector<std::pair<int, size_t>> peers;
+    for (size_t i = seed + 1; i < frontier.size(); ++i) {
+      int distance = distances[m_vertices[frontier[i]].node];
+      if (!isAssigned[i] && distance >= 0) {
+        peers.emplace_back(distance, i);
+      }
+    }
+    std::sort(peers.begin(), peers.end());
+
+    std::vector<size_t> group{frontier[seed]};
+    for (size_t i = 0; i < peers.size() && group.size() < m_fanIn; ++i) {
+      isAssigned[peers[i].second] = true;
+      group.push_back(frontier[peers[i].second]);
+    }
+    groups.push_back(std::move(group));
+  }
+  return groups;
+}
+
+int64_t
+AggregateTreePlanner::pickParent(const std::vector<size_t>& group, const std::vector<bool>& isUsed)
+{
+  int64_t best = -1;
+  std::tuple<int, int, size_t> bestKey;
+  for (int pass = 0; pass < 2 && best < 0; ++pass) {
+    for (uint32_t node : m_aggregators) {
+      if (pass == 0 && isUsed[node]) {
+        continue;
+      }
+
+      const std::vector<int>& distances = getDistances(node);
+      int maxHops = 0;
+      int totalHops = 0;
+      bool isReachable = true;
+      for (size_t child : group) {
+        int hops = distances[m_vertices[child].node];
+        if (hops < 0) {
+          isReachable = false;
+          break;
+        }
+        maxHops = std::max(maxHops, hops);
+        totalHops += hops;
+      }
+      if (!isReachable) {
+        continue;
+      }
+
+      auto loadIt = m_parentLoad.find(node);
+      size_t load = loadIt == m_parentLoad.end() ? 0 : loadIt->second;
+      auto key = m_objective == Objective::LATENCY ? std::make_tuple(maxHops, totalHops, load) :
+                                                     std::make_tuple(totalHops, maxHops, load);
+      if (best < 0 || key < bestKey) {
+        best = node;
+        bestKey = key;
+      }
+    }
+  }
+  return best;
+}
+
+std::vector<uint32_t>
+AggregateTreePlanner::getPath(uint32_t from, uint32_t to)
+{
+  const std::vector<int>& distances = getDistances(to);
+  std::vector<uint32_t> path{from};
+  while (path.back() != to) {
+    uint32_t current = path.back();
+    for (uint32_t neighbor : m_adjacency[current]) {
+      if (distances[neighbor] == distances[current] - 1) {
+        path.push_back(neighbor);
+        break;
+      }
+    }
+  }
+  return path;
+}
+
+void
+AggregateTreePlanner::buildRules()
+{
+  // Vertices are stored level by level, so the edge out of a node's topmost vertex
+  // is visited last and sets its way to the tree parent
+  for (const Vertex& child : m_vertices) {
+    if (child.parent < 0) {
+      continue;
+    }
+    const Vertex& parent = m_vertices[child.parent];
+    NodeRule& parentRule = m_rules[parent.node];
+    parentRule.level = std::max(parentRule.level, parent.level);
+    parentRule.subtreeIds.unionWith(child.ids);
+    if (child.node == parent.node) {
+      continue;
+    }
+
+    std::vector<uint32_t> path = getPath(parent.node, child.node);
+    for (size_t hop = 0; hop + 1 < path.size(); ++hop) {
+      addChildRoute(m_rules[path[hop]], path[hop + 1], child.ids);
+    }
+    for (size_t hop = 1; hop + 1 < path.size(); ++hop) {
+      m_rules[path[hop]].upward[path[hop + 1]] = path[hop - 1];
+    }
+    NodeRule& childRule = m_rules[child.node];
+    childRule.hasParent = true;
+    childRule.defaultUpward = path[path.size() - 2];
+  }
+  auto rootIt = m_rules.find(m_root);
+  if (rootIt != m_rules.end()) {
+    rootIt->second.hasParent = false;
+  }
+
+  for (auto& entry : m_rules) {
+    auto& children = entry.second.children;
+    std::stable_sort(children.begin(), children.end(), [] (const auto& a, const auto& b) {
+      return a.second.size() < b.second.size();
+    });
+  }
+}
+
+void
+AggregateTreePlanner::addChildRoute(NodeRule& rule, uint32_t nextHop, const AggregateIdSet& ids)
+{
+  for (auto& child : rule.children) {
+    if (child.first == nextHop) {
+      child.second.unionWith(ids);
+      return;
+    }
+  }
+  rule.children.emplace_back(nextHop, ids);
+}
+
+void
+AggregateTreePlanner::ensureNode(uint32_t node)
+{
+  if (node >= m_adjacency.size()) {
+    m_adjacency.resize(node + 1);
+    m_distances.clear();
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
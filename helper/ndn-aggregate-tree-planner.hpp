@@ -0,0 +1,174 @@
+#ifndef NDN_AGGREGATE_TREE_PLANNER_HPP
+#define NDN_AGGREGATE_TREE_PLANNER_HPP
+
+#include "ns3/ndnSIM/utils/ndn-aggregate-id-set.hpp"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Plans a static aggregation tree over a topology graph
+ *
+ * Producers are the leaves (level 0). Each further level groups the current frontier
+ * into clusters of at most fan-in nearby vertices and gives every cluster one parent,
+ * chosen among the candidate aggregators by the configured objective. The last level,
+ * or any level whose frontier already fits the fan-in, has a single root.
+ *
+ * The result is one rule per node, expressed in neighbor node indices: which IDs to
+ * send toward which neighbor (the children to wait for), and which neighbor leads to
+ * the tree parent. Nodes that only relay between a child and its parent get rules too,
+ * so requests follow the tree edges instead of the per-ID FIB routes.
+ */
+class AggregateTreePlanner
+{
+public:
+  enum class Objective {
+    LATENCY,   ///< minimise the hop count from the farthest child to its parent
+    LINK_LOAD, ///< minimise the total hop count between children and their parent
+  };
+
+  struct NodeRule
+  {
+    /// Highest level this node aggregates at (0 for leaves and pure relays)
+    uint32_t level = 0;
+    /// IDs aggregated at or below this node
+    AggregateIdSet subtreeIds;
+    /// Next hop toward the producers of each ID set, most specific first
+    std::vector<std::pair<uint32_t, AggregateIdSet>> children;
+    /// Next hop toward the tree parent, by the neighbor a request came from
+    std::map<uint32_t, uint32_t> upward;
+    /// Next hop toward the tree parent for requests from anywhere else (none at the root)
+    bool hasParent = false;
+    uint32_t defaultUpward = 0;
+  };
+
+  /**
+   * @param fanIn Maximum number of children of a non-root vertex (at least 2)
+   * @param levels Maximum number of aggregation levels above the producers (at least 1)
+   */
+  AggregateTreePlanner(uint32_t fanIn, uint32_t levels, Objective objective = Objective::LATENCY);
+
+  /**
+   * @brief Add a bidirectional link between nodes @p a and @p b
+   */
+  void
+  addLink(uint32_t a, uint32_t b);
+
+  /**
+   * @brief Declare that node @p node produces the value of @p id
+   */
+  void
+  addProducer(uint32_t node, int id);
+
+  /**
+   * @brief Allow node @p node to aggregate
+   *
+   * Without candidates, every node that is not a producer may aggregate.
+   */
+  void
+  addCandidate(uint32_t node);
+
+  /**
+   * @brief Compute the tree and the per-node rules
+   * @return false if some producer cannot reach any candidate aggregator
+   */
+  bool
+  plan();
+
+  /**
+   * @return Rules of all nodes on the tree, valid after a successful plan()
+   */
+  const std::map<uint32_t, NodeRule>&
+  getRules() const
+  {
+    return m_rules;
+  }
+
+  uint32_t
+  getRoot() const
+  {
+    return m_root;
+  }
+
+  /**
+   * @return Aggregation levels actually used, at most the configured level count
+   */
+  uint32_t
+  getLevelCount() const
+  {
+    return m_levelCount;
+  }
+
+  static bool
+  parseObjective(const std::string& text, Objective& objective);
+
+private:
+  struct Vertex
+  {
+    uint32_t node;
+    AggregateIdSet ids;
+    uint32_t level;
+    int parent; // index into the vertex list, -1 for the root
+  };
+
+  /**
+   * @return Hop count from @p node to every node, -1 where unreachable
+   */
+  const std::vector<int>&
+  getDistances(uint32_t node);
+
+  /**
+   * @brief Split @p frontier into clusters of at most m_fanIn vertices that are close to each other
+   */
+  std::vector<std::vector<size_t>>
+  cluster(const std::vector<size_t>& frontier);
+
+  /**
+   * @return The best candidate parent for @p group, or -1 if none reaches all members
+   */
+  int64_t
+  pickParent(const std::vector<size_t>& group, const std::vector<bool>& isUsed);
+
+  /**
+   * @return Nodes on a shortest path from @p from to @p to, both included
+   */
+  std::vector<uint32_t>
+  getPath(uint32_t from, uint32_t to);
+
+  void
+  buildRules();
+
+  static void
+  addChildRoute(NodeRule& rule, uint32_t nextHop, const AggregateIdSet& ids);
+
+  void
+  ensureNode(uint32_t node);
+
+private:
+  uint32_t m_fanIn;
+  uint32_t m_levels;
+  Objective m_objective;
+
+  std::vector<std::vector<uint32_t>> m_adjacency;
+  std::vector<std::pair<int, uint32_t>> m_producers; // (ID, node)
+  std::vector<uint32_t> m_candidates;
+  std::vector<uint32_t> m_aggregators; // candidates in effect for the current plan
+  std::unordered_map<uint32_t, std::vector<int>> m_distances;
+
+  std::vector<Vertex> m_vertices;
+  std::map<uint32_t, size_t> m_parentLoad; // groups parented so far, by node
+  std::map<uint32_t, NodeRule> m_rules;
+  uint32_t m_root = 0;
+  uint32_t m_levelCount = 0;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_AGGREGATE_TREE_PLANNER_HPP
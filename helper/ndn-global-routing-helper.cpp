@@ -42,17 +42,27 @@
 #include "ns3/channel.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/abort.h"
 #include "ns3/names.h"
 #include "ns3/node-list.h"
 #include "ns3/channel-list.h"
 #include "ns3/object-factory.h"
+#include "ns3/simulator.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
 #include <boost/concept/assert.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "boost-graph-ndn-global-routing-helper.hpp"
 
@@ -63,6 +73,147 @@ NS_LOG_COMPONENT_DEFINE("ndn.GlobalRoutingHelper");
 namespace ns3 {
 namespace ndn {
 
+namespace {
+
+/**
+ * @brief Copy of the GlobalRouter graph that worker threads may read
+ *
+ * Vertices are the routers of nodes and channels, in the same order as
+ * boost::NdnGlobalRouterGraph; an edge weighs the metric of its face, or 0 from a channel.
+ * Only plain values are kept (node and face IDs instead of pointers), so the snapshot can
+ * outlive one route computation and serve incremental updates.
+ */
+struct RouterGraphSnapshot
+{
+  struct Edge
+  {
+    size_t target;
+    uint32_t weight;
+    nfd::FaceId face; // face of a node's edge, INVALID_FACEID from a channel
+    bool isUp;
+  };
+
+  // A node and the edges that may be the first hop of its routes
+  struct Source
+  {
+    uint32_t nodeId;
+    size_t vertex;
+    std::vector<size_t> firstHops; // indices into edges[vertex]
+  };
+
+  // Shortest paths from one source through one first hop
+  struct Tree
+  {
+    std::vector<uint16_t> distances; // empty if the first hop is unusable
+    std::map<size_t, uint32_t> prefixCosts; // FIB cost of each prefix via this first hop
+  };
+
+  std::vector<std::vector<Edge>> edges;
+  std::vector<std::vector<size_t>> prefixes; // indices into prefixNames, by vertex
+  std::vector<Name> prefixNames;
+  // Vertices in the order DistancesMap iterates them (by router address), so that a
+  // prefix with several origins ends up with the same cost as in the sequential version
+  std::vector<size_t> installOrder;
+  std::unordered_map<uint32_t, size_t> vertexByRouterId;
+
+  std::vector<Source> sources;
+  std::vector<std::vector<Tree>> trees; // by source, then first hop
+
+  Tree
+  computeTree(const Source& source, size_t firstHop) const;
+};
+
+// Same as the weights in boost-graph-ndn-global-routing-helper.hpp: a distance of
+// WeightInf or more counts as unreachable
+const uint32_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+
+RouterGraphSnapshot::Tree
+RouterGraphSnapshot::computeTree(const Source& source, size_t firstHop) const
+{
+  Tree tree;
+  const Edge& first = edges[source.vertex][firstHop];
+  // The sequential version never installs routes through a face of that metric
+  if (!first.isUp || first.weight >= std::numeric_limits<uint16_t>::max() - 1u) {
+    return tree;
+  }
+
+  // Dijkstra with every other face of the source disabled
+  using QueueEntry = std::pair<uint32_t, size_t>;
+  std::vector<uint32_t> distances(edges.size(), UNREACHABLE);
+  distances[source.vertex] = 0;
+  distances[first.target] = first.weight;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+  queue.emplace(first.weight, first.target);
+  while (!queue.empty()) {
+    QueueEntry top = queue.top();
+    queue.pop();
+    if (top.first != distances[top.second]) {
+      continue;
+    }
+    for (const Edge& edge : edges[top.second]) {
+      uint32_t distance = top.first + edge.weight;
+      if (edge.isUp && distance < distances[edge.target]) {
+        distances[edge.target] = distance;
+        queue.emplace(distance, edge.target);
+      }
+    }
+  }
+
+  tree.distances.assign(distances.begin(), distances.end());
+  for (size_t vertex : installOrder) {
+    if (vertex != source.vertex && distances[vertex] < UNREACHABLE) {
+      for (size_t prefix : prefixes[vertex]) {
+        tree.prefixCosts[prefix] = distances[vertex];
+      }
+    }
+  }
+  return tree;
+}
+
+/**
+ * @brief Run task(0) ... task(nTasks - 1) on nThreads threads, the calling one included
+ */
+void
+runInParallel(size_t nTasks, uint32_t nThreads, const std::function<void(size_t)>& task)
+{
+  if (nThreads == 0) {
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  nThreads = static_cast<uint32_t>(std::min<size_t>(nThreads, std::max<size_t>(1, nTasks)));
+
+  std::atomic<size_t> nextTask(0);
+  auto worker = [&] {
+    for (size_t i = nextTask++; i < nTasks; i = nextTask++) {
+      task(i);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (uint32_t i = 1; i < nThreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// Routes installed by the last CalculateAllPossibleRoutesParallel(), for incremental updates
+RouterGraphSnapshot&
+getRoutingState()
+{
+  static RouterGraphSnapshot state;
+  return state;
+}
+
+// Vertices, router IDs and faces of the snapshot are only valid for the current simulation
+void
+clearRoutingState()
+{
+  getRoutingState() = RouterGraphSnapshot();
+}
+
+} // namespace
+
 void
 GlobalRoutingHelper::Install(Ptr<Node> node)
 {
@@ -386,5 +537,196 @@ GlobalRoutingHelper::CalculateAllPossibleRoutes()
   }
 }
 
+void
+GlobalRoutingHelper::CalculateAllPossibleRoutesParallel(uint32_t nThreads)
+{
+  boost::NdnGlobalRouterGraph graph;
+
+  // Snapshot the graph; only this thread touches ns-3 objects and faces
+  RouterGraphSnapshot& state = getRoutingState();
+  state = RouterGraphSnapshot();
+  Simulator::ScheduleDestroy(&clearRoutingState);
+  std::vector<Ptr<GlobalRouter>> routers(graph.GetVertices().begin(), graph.GetVertices().end());
+  for (size_t i = 0; i < routers.size(); ++i) {
+    state.vertexByRouterId.emplace(routers[i]->GetId(), i);
+  }
+  state.edges.resize(routers.size());
+  state.prefixes.resize(routers.size());
+  std::map<Name, size_t> prefixIds;
+  for (size_t i = 0; i < routers.size(); ++i) {
+    for (const auto& incidency : routers[i]->GetIncidencies()) {
+      auto target = state.vertexByRouterId.find(std::get<2>(incidency)->GetId());
+      if (target == state.vertexByRouterId.end()) {
+        continue;
+      }
+      const shared_ptr<Face>& face = std::get<1>(incidency);
+      if (face == nullptr) {
+        state.edges[i].push_back({target->second, 0, nfd::face::INVALID_FACEID, true});
+      }
+      else {
+        state.edges[i].push_back({target->second, face->getMetric(), face->getId(), true});
+      }
+    }
+    for (const auto& prefix : routers[i]->GetLocalPrefixes()) {
+      auto prefixId = prefixIds.emplace(*prefix, state.prefixNames.size());
+      if (prefixId.second) {
+        state.prefixNames.push_back(*prefix);
+      }
+      state.prefixes[i].push_back(prefixId.first->second);
+    }
+  }
+  state.installOrder.resize(routers.size());
+  for (size_t i = 0; i < routers.size(); ++i) {
+    state.installOrder[i] = i;
+  }
+  std::sort(state.installOrder.begin(), state.installOrder.end(), [&routers] (size_t a, size_t b) {
+    return routers[a] < routers[b];
+  });
+
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+    if (router == 0) {
+      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
+      continue;
+    }
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    NS_ASSERT(l3 != 0);
+
+    // First hops in face table order, like the sequential version
+    RouterGraphSnapshot::Source source{(*node)->GetId(), state.vertexByRouterId.at(router->GetId()), {}};
+    const auto& edges = state.edges[source.vertex];
+    for (const auto& nfdFace : l3->getFaceTable()) {
+      if (dynamic_cast<NetDeviceTransport*>(nfdFace.getTransport()) == nullptr) {
+        continue;
+      }
+      for (size_t edge = 0; edge < edges.size(); ++edge) {
+        if (edges[edge].face == nfdFace.getId()) {
+          source.firstHops.push_back(edge);
+          break;
+        }
+      }
+    }
+    state.sources.push_back(std::move(source));
+  }
+
+  NS_LOG_DEBUG("Computing routes of " << state.sources.size() << " nodes");
+  state.trees.resize(state.sources.size());
+  runInParallel(state.sources.size(), nThreads, [&state] (size_t i) {
+    const RouterGraphSnapshot::Source& source = state.sources[i];
+    for (size_t firstHop : source.firstHops) {
+      state.trees[i].push_back(state.computeTree(source, firstHop));
+    }
+  });
+
+  // Install all FIB entries in one pass
+  for (size_t i = 0; i < state.sources.size(); ++i) {
+    const RouterGraphSnapshot::Source& source = state.sources[i];
+    Ptr<Node> node = NodeList::GetNode(source.nodeId);
+    for (size_t hop = 0; hop < source.firstHops.size(); ++hop) {
+      nfd::FaceId faceId = state.edges[source.vertex][source.firstHops[hop]].face;
+      for (const auto& prefixCost : state.trees[i][hop].prefixCosts) {
+        NS_LOG_DEBUG(" prefix " << state.prefixNames[prefixCost.first] << " reachable from node "
+                     << source.nodeId << " via face " << faceId
+                     << " with distance " << prefixCost.second);
+        FibHelper::AddRoute(node, state.prefixNames[prefixCost.first], faceId, prefixCost.second);
+      }
+    }
+  }
+}
+
+void
+GlobalRoutingHelper::UpdateRoutesOnLinkChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp,
+                                              uint32_t nThreads)
+{
+  RouterGraphSnapshot& state = getRoutingState();
+  NS_ABORT_MSG_IF(state.sources.empty(),
+                  "UpdateRoutesOnLinkChange requires routes from CalculateAllPossibleRoutesParallel");
+
+  Ptr<GlobalRouter> router1 = node1->GetObject<GlobalRouter>();
+  Ptr<GlobalRouter> router2 = node2->GetObject<GlobalRouter>();
+  NS_ABORT_MSG_IF(router1 == 0 || router2 == 0, "Both nodes must have GlobalRouter installed");
+  size_t vertex1 = state.vertexByRouterId.at(router1->GetId());
+  size_t vertex2 = state.vertexByRouterId.at(router2->GetId());
+
+  // Point-to-point links are direct edges between the two node routers
+  std::vector<std::pair<size_t, size_t>> changed; // (vertex, index into its edges)
+  for (auto link : {std::make_pair(vertex1, vertex2), std::make_pair(vertex2, vertex1)}) {
+    auto& edges = state.edges[link.first];
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (edges[i].target == link.second && edges[i].isUp != isUp) {
+        edges[i].isUp = isUp;
+        changed.emplace_back(link.first, i);
+      }
+    }
+  }
+  if (changed.empty()) {
+    NS_LOG_DEBUG("No link between nodes " << node1->GetId() << " and " << node2->GetId()
+                 << " changes state");
+    return;
+  }
+
+  // A removed edge matters to trees with a shortest path over it, an added edge to trees
+  // it would shorten; either matters to the tree it is the first hop of
+  std::vector<std::pair<size_t, size_t>> affected; // (source, first hop)
+  for (size_t i = 0; i < state.sources.size(); ++i) {
+    const RouterGraphSnapshot::Source& source = state.sources[i];
+    for (size_t hop = 0; hop < source.firstHops.size(); ++hop) {
+      const auto& distances = state.trees[i][hop].distances;
+      bool isAffected = false;
+      for (const auto& edgeRef : changed) {
+        if (edgeRef.first == source.vertex) {
+          isAffected = edgeRef.second == source.firstHops[hop];
+        }
+        else if (!distances.empty() && distances[edgeRef.first] < UNREACHABLE) {
+          const RouterGraphSnapshot::Edge& edge = state.edges[edgeRef.first][edgeRef.second];
+          uint32_t distance = distances[edgeRef.first] + edge.weight;
+          isAffected = isUp ? distance < distances[edge.target] : distance == distances[edge.target];
+        }
+        if (isAffected) {
+          break;
+        }
+      }
+      if (isAffected) {
+        affected.emplace_back(i, hop);
+      }
+    }
+  }
+  NS_LOG_DEBUG("Link " << node1->GetId() << " <-> " << node2->GetId() << (isUp ? " up" : " down")
+               << ": recomputing " << affected.size() << " shortest-path trees");
+
+  std::vector<RouterGraphSnapshot::Tree> trees(affected.size());
+  runInParallel(affected.size(), nThreads, [&] (size_t i) {
+    const RouterGraphSnapshot::Source& source = state.sources[affected[i].first];
+    trees[i] = state.computeTree(source, source.firstHops[affected[i].second]);
+  });
+
+  // Apply only the FIB differences
+  for (size_t i = 0; i < affected.size(); ++i) {
+    const RouterGraphSnapshot::Source& source = state.sources[affected[i].first];
+    RouterGraphSnapshot::Tree& oldTree = state.trees[affected[i].first][affected[i].second];
+    const RouterGraphSnapshot::Tree& newTree = trees[i];
+    Ptr<Node> node = NodeList::GetNode(source.nodeId);
+    nfd::FaceId faceId = state.edges[source.vertex][source.firstHops[affected[i].second]].face;
+
+    for (const auto& prefixCost : oldTree.prefixCosts) {
+      if (newTree.prefixCosts.count(prefixCost.first) == 0) {
+        NS_LOG_DEBUG(" prefix " << state.prefixNames[prefixCost.first] << " no longer reachable from node "
+                     << source.nodeId << " via face " << faceId);
+        FibHelper::RemoveRoute(node, state.prefixNames[prefixCost.first], faceId);
+      }
+    }
+    for (const auto& prefixCost : newTree.prefixCosts) {
+      auto oldCost = oldTree.prefixCosts.find(prefixCost.first);
+      if (oldCost == oldTree.prefixCosts.end() || oldCost->second != prefixCost.second) {
+        NS_LOG_DEBUG(" prefix " << state.prefixNames[prefixCost.first] << " reachable from node "
+                     << source.nodeId << " via face " << faceId
+                     << " with distance " << prefixCost.second);
+        FibHelper::AddRoute(node, state.prefixNames[prefixCost.first], faceId, prefixCost.second);
+      }
+    }
+    oldTree = std::move(trees[i]);
+  }
+}
+
 } // namespace ndn
 } // namespace ns3
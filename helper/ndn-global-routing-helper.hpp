@@ -124,6 +124,39 @@ public:
   static void
   CalculateAllPossibleRoutes();
 
+  /**
+   * @brief Calculate the same routes as CalculateAllPossibleRoutes() on several threads
+   *
+   * The router graph is first copied into plain arrays, since ns-3 objects must only be
+   * used from the simulator thread. Sources are then shared out to a pool of worker threads,
+   * each running one Dijkstra per source face. FIB entries are installed afterwards in one
+   * batch, in the same order as the sequential version, so the resulting FIBs are identical.
+   *
+   * @param nThreads Number of threads, 0 for std::thread::hardware_concurrency()
+   */
+  static void
+  CalculateAllPossibleRoutesParallel(uint32_t nThreads = 0);
+
+  /**
+   * @brief Update the routes of CalculateAllPossibleRoutesParallel() after a link failed or came back
+   *
+   * The shortest-path trees of the last full calculation in the current simulation are
+   * kept until Simulator::Destroy(). Only the trees that used the changed link (on failure)
+   * or that it would shorten (on recovery) are recomputed, and only the resulting
+   * differences are applied: next hops that lost a prefix are removed, new or changed
+   * costs are added. Other FIB entries are left untouched.
+   *
+   * Call it next to LinkControlHelper::FailLink() and LinkControlHelper::UpLink(), which
+   * only change the error model of the link. Only point-to-point links are supported.
+   *
+   * @param node1 one node
+   * @param node2 another node
+   * @param isUp false when the link fails, true when it is restored
+   * @param nThreads Number of threads, 0 for std::thread::hardware_concurrency()
+   */
+  static void
+  UpdateRoutesOnLinkChange(Ptr<Node> node1, Ptr<Node> node2, bool isUp, uint32_t nThreads = 0);
+
 private:
   void
   Install(Ptr<Channel> channel);
@@ -170,6 +170,16 @@ public:
   void
   InstallAll() const;
 
+  /**
+   * @brief Carry NDN packets between nodes by reference instead of as serialized bytes
+   *
+   * Saves the serialization and parsing of every packet on every hop. Packets keep their
+   * size on the wire, but their ns-3 payload is zero-filled, so leave this disabled when
+   * pcap or ASCII traces need the real bytes.
+   */
+  void
+  setZeroCopy(bool isEnabled);
+
   /**
    * \brief Set flag indicating necessity to install default routes in FIB
    */
@@ -256,6 +266,7 @@ private:
 
   bool m_needSetDefaultRoutes;
   size_t m_maxCsSize = 100;
+  bool m_isZeroCopy = false;
 
   typedef std::function<std::unique_ptr<nfd::cs::Policy>()> PolicyCreationCallback;
   PolicyCreationCallback m_csPolicyCreationFunc;
@@ -19,7 +19,11 @@
 
 #include "ndn-block-header.hpp"
 
+#include "ns3/simulator.h"
+
+#include <deque>
 #include <iosfwd>
+#include <unordered_map>
 #include <boost/iostreams/concepts.hpp>
 #include <boost/iostreams/stream.hpp>
 
@@ -99,9 +103,57 @@ private:
   ns3::Buffer::Iterator& m_is;
 };
 
+/**
+ * @brief Read a TLV VAR-NUMBER from @p is
+ * @return false if the buffer ends before the number does
+ */
+static bool
+readVarNumber(ns3::Buffer::Iterator& is, uint64_t& number)
+{
+  if (is.IsEnd()) {
+    return false;
+  }
+  uint8_t first = is.ReadU8();
+  uint32_t size = first < 253 ? 0 : first == 253 ? 2 : first == 254 ? 4 : 8;
+  if (is.GetRemainingSize() < size) {
+    return false;
+  }
+  switch (size) {
+    case 0:
+      number = first;
+      break;
+    case 2:
+      number = is.ReadNtohU16();
+      break;
+    case 4:
+      number = is.ReadNtohU32();
+      break;
+    default:
+      number = is.ReadNtohU64();
+      break;
+  }
+  return true;
+}
+
 uint32_t
 BlockHeader::Deserialize(ns3::Buffer::Iterator start)
 {
+  // Fast path: size the block from its TLV header and copy it out in one Read(),
+  // instead of pulling it byte by byte through an input stream
+  ns3::Buffer::Iterator header = start;
+  uint64_t type = 0;
+  uint64_t length = 0;
+  if (readVarNumber(header, type) && readVarNumber(header, length)) {
+    uint64_t headerSize = header.GetDistanceFrom(start);
+    if (length <= start.GetRemainingSize() - headerSize) {
+      auto buffer = std::make_shared<::ndn::Buffer>(headerSize + length);
+      start.Read(buffer->data(), buffer->size());
+      m_block = Block(std::move(buffer));
+      return m_block.size();
+    }
+  }
+
+  // Truncated or malformed input: let the stream parser report it
   io::stream<Ns3BufferIteratorSource> is(start);
   m_block = ::ndn::Block::fromStream(is);
   return m_block.size();
@@ -172,5 +224,121 @@ BlockHeader::getBlock() const
   return m_block;
 }
 
+namespace {
+
+struct SharedBlockTable
+{
+  std::unordered_map<uint64_t, Block> blocks;
+  std::deque<std::pair<ns3::Time, uint64_t>> expiries; // in registration order
+  uint64_t nextKey = 1;
+  ns3::Time lifetime = Seconds(10);
+  bool isDestroyScheduled = false;
+};
+
+SharedBlockTable&
+getSharedBlockTable()
+{
+  static SharedBlockTable table;
+  return table;
+}
+
+} // namespace
+
+ns3::TypeId
+SharedBlockTag::GetTypeId()
+{
+  static ns3::TypeId tid =
+    ns3::TypeId("ns3::ndn::SharedBlockTag")
+    .SetGroupName("Ndn")
+    .SetParent<ns3::Tag>()
+    .AddConstructor<SharedBlockTag>()
+    ;
+  return tid;
+}
+
+TypeId
+SharedBlockTag::GetInstanceTypeId(void) const
+{
+  return GetTypeId();
+}
+
+SharedBlockTag::SharedBlockTag()
+  : m_key(0)
+{
+}
+
+SharedBlockTag::SharedBlockTag(const Block& block)
+{
+  SharedBlockTable& table = getSharedBlockTable();
+  ns3::Time now = Simulator::Now();
+  // Blocks of packets lost on the way are dropped once they are surely not in flight
+  while (!table.expiries.empty() && table.expiries.front().first <= now) {
+    table.blocks.erase(table.expiries.front().second);
+    table.expiries.pop_front();
+  }
+
+  if (!table.isDestroyScheduled) {
+    Simulator::ScheduleDestroy(&SharedBlockTag::clear);
+    table.isDestroyScheduled = true;
+  }
+
+  m_key = table.nextKey++;
+  table.blocks.emplace(m_key, block);
+  table.expiries.emplace_back(now + table.lifetime, m_key);
+}
+
+uint32_t
+SharedBlockTag::GetSerializedSize(void) const
+{
+  return sizeof(m_key);
+}
+
+void
+SharedBlockTag::Serialize(TagBuffer buffer) const
+{
+  buffer.WriteU64(m_key);
+}
+
+void
+SharedBlockTag::Deserialize(TagBuffer buffer)
+{
+  m_key = buffer.ReadU64();
+}
+
+void
+SharedBlockTag::Print(std::ostream& os) const
+{
+  os << "SharedBlock=" << m_key;
+}
+
+Block
+SharedBlockTag::getBlock() const
+{
+  const SharedBlockTable& table = getSharedBlockTable();
+  auto it = table.blocks.find(m_key);
+  return it == table.blocks.end() ? Block() : it->second;
+}
+
+void
+SharedBlockTag::release() const
+{
+  getSharedBlockTable().blocks.erase(m_key);
+}
+
+void
+SharedBlockTag::setLifetime(ns3::Time lifetime)
+{
+  getSharedBlockTable().lifetime = lifetime;
+}
+
+void
+SharedBlockTag::clear()
+{
+  SharedBlockTable& table = getSharedBlockTable();
+  table.blocks.clear();
+  table.expiries.clear();
+  table.isDestroyScheduled = false;
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -21,6 +21,8 @@
 #define NDNSIM_NDN_BLOCK_HEADER_HPP
 
 #include "ns3/header.h"
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
 
 #include "ndn-common.hpp"
 
@@ -63,6 +65,75 @@ private:
   Block m_block;
 };
 
+/**
+ * @brief Packet tag that carries a Block by reference instead of as packet bytes
+ *
+ * The tag only holds a key into a table of Blocks, which share the wire buffer of the
+ * sender, so neither side copies the payload. The ns-3 packet itself is a zero-filled
+ * stand-in of the same size, which keeps link and queue timing right but means pcap and
+ * ASCII traces do not see the real bytes.
+ *
+ * A Block stays in the table until release() or, for packets that are dropped on the way,
+ * until it is older than the carriage lifetime.
+ */
+class SharedBlockTag : public ns3::Tag {
+public:
+  static ns3::TypeId
+  GetTypeId();
+
+  virtual TypeId
+  GetInstanceTypeId(void) const;
+
+  SharedBlockTag();
+
+  /**
+   * @brief Register @p block and create a tag referring to it
+   */
+  explicit
+  SharedBlockTag(const Block& block);
+
+  virtual uint32_t
+  GetSerializedSize(void) const;
+
+  virtual void
+  Serialize(TagBuffer buffer) const;
+
+  virtual void
+  Deserialize(TagBuffer buffer);
+
+  virtual void
+  Print(std::ostream& os) const;
+
+  /**
+   * @return The carried Block, or an invalid Block if it is no longer registered
+   */
+  Block
+  getBlock() const;
+
+  /**
+   * @brief Unregister the carried Block, once its only receiver has it
+   */
+  void
+  release() const;
+
+  /**
+   * @brief Set how long a Block is kept for packets that are never received
+   */
+  static void
+  setLifetime(ns3::Time lifetime);
+
+  /**
+   * @brief Drop all registered Blocks
+   *
+   * Also done on Simulator::Destroy(), as expiry times of one run mean nothing in the next.
+   */
+  static void
+  clear();
+
+private:
+  uint64_t m_key;
+};
+
 } // namespace ndn
 } // namespace ns3
 
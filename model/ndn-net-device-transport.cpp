@@ -111,11 +111,19 @@ NetDeviceTransport::doSend(const Block& packet)
   NS_LOG_FUNCTION(this << "Sending packet from netDevice with URI"
                   << this->getLocalUri());
 
-  // convert NFD packet to NS3 packet
-  BlockHeader header(packet);
+  Ptr<ns3::Packet> ns3Packet;
+  if (m_isZeroCopy) {
+    // zero-filled payload of the right size, the Block itself travels by reference
+    ns3Packet = Create<ns3::Packet>(packet.size());
+    ns3Packet->AddPacketTag(SharedBlockTag(packet));
+  }
+  else {
+    // convert NFD packet to NS3 packet
+    BlockHeader header(packet);
 
-  Ptr<ns3::Packet> ns3Packet = Create<ns3::Packet>();
-  ns3Packet->AddHeader(header);
+    ns3Packet = Create<ns3::Packet>();
+    ns3Packet->AddHeader(header);
+  }
 
   // send the NS3 packet
   m_netDevice->Send(ns3Packet, m_netDevice->GetBroadcast(),
@@ -132,15 +140,50 @@ NetDeviceTransport::receiveFromNetDevice(Ptr<NetDevice> device,
 {
   NS_LOG_FUNCTION(device << p << protocol << from << to << packetType);
 
-  // Convert NS3 packet to NFD packet
-  Ptr<ns3::Packet> packet = p->Copy();
+  SharedBlockTag tag;
+  if (p->PeekPacketTag(tag)) {
+    Block block = tag.getBlock();
+    Ptr<Channel> channel = m_netDevice->GetChannel();
+    if (channel != nullptr && channel->GetNDevices() == 2) {
+      tag.release(); // the other end is the only receiver
+    }
+    if (!block.isValid()) {
+      NS_LOG_DEBUG("Dropping packet whose shared Block has expired");
+      return;
+    }
+    this->receive(std::move(block));
+    return;
+  }
 
+  // Convert NS3 packet to NFD packet; peeking needs no copy of the packet
   BlockHeader header;
-  packet->RemoveHeader(header);
+  p->PeekHeader(header);
 
   this->receive(std::move(header.getBlock()));
 }
 
+// Whether a peer of @p device on its channel is simulated by another rank
+static bool
+hasRemotePeer(Ptr<NetDevice> device)
+{
+  Ptr<Channel> channel = device->GetChannel();
+  for (std::size_t i = 0; channel != nullptr && i < channel->GetNDevices(); ++i) {
+    if (channel->GetDevice(i)->GetNode()->GetSystemId() != device->GetNode()->GetSystemId()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+NetDeviceTransport::setZeroCopy(bool isEnabled)
+{
+  m_isZeroCopy = isEnabled && !hasRemotePeer(m_netDevice);
+  if (isEnabled && !m_isZeroCopy) {
+    NS_LOG_DEBUG("Channel crosses ranks, sending serialized packets on " << this->getLocalUri());
+  }
+}
+
 Ptr<NetDevice>
 NetDeviceTransport::GetNetDevice() const
 {
@@ -57,6 +57,17 @@ public:
   virtual ssize_t
   getSendQueueLength() final;
 
+  /**
+   * @brief Enable or disable zero-copy carriage of outgoing packets
+   *
+   * When enabled, the ns-3 packet carries the Block through a SharedBlockTag instead
+   * of its serialized bytes. Received packets are accepted in either form. The Block
+   * table is local to the process, so a device whose channel reaches a node simulated
+   * by another (MPI) rank keeps sending serialized bytes.
+   */
+  void
+  setZeroCopy(bool isEnabled);
+
 private:
   virtual void
   doClose() override;
@@ -73,6 +84,7 @@ private:
 
   Ptr<NetDevice> m_netDevice; ///< \brief Smart pointer to NetDevice
   Ptr<Node> m_node;
+  bool m_isZeroCopy = false;
 };
 
 } // namespace ndn
@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-aggregate-round-benchmark.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/helper/ndn-aggregate-simulation-helper.hpp"
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+
+// AggregateUtils derives node roles from this value
+static ns3::GlobalValue g_nodeCount("NodeCount",
+  "Number of consumer-producer nodes",
+  ns3::UintegerValue(5),
+  ns3::MakeUintegerChecker<uint32_t>(1, 100000));
+
+namespace ns3 {
+
+/**
+ * Runs one aggregation configuration and appends one CSV row with its cost:
+ *
+ *     NodeCount,FanIn,RoundsPerSecond,Window,Rounds,CompletedRounds,WallSeconds,
+ *     MeanRoundLatencyMs,MaxRoundLatencyMs,InterestsPerRound,DataPerRound,PeakPit,PeakRssMiB,
+ *     DeadlineMs,Coverage
+ *
+ * Every producer is also a consumer that requests the aggregate of all other producers,
+ * so per-round work grows as O(N^2). Consumers issue rounds at a fixed rate with up to
+ * --window rounds in flight. A round completes when every consumer has its result; its
+ * latency is measured from the time the round was due. With --deadline, results may be
+ * partial; Coverage is the fraction of requested IDs that contributed to the results.
+ *
+ *     ./waf --run "ndn-aggregate-round-benchmark --nodeCount=32 --fanIn=4 --rate=10 --rounds=20"
+ *
+ * ndn-aggregate-round-benchmark.sh sweeps the parameters, one process per configuration
+ * so that the RSS of one run does not carry over into the next.
+ */
+class RoundBenchmark
+{
+public:
+  int
+  run(int argc, char* argv[]);
+
+private:
+  void
+  onEvent(const ndn::AggregateEvent& event);
+
+  void
+  sample();
+
+  void
+  countPackets(uint64_t& nInterests, uint64_t& nData) const;
+
+  void
+  writeRow(std::ostream& os, double wallSeconds) const;
+
+private:
+  int m_nodeCount = 16;
+  int m_fanIn = 4;
+  double m_rate = 10;
+  int m_rounds = 10;
+  int m_window = 4;
+  bool m_isMultipath = false;
+  Time m_deadline = Seconds(0);
+  uint32_t m_maxRetx = 0;
+  uint32_t m_treeLevels = 0;
+  bool m_isAllReduce = false;
+  bool m_isZeroCopy = false;
+  Time m_sampleInterval = MilliSeconds(10);
+  Time m_firstRound = Seconds(1.0); // when ValueProducer issues its first round
+
+  struct Round
+  {
+    int nResults = 0;
+    Time lastResult;
+  };
+  std::map<int, Round> m_results;
+  uint64_t m_nRequestedIds = 0;
+  uint64_t m_nResultIds = 0;
+
+  uint64_t m_peakPit = 0;
+  int64_t m_peakRss = 0;
+};
+
+int
+RoundBenchmark::run(int argc, char* argv[])
+{
+  std::string output = "aggregate-round-benchmark.csv";
+  std::string op = "sum";
+  std::string treeObjective = "latency";
+
+  CommandLine cmd;
+  cmd.AddValue("nodeCount", "Number of consumer-producer nodes", m_nodeCount);
+  cmd.AddValue("fanIn", "Rack aggregators per core aggregator", m_fanIn);
+  cmd.AddValue("rate", "Rounds issued per second by every consumer", m_rate);
+  cmd.AddValue("rounds", "Number of rounds", m_rounds);
+  cmd.AddValue("window", "Rounds a consumer may have in flight at once", m_window);
+  cmd.AddValue("multipath", "Spread sub-Interests over equal-cost next hops", m_isMultipath);
+  cmd.AddValue("deadline", "Per-hop deadline for partial results (0 = wait for all)", m_deadline);
+  cmd.AddValue("retx", "Retransmissions per unanswered sub-Interest (0 = off)", m_maxRetx);
+  cmd.AddValue("treeLevels", "Aggregate along a static tree of this many levels, fan-in fanIn "
+               "(0 = split per ID along FIB routes)", m_treeLevels);
+  cmd.AddValue("allreduce", "Every consumer requests one global aggregate", m_isAllReduce);
+  cmd.AddValue("treeObjective", "Static tree parent selection: latency or link-load", treeObjective);
+  cmd.AddValue("zeroCopy", "Carry packets between nodes by reference, not as bytes", m_isZeroCopy);
+  cmd.AddValue("op", "Aggregation operator, as in aggregate-sum-simulation", op);
+  cmd.AddValue("sampleInterval", "Period of PIT size and RSS sampling", m_sampleInterval);
+  cmd.AddValue("output", "CSV file the result row is appended to", output);
+  cmd.Parse(argc, argv);
+
+  GlobalValue::Bind("NodeCount", UintegerValue(m_nodeCount));
+
+  ndn::AggregateOpSpec opSpec;
+  if (!ndn::AggregateOpSpec::fromComponent(::ndn::Name::Component("op=" + op), opSpec)) {
+    NS_FATAL_ERROR("Unknown aggregation operator: " << op);
+  }
+  ndn::AggregateTreePlanner::Objective objective;
+  if (!ndn::AggregateTreePlanner::parseObjective(treeObjective, objective)) {
+    NS_FATAL_ERROR("Unknown tree objective: " << treeObjective);
+  }
+
+  ndn::AggregateSimulationHelper helper;
+  helper.SetNodeCount(m_nodeCount);
+  helper.SetFanIn(m_fanIn);
+  helper.SetOperator(opSpec);
+  helper.SetRoundSchedule(m_rate, m_rounds, m_window);
+  helper.SetMultipath(m_isMultipath);
+  helper.SetDeadline(m_deadline);
+  helper.SetRetransmission(m_maxRetx);
+  helper.SetAggregationTree(m_fanIn, m_treeLevels, objective);
+  helper.SetAllReduce(m_isAllReduce);
+  // Signing is benchmarked separately by ndn-aggregate-signing-benchmark
+  helper.SetSigningPolicy(ndn::AggregateSigningPolicy::FAKE);
+
+  NodeContainer nodes = helper.CreateTopology();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.setCsSize(0);
+  ndnHelper.setZeroCopy(m_isZeroCopy);
+  ndnHelper.InstallAll();
+
+  helper.InstallStrategy();
+  helper.InstallProducers(nodes);
+  helper.ConfigureRouting(nodes);
+  helper.InstallConsumers(nodes);
+
+  ndn::AggregateEventSink::getInstance().setCallback(
+    [this] (const ndn::AggregateEvent& event) { onEvent(event); },
+    ndn::AggregateEventSink::getMask(ndn::AggregateEventType::RESULT));
+  Simulator::Schedule(m_sampleInterval, &RoundBenchmark::sample, this);
+
+  // Deferred rounds may start late, so allow for a full window of Interest lifetimes
+  Time lastRound = m_firstRound + Seconds((m_rounds - 1) / m_rate);
+  Simulator::Stop(lastRound + Seconds(2.0 * m_window + 1.0));
+
+  auto begin = std::chrono::steady_clock::now();
+  Simulator::Run();
+  double wallSeconds =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  bool isNewFile = !std::ifstream(output).good();
+  std::ofstream os(output, std::ios::app);
+  if (isNewFile) {
+    os << "NodeCount,FanIn,RoundsPerSecond,Window,Rounds,CompletedRounds,WallSeconds,"
+       << "MeanRoundLatencyMs,MaxRoundLatencyMs,InterestsPerRound,DataPerRound,PeakPit,PeakRssMiB,"
+       << "DeadlineMs,Coverage\n";
+  }
+  writeRow(os, wallSeconds);
+  writeRow(std::cout, wallSeconds);
+
+  ndn::AggregateEventSink::getInstance().reset();
+  Simulator::Destroy();
+  return 0;
+}
+
+void
+RoundBenchmark::onEvent(const ndn::AggregateEvent& event)
+{
+  std::string seq = ndn::AggregateUtils::extractSequenceComponent(event.name).toUri();
+  if (seq.compare(0, 4, "seq=") != 0) {
+    return;
+  }
+  Round& round = m_results[std::stoi(seq.substr(4))];
+  ++round.nResults;
+  round.lastResult = Simulator::Now();
+
+  // idCount excludes the IDs a deadline reply reported missing
+  m_nRequestedIds += ndn::AggregateUtils::extractIdsFromName(event.name).size();
+  m_nResultIds += event.idCount;
+}
+
+void
+RoundBenchmark::sample()
+{
+  uint64_t pitSize = 0;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    pitSize += (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getPit().size();
+  }
+  m_peakPit = std::max(m_peakPit, pitSize);
+  m_peakRss = std::max(m_peakRss, MemUsage::Get());
+
+  Simulator::Schedule(m_sampleInterval, &RoundBenchmark::sample, this);
+}
+
+void
+RoundBenchmark::countPackets(uint64_t& nInterests, uint64_t& nData) const
+{
+  // Only network faces, so that a packet handed to an application is not counted twice
+  nInterests = nData = 0;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    for (const auto& face : (*node)->GetObject<ndn::L3Protocol>()->getFaceTable()) {
+      auto transport = face.getTransport();
+      if (transport == nullptr || transport->getLocalUri().getScheme() != "netdev") {
+        continue;
+      }
+      nInterests += face.getCounters().nOutInterests;
+      nData += face.getCounters().nOutData;
+    }
+  }
+}
+
+void
+RoundBenchmark::writeRow(std::ostream& os, double wallSeconds) const
+{
+  int nCompleted = 0;
+  double totalLatency = 0;
+  double maxLatency = 0;
+  for (const auto& result : m_results) {
+    if (result.second.nResults < m_nodeCount) {
+      continue;
+    }
+    Time issued = m_firstRound + Seconds(result.first / m_rate);
+    double latency = (result.second.lastResult - issued).GetSeconds() * 1000;
+    ++nCompleted;
+    totalLatency += latency;
+    maxLatency = std::max(maxLatency, latency);
+  }
+
+  uint64_t nInterests = 0;
+  uint64_t nData = 0;
+  countPackets(nInterests, nData);
+
+  os << m_nodeCount << ',' << m_fanIn << ',' << m_rate << ',' << m_window << ',' << m_rounds << ','
+     << nCompleted << ',' << wallSeconds << ','
+     << (nCompleted > 0 ? totalLatency / nCompleted : 0) << ',' << maxLatency << ','
+     << static_cast<double>(nInterests) / m_rounds << ','
+     << static_cast<double>(nData) / m_rounds << ','
+     << m_peakPit << ',' << m_peakRss / 1024.0 / 1024.0 << ','
+     << m_deadline.GetMilliSeconds() << ','
+     << (m_nRequestedIds > 0 ? static_cast<double>(m_nResultIds) / m_nRequestedIds : 0) << '\n';
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  ns3::RoundBenchmark benchmark;
+  return benchmark.run(argc, argv);
+}
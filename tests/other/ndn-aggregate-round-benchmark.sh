@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# Sweeps the aggregation round benchmark and collects one CSV row per configuration.
+# Each configuration runs in its own process, so peak RSS is not carried over.
+
+output=${1:-aggregate-round-benchmark.csv}
+rounds=20
+
+rm -f "${output}"
+
+# Scaling in the number of producers, to locate the O(N^2) knee
+echo "Scaling in node count.."
+for nodes in 4 8 16 32 64 128 256; do
+  ../../../waf --run ndn-aggregate-round-benchmark --command-template="%s --nodeCount=${nodes} --fanIn=4 --rate=10 --rounds=${rounds} --output=${output}"
+done
+
+echo
+
+# Aggregation fan-in at the core layer
+echo "Scaling in core fan-in.."
+for fanIn in 2 4 8 16; do
+  ../../../waf --run ndn-aggregate-round-benchmark --command-template="%s --nodeCount=64 --fanIn=${fanIn} --rate=10 --rounds=${rounds} --output=${output}"
+done
+
+echo
+
+# Offered round rate, up to rounds overlapping in flight
+echo "Scaling in round rate.."
+for rate in 1 10 50 100 200; do
+  ../../../waf --run ndn-aggregate-round-benchmark --command-template="%s --nodeCount=32 --fanIn=4 --rate=${rate} --rounds=${rounds} --output=${output}"
+done
+
+echo
+
+# Per-hop deadline: tail latency against the fraction of IDs in the result
+echo "Scaling in deadline.."
+for deadline in 10ms 20ms 50ms 0s; do
+  ../../../waf --run ndn-aggregate-round-benchmark --command-template="%s --nodeCount=64 --fanIn=4 --rate=10 --rounds=${rounds} --deadline=${deadline} --output=${output}"
+done
+
+echo "Results in ${output}"
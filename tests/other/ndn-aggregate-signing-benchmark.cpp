@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-aggregate-signing-benchmark.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/utils/ndn-aggregate-utils.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace ns3 {
+
+/**
+ * Measures the cost of creating one aggregation Data packet under each signing policy,
+ * for scalar SUM partials and for a vector payload.
+ *
+ *     ./waf --run "ndn-aggregate-signing-benchmark --count=100000 --vectorLength=256"
+ */
+int
+main(int argc, char* argv[])
+{
+  int count = 100000;
+  int vectorLength = 256;
+
+  CommandLine cmd;
+  cmd.AddValue("count", "Number of Data packets created per policy", count);
+  cmd.AddValue("vectorLength", "Number of f32 elements in the vector payload", vectorLength);
+  cmd.Parse(argc, argv);
+
+  ndn::AggregateOpSpec scalarSpec;
+  ndn::AggregateOpSpec vectorSpec;
+  vectorSpec.elementType = ndn::AggregateElementType::FLOAT32;
+  vectorSpec.vectorLength = static_cast<uint32_t>(vectorLength);
+
+  ndn::AggregateState scalar(scalarSpec);
+  scalar.addSample(42);
+  ndn::AggregateState vector(vectorSpec);
+  std::vector<uint8_t> sample = ndn::AggregateUtils::makeVectorSample(vectorSpec, 1);
+  vector.addVector(sample.data(), sample.size());
+
+  ::ndn::Name name("/aggregate/ids=1-64/seq=0");
+  ndn::AggregateDataTemplate& dataTemplate = ndn::AggregateUtils::getDataTemplate();
+
+  std::cout << "Policy\tPayload\tBytes\tNsPerPacket" << std::endl;
+  for (const char* policyName : {"keychain", "digest", "fake", "none"}) {
+    ndn::AggregateSigningPolicy policy;
+    ndn::AggregateDataTemplate::parseSigningPolicy(policyName, policy);
+    dataTemplate.setSigningPolicy(policy);
+
+    for (const ndn::AggregateState* state : {&scalar, &vector}) {
+      size_t wireSize = dataTemplate.makeData(name, *state)->wireEncode().size();
+
+      auto begin = std::chrono::steady_clock::now();
+      for (int i = 0; i < count; ++i) {
+        dataTemplate.makeData(name, *state);
+      }
+      auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - begin).count();
+
+      std::cout << policyName << "\t" << (state == &scalar ? "scalar" : "vector") << "\t"
+                << wireSize << "\t" << std::fixed << std::setprecision(1)
+                << static_cast<double>(elapsed) / count << std::endl;
+    }
+  }
+  dataTemplate.setSigningPolicy(ndn::AggregateSigningPolicy::KEYCHAIN);
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
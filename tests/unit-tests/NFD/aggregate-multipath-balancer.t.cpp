@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/fw/AggregateMultipathBalancer.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/fib.hpp"
+
+#include "null-face-fixture.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace ns3 {
+namespace ndn {
+
+using ::nfd::fw::AggregateMultipathBalancer;
+
+class AggregateMultipathBalancerFixture : public NullFaceFixture
+{
+public:
+  AggregateMultipathBalancerFixture()
+    : ids(10)
+  {
+    std::iota(ids.begin(), ids.end(), 0);
+  }
+
+public:
+  std::vector<int> ids;
+  AggregateMultipathBalancer balancer;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestAggregateMultipathBalancer, AggregateMultipathBalancerFixture)
+
+BOOST_AUTO_TEST_CASE(SmoothedRtt)
+{
+  BOOST_CHECK(balancer.getSmoothedRtt(*face1) < ::ndn::time::nanoseconds::zero());
+
+  balancer.addRttSample(*face1, ::ndn::time::milliseconds(8));
+  BOOST_CHECK(balancer.getSmoothedRtt(*face1) == ::ndn::time::milliseconds(8));
+  balancer.addRttSample(*face1, ::ndn::time::milliseconds(16));
+  BOOST_CHECK(balancer.getSmoothedRtt(*face1) == ::ndn::time::milliseconds(9));
+
+  BOOST_CHECK(balancer.getSmoothedRtt(*face2) < ::ndn::time::nanoseconds::zero());
+}
+
+BOOST_AUTO_TEST_CASE(EqualCostFaces)
+{
+  ::nfd::NameTree nameTree;
+  ::nfd::Fib fib(nameTree);
+  ::nfd::fib::Entry& entry = *fib.insert("/aggregate").first;
+  fib.addOrUpdateNextHop(entry, *face1, 1);
+  fib.addOrUpdateNextHop(entry, *face2, 1);
+  fib.addOrUpdateNextHop(entry, *face3, 5);
+
+  std::vector<::nfd::Face*> faces = AggregateMultipathBalancer::getEqualCostFaces(entry, *face3);
+  std::sort(faces.begin(), faces.end());
+  std::vector<::nfd::Face*> expected{face1.get(), face2.get()};
+  std::sort(expected.begin(), expected.end());
+  BOOST_CHECK(faces == expected);
+
+  faces = AggregateMultipathBalancer::getEqualCostFaces(entry, *face1);
+  BOOST_CHECK(faces == std::vector<::nfd::Face*>{face2.get()});
+
+  // The ingress face is used when nothing else is left
+  fib.removeNextHop(entry, *face2);
+  fib.removeNextHop(entry, *face3);
+  faces = AggregateMultipathBalancer::getEqualCostFaces(entry, *face1);
+  BOOST_CHECK(faces == std::vector<::nfd::Face*>{face1.get()});
+}
+
+BOOST_AUTO_TEST_CASE(AssignProportionalRuns)
+{
+  balancer.addRttSample(*face1, ::ndn::time::milliseconds(1));
+  balancer.addRttSample(*face2, ::ndn::time::milliseconds(4));
+
+  std::map<::nfd::Face*, std::vector<int>> faceToIds;
+  balancer.assign(ids, {face1.get(), face2.get()}, faceToIds);
+  BOOST_CHECK_EQUAL(faceToIds.size(), 2);
+  BOOST_CHECK(faceToIds[face1.get()] == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7}));
+  BOOST_CHECK(faceToIds[face2.get()] == std::vector<int>({8, 9}));
+
+  // Runs are appended to what the map already holds
+  balancer.assign({10}, {face1.get(), face2.get()}, faceToIds);
+  BOOST_CHECK_EQUAL(faceToIds[face1.get()].size(), 9);
+  BOOST_CHECK_EQUAL(faceToIds[face1.get()].back(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(AssignLargestRemainder)
+{
+  // Equal weights: 10 IDs over 3 faces are split 4/3/3 in some order, without gaps
+  std::vector<::nfd::Face*> faces{face1.get(), face2.get(), face3.get()};
+  std::map<::nfd::Face*, std::vector<int>> faceToIds;
+  balancer.assign(ids, faces, faceToIds);
+
+  std::vector<int> joined;
+  size_t nLarger = 0;
+  for (auto* face : faces) {
+    const std::vector<int>& run = faceToIds[face];
+    BOOST_CHECK(run.size() == 3 || run.size() == 4);
+    nLarger += run.size() == 4;
+    joined.insert(joined.end(), run.begin(), run.end());
+  }
+  BOOST_CHECK_EQUAL(nLarger, 1);
+  BOOST_CHECK(joined == ids);
+}
+
+BOOST_AUTO_TEST_CASE(UnmeasuredFaces)
+{
+  // A face without samples is assumed to be as fast as the best measured one
+  balancer.addRttSample(*face1, ::ndn::time::milliseconds(4));
+
+  std::map<::nfd::Face*, std::vector<int>> faceToIds;
+  balancer.assign(ids, {face1.get(), face2.get()}, faceToIds);
+  BOOST_CHECK(faceToIds[face1.get()] == std::vector<int>({0, 1, 2, 3, 4}));
+  BOOST_CHECK(faceToIds[face2.get()] == std::vector<int>({5, 6, 7, 8, 9}));
+}
+
+BOOST_AUTO_TEST_CASE(Pick)
+{
+  balancer.addRttSample(*face1, ::ndn::time::milliseconds(4));
+  balancer.addRttSample(*face2, ::ndn::time::milliseconds(1));
+  BOOST_CHECK(balancer.pick({face1.get(), face2.get()}) == face2.get());
+
+  // A single ID and a single face go to one face whole
+  std::map<::nfd::Face*, std::vector<int>> faceToIds;
+  balancer.assign({7}, {face1.get(), face2.get()}, faceToIds);
+  BOOST_CHECK_EQUAL(faceToIds.size(), 1);
+  BOOST_CHECK(faceToIds[face2.get()] == std::vector<int>({7}));
+  balancer.assign(ids, {face1.get()}, faceToIds);
+  BOOST_CHECK(faceToIds[face1.get()] == ids);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/fw/AggregateNextHopCache.hpp"
+
+#include "null-face-fixture.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+using ::nfd::fw::AggregateNextHopCache;
+
+class AggregateNextHopCacheFixture : public NullFaceFixture
+{
+public:
+  AggregateNextHopCacheFixture()
+    : fib(nameTree)
+    , cache(fib)
+  {
+  }
+
+  void
+  addRoute(const Name& prefix, ::nfd::Face& face, uint64_t cost = 1)
+  {
+    fib.addOrUpdateNextHop(*fib.insert(prefix).first, face, cost);
+  }
+
+public:
+  ::nfd::NameTree nameTree;
+  ::nfd::Fib fib;
+  AggregateNextHopCache cache;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestAggregateNextHopCache, AggregateNextHopCacheFixture)
+
+BOOST_AUTO_TEST_CASE(Resolve)
+{
+  BOOST_CHECK(cache.lookup(1) == nullptr);
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 1);
+  cache.invalidate();
+
+  addRoute("/aggregate", *face2);
+  addRoute("/aggregate/1", *face1);
+
+  BOOST_CHECK(cache.lookup(1) == face1.get());
+  BOOST_CHECK(cache.lookup(2) == face2.get());
+  BOOST_REQUIRE(cache.lookupEntry(1) != nullptr);
+  BOOST_CHECK_EQUAL(cache.lookupEntry(1)->getPrefix(), Name("/aggregate/1"));
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 2);
+
+  // IDs outside the dense array are resolved every time and not counted
+  BOOST_CHECK(cache.lookup(AggregateNextHopCache::MAX_CACHED_ID) == face2.get());
+  BOOST_CHECK(cache.lookup(-1) == face2.get());
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidateOnFibChange)
+{
+  addRoute("/aggregate", *face1);
+  BOOST_CHECK(cache.lookup(3) == face1.get());
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 1);
+
+  // Routes outside /aggregate keep the plan
+  addRoute("/other", *face2);
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 1);
+
+  // New next hop below /aggregate (afterNewNextHop)
+  addRoute("/aggregate/3", *face3);
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 0);
+  BOOST_CHECK(cache.lookup(3) == face3.get());
+
+  // Cost change of an existing next hop above /aggregate (afterUpdateNextHops)
+  addRoute("/", *face2);
+  BOOST_CHECK(cache.lookup(3) == face3.get());
+  addRoute("/", *face2, 5);
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 0);
+
+  // Removed next hop (afterUpdateNextHops)
+  BOOST_CHECK(cache.lookup(3) == face3.get());
+  fib.removeNextHop(*fib.findExactMatch("/aggregate/3"), *face3);
+  BOOST_CHECK_EQUAL(cache.getResolvedCount(), 0);
+  BOOST_CHECK(cache.lookup(3) == face1.get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
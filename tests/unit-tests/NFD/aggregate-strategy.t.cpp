@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "helper/ndn-aggregate-simulation-helper.hpp"
+#include "helper/ndn-app-helper.hpp"
+
+#include <ndn-cxx/face.hpp>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class AggregateStrategyFixture : public CleanupFixture
+{
+public:
+  AggregateStrategyFixture()
+  {
+    // Producers P1-P4 under rack aggregators and one core; a single round, issued at 1s
+    helper.SetNodeCount(4);
+    helper.SetRoundSchedule(1.0, 1, 1);
+    nodes = helper.CreateTopology();
+
+    StackHelper ndnHelper;
+    ndnHelper.setCsSize(0);
+    ndnHelper.InstallAll();
+
+    helper.InstallStrategy();
+    helper.InstallProducers(nodes);
+    helper.ConfigureRouting(nodes);
+    helper.InstallConsumers(nodes);
+  }
+
+public:
+  AggregateSimulationHelper helper;
+  NodeContainer nodes;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestAggregateStrategy, AggregateStrategyFixture)
+
+class LateConsumer
+{
+public:
+  LateConsumer(const Name& name, size_t& nData, size_t& nTimeouts)
+  {
+    m_face.expressInterest(Interest(name).setCanBePrefix(false),
+                           [&nData] (const Interest&, const Data&) { ++nData; },
+                           nullptr,
+                           [&nTimeouts] (const Interest&) { ++nTimeouts; });
+  }
+
+private:
+  ::ndn::Face m_face;
+};
+
+BOOST_AUTO_TEST_CASE(InterestAfterCompletion)
+{
+  // Same name as P1's round 0 request, which its rack aggregator has answered by 3s
+  Name name("/aggregate");
+  AggregateUtils::appendIdSet(name, AggregateIdSet({2, 3, 4}));
+  name.append("seq=0");
+
+  size_t nData = 0;
+  size_t nTimeouts = 0;
+  FactoryCallbackApp::Install(nodes.Get(helper.GetProducerIds().front()), [&] () -> shared_ptr<void> {
+      return make_shared<LateConsumer>(name, nData, nTimeouts);
+    })
+    .Start(Seconds(3.0));
+
+  Simulator::Stop(Seconds(8.0));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(nData, 1);
+  BOOST_CHECK_EQUAL(nTimeouts, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/fw/AggregateValueCache.hpp"
+#include "utils/ndn-time.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+using ::nfd::fw::AggregateValueCache;
+
+class AggregateValueCacheFixture : public CleanupFixture
+{
+public:
+  AggregateValueCacheFixture()
+  {
+    // Entry expiry follows simulated time
+    ::ndn::time::setCustomClocks(make_shared<ns3::ndn::time::CustomSteadyClock>(),
+                                 make_shared<ns3::ndn::time::CustomSystemClock>());
+  }
+
+  static AggregateState
+  makeSum(uint64_t value)
+  {
+    AggregateState state;
+    state.addSample(value);
+    return state;
+  }
+
+public:
+  const Name sumRound1 = Name("/aggregate/op=sum/seq=1");
+  const Name maxRound1 = Name("/aggregate/op=max/seq=1");
+  const Name sumRound2 = Name("/aggregate/op=sum/seq=2");
+};
+
+BOOST_FIXTURE_TEST_SUITE(TestAggregateValueCache, AggregateValueCacheFixture)
+
+BOOST_AUTO_TEST_CASE(SamplesByRound)
+{
+  AggregateValueCache cache;
+  cache.insertSample(sumRound1, 1, 10);
+  cache.insertSample(sumRound1, 2, 20);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  AggregateState partial;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2, 3}), partial) == AggregateIdSet({1, 2}));
+  BOOST_CHECK_EQUAL(partial.getResult(), 30);
+
+  // Raw samples are valid under every operator, but only for their own round
+  AggregateState max(AggregateOpSpec::select(maxRound1));
+  BOOST_CHECK(cache.cover(maxRound1, AggregateIdSet({1, 2}), max) == AggregateIdSet({1, 2}));
+  BOOST_CHECK_EQUAL(max.getResult(), 20);
+
+  AggregateState other;
+  BOOST_CHECK(cache.cover(sumRound2, AggregateIdSet({1, 2}), other).empty());
+
+  // Vector states cannot be filled from scalar samples
+  AggregateOpSpec vectorSpec;
+  BOOST_REQUIRE(AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,f32,5"), vectorSpec));
+  AggregateState vector(vectorSpec);
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2}), vector).empty());
+}
+
+BOOST_AUTO_TEST_CASE(PartialsByOperator)
+{
+  AggregateValueCache cache;
+  cache.insertPartial(sumRound1, AggregateIdSet({0, 1, 2}), makeSum(6));
+
+  AggregateState sum;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({0, 1, 2}), sum) == AggregateIdSet({0, 1, 2}));
+  BOOST_CHECK_EQUAL(sum.getResult(), 6);
+
+  AggregateState max(AggregateOpSpec::select(maxRound1));
+  BOOST_CHECK(cache.cover(maxRound1, AggregateIdSet({0, 1, 2}), max).empty());
+
+  AggregateState nextRound;
+  BOOST_CHECK(cache.cover(sumRound2, AggregateIdSet({0, 1, 2}), nextRound).empty());
+
+  // Re-inserting the same ID set replaces the partial
+  cache.insertPartial(sumRound1, AggregateIdSet({0, 1, 2}), makeSum(9));
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  AggregateState replaced;
+  cache.cover(sumRound1, AggregateIdSet({0, 1, 2}), replaced);
+  BOOST_CHECK_EQUAL(replaced.getResult(), 9);
+}
+
+BOOST_AUTO_TEST_CASE(GreedyDisjointCover)
+{
+  AggregateValueCache cache;
+  cache.insertPartial(sumRound1, AggregateIdSet({0, 1, 2, 3}), makeSum(1));
+  cache.insertPartial(sumRound1, AggregateIdSet({2, 3, 4}), makeSum(10));
+  cache.insertPartial(sumRound1, AggregateIdSet({4, 5}), makeSum(100));
+  cache.insertPartial(sumRound1, AggregateIdSet({5, 6}), makeSum(1000));
+  cache.insertSample(sumRound1, 7, 10000);
+
+  // {0-3} is taken first; {2,3,4} overlaps it, {5,6} is not contained in the query
+  AggregateState partial;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({0, 1, 2, 3, 4, 5, 7, 8}), partial) ==
+              AggregateIdSet({0, 1, 2, 3, 4, 5, 7}));
+  BOOST_CHECK_EQUAL(partial.getResult(), 10101);
+}
+
+BOOST_AUTO_TEST_CASE(LruEviction)
+{
+  AggregateValueCache cache(2);
+  cache.insertSample(sumRound1, 1, 1);
+  cache.insertSample(sumRound1, 2, 2);
+
+  AggregateState first;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1}), first) == AggregateIdSet({1}));
+
+  // 2 is now least recently used
+  cache.insertSample(sumRound1, 3, 3);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  AggregateState second;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2, 3}), second) == AggregateIdSet({1, 3}));
+
+  // The lookup above touched 1, then 3
+  cache.setLimits(1, cache.getTtl());
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  AggregateState third;
+  BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 3}), third) == AggregateIdSet({3}));
+
+  cache.setLimits(0, cache.getTtl());
+  cache.insertSample(sumRound1, 4, 4);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TtlExpiry)
+{
+  AggregateValueCache cache(16, ::ndn::time::seconds(1));
+  cache.insertSample(sumRound1, 1, 10);
+  cache.insertSample(sumRound1, 2, 20);
+
+  Simulator::Schedule(MilliSeconds(500), [&] {
+    // A hit does not extend the lifetime, a new value does
+    AggregateState partial;
+    BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2}), partial) == AggregateIdSet({1, 2}));
+    cache.insertSample(sumRound1, 2, 21);
+  });
+  Simulator::Schedule(MilliSeconds(1200), [&] {
+    AggregateState partial;
+    BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2}), partial) == AggregateIdSet({2}));
+    BOOST_CHECK_EQUAL(partial.getResult(), 21);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+  });
+  Simulator::Schedule(MilliSeconds(1600), [&] {
+    AggregateState partial;
+    BOOST_CHECK(cache.cover(sumRound1, AggregateIdSet({1, 2}), partial).empty());
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+  });
+  Simulator::Run();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
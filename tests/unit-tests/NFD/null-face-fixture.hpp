@@ -0,0 +1,62 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NDNSIM_TESTS_UNIT_TESTS_NFD_NULL_FACE_FIXTURE_HPP
+#define NDNSIM_TESTS_UNIT_TESTS_NFD_NULL_FACE_FIXTURE_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
+#include "model/null-transport.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Three standalone faces over NullTransport, for tests that need faces but no network
+ */
+class NullFaceFixture : public CleanupFixture
+{
+public:
+  NullFaceFixture()
+    : face1(makeFace(1))
+    , face2(makeFace(2))
+    , face3(makeFace(3))
+  {
+  }
+
+  static shared_ptr<::nfd::Face>
+  makeFace(::nfd::FaceId id)
+  {
+    auto face = make_shared<::nfd::Face>(make_unique<::nfd::face::GenericLinkService>(),
+                                         make_unique<NullTransport>("null://", "null://"));
+    face->setId(id);
+    return face;
+  }
+
+public:
+  shared_ptr<::nfd::Face> face1;
+  shared_ptr<::nfd::Face> face2;
+  shared_ptr<::nfd::Face> face3;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDNSIM_TESTS_UNIT_TESTS_NFD_NULL_FACE_FIXTURE_HPP
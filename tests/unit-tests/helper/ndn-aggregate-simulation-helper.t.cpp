@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "helper/ndn-aggregate-simulation-helper.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(HelperNdnAggregateSimulationHelper, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(Partitions)
+{
+  // Producers 0-7, rack aggregators 8-15, core aggregators 16-17
+  AggregateSimulationHelper helper;
+  helper.SetNodeCount(8);
+  helper.SetFanIn(4);
+  helper.SetPartitions(2, 1);
+  NodeContainer nodes = helper.CreateTopology();
+  BOOST_REQUIRE_EQUAL(nodes.GetN(), 18);
+
+  for (uint32_t rack = 0; rack < 8; ++rack) {
+    uint32_t systemId = rack < 4 ? 0 : 1;
+    BOOST_CHECK_EQUAL(nodes.Get(rack)->GetSystemId(), systemId);
+    BOOST_CHECK_EQUAL(nodes.Get(8 + rack)->GetSystemId(), systemId);
+  }
+  BOOST_CHECK_EQUAL(nodes.Get(16)->GetSystemId(), 0);
+  BOOST_CHECK_EQUAL(nodes.Get(17)->GetSystemId(), 1);
+
+  // Only links to core aggregators cross ranks
+  int nCrossLinks = 0;
+  for (uint32_t i = 0; i < nodes.GetN(); ++i) {
+    Ptr<Node> node = nodes.Get(i);
+    for (uint32_t d = 0; d < node->GetNDevices(); ++d) {
+      Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+      for (std::size_t c = 0; channel != nullptr && c < channel->GetNDevices(); ++c) {
+        Ptr<Node> peer = channel->GetDevice(c)->GetNode();
+        if (peer->GetId() > node->GetId() && peer->GetSystemId() != node->GetSystemId()) {
+          BOOST_CHECK_GE(peer->GetId(), 16);
+          ++nCrossLinks;
+        }
+      }
+    }
+  }
+  // Racks 1, 3 attach to core 17 from rank 0, racks 4, 6 to core 16 from rank 1, and a
+  // ring of two cores has two links
+  BOOST_CHECK_EQUAL(nCrossLinks, 6);
+}
+
+BOOST_AUTO_TEST_CASE(FatTree)
+{
+  // Hosts 0-15, edge switches 16-23, pod aggregation switches 24-31, cores 32-35
+  AggregateSimulationHelper helper;
+  helper.SetNodeCount(100);
+  helper.SetFatTree(4);
+  NodeContainer nodes = helper.CreateTopology();
+  BOOST_REQUIRE_EQUAL(nodes.GetN(), 36);
+  BOOST_CHECK_EQUAL(helper.GetProducerIds().size(), 16);
+  BOOST_CHECK_EQUAL(helper.GetProducerIds().back(), 15);
+
+  using NodeRole = AggregateUtils::NodeRole;
+  BOOST_CHECK(AggregateUtils::determineNodeRole(15) == NodeRole::PRODUCER);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(16) == NodeRole::RACK_AGG);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(24) == NodeRole::POD_AGG);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(35) == NodeRole::CORE_AGG);
+  BOOST_CHECK_EQUAL(AggregateUtils::getNodeRoleString(NodeRole::POD_AGG, 25), "A2");
+  BOOST_CHECK_EQUAL(AggregateUtils::getNodeRoleString(NodeRole::CORE_AGG, 32), "C1");
+  BOOST_CHECK_EQUAL(nodes.Get(24)->GetNDevices(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
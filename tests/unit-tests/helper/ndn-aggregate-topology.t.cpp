@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "helper/ndn-aggregate-topology.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+using NodeRole = AggregateTopology::NodeRole;
+
+BOOST_AUTO_TEST_SUITE(HelperNdnAggregateTopology)
+
+BOOST_AUTO_TEST_CASE(Racks)
+{
+  AggregateTopology topology = AggregateTopology::makeRacks(8, 4);
+  BOOST_CHECK_EQUAL(topology.getNodes().size(), 18);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::PRODUCER), 8);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::RACK_AGG), 8);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::CORE_AGG), 2);
+  // Producer-rack, rack-core and a ring of two cores
+  BOOST_REQUIRE_EQUAL(topology.getLinks().size(), 18);
+  BOOST_CHECK(topology.getLinks()[0] == std::make_pair(0u, 8u));
+  BOOST_CHECK(topology.getLinks()[9] == std::make_pair(9u, 17u));
+  BOOST_CHECK_EQUAL(topology.getNodes()[8].rack, 0);
+  BOOST_CHECK_EQUAL(topology.getNodes()[16].rack, -1);
+
+  AggregateTopology single = AggregateTopology::makeRacks(1, 4);
+  BOOST_CHECK_EQUAL(single.getNodes().size(), 2);
+  BOOST_CHECK_EQUAL(single.getLinks().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(FatTree)
+{
+  AggregateTopology topology = AggregateTopology::makeFatTree(4);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::PRODUCER), 16);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::RACK_AGG), 8);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::POD_AGG), 8);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::CORE_AGG), 4);
+  BOOST_CHECK_EQUAL(topology.getLinks().size(), 16 + 16 + 16);
+
+  // Every switch has k ports in use
+  std::vector<int> degrees(topology.getNodes().size(), 0);
+  for (const auto& link : topology.getLinks()) {
+    ++degrees[link.first];
+    ++degrees[link.second];
+  }
+  for (size_t i = 0; i < degrees.size(); ++i) {
+    BOOST_CHECK_EQUAL(degrees[i], topology.getNodes()[i].role == NodeRole::PRODUCER ? 1 : 4);
+  }
+
+  // Hosts come first and share the rack of their edge switch
+  BOOST_CHECK(topology.getNodes()[0].role == NodeRole::PRODUCER);
+  BOOST_CHECK_EQUAL(topology.getNodes()[1].rack, 0);
+  BOOST_CHECK_EQUAL(topology.getNodes()[2].rack, 1);
+
+  AggregateTopology wide = AggregateTopology::makeFatTree(4, 5);
+  BOOST_CHECK_EQUAL(wide.count(NodeRole::PRODUCER), 40);
+}
+
+BOOST_AUTO_TEST_CASE(LeafSpine)
+{
+  AggregateTopology topology = AggregateTopology::makeLeafSpine(4, 2, 3);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::PRODUCER), 12);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::RACK_AGG), 4);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::CORE_AGG), 2);
+  BOOST_CHECK_EQUAL(topology.getLinks().size(), 12 + 8);
+  BOOST_CHECK_EQUAL(topology.getNodes()[11].rack, 3);
+}
+
+BOOST_AUTO_TEST_CASE(Tree)
+{
+  AggregateTopology topology = AggregateTopology::makeTree(2, 3, 1);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::PRODUCER), 4);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::RACK_AGG), 4);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::POD_AGG), 2);
+  BOOST_CHECK_EQUAL(topology.count(NodeRole::CORE_AGG), 1);
+  BOOST_REQUIRE_EQUAL(topology.getLinks().size(), 4 + 4 + 2);
+  // Racks 4-7 under switches 8-9 under the root 10
+  BOOST_CHECK(topology.getLinks()[5] == std::make_pair(5u, 8u));
+  BOOST_CHECK(topology.getLinks()[6] == std::make_pair(6u, 9u));
+  BOOST_CHECK(topology.getLinks()[9] == std::make_pair(9u, 10u));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "helper/ndn-aggregate-tree-planner.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(HelperNdnAggregateTreePlanner)
+
+// Producers 0-7 behind racks 8-15; even racks attach to core 16, odd racks to core 17
+static AggregateTreePlanner
+makeRackPlanner(uint32_t levels)
+{
+  AggregateTreePlanner planner(4, levels);
+  for (uint32_t i = 0; i < 8; ++i) {
+    planner.addProducer(i, i + 1);
+    planner.addLink(i, 8 + i);
+    planner.addLink(8 + i, 16 + i % 2);
+    planner.addCandidate(8 + i);
+  }
+  planner.addLink(16, 17);
+  planner.addCandidate(16);
+  planner.addCandidate(17);
+  return planner;
+}
+
+BOOST_AUTO_TEST_CASE(TwoLevels)
+{
+  AggregateTreePlanner planner = makeRackPlanner(2);
+  BOOST_REQUIRE(planner.plan());
+  BOOST_CHECK_EQUAL(planner.getRoot(), 16);
+  BOOST_CHECK_EQUAL(planner.getLevelCount(), 2);
+
+  const auto& rules = planner.getRules();
+  const auto& root = rules.at(16);
+  BOOST_CHECK_EQUAL(root.level, 2);
+  BOOST_CHECK(!root.hasParent);
+  BOOST_CHECK(root.subtreeIds == AggregateIdSet({1, 2, 3, 4, 5, 6, 7, 8}));
+  BOOST_REQUIRE_EQUAL(root.children.size(), 5);
+  BOOST_CHECK_EQUAL(root.children.back().first, 17);
+  BOOST_CHECK(root.children.back().second == AggregateIdSet({2, 4, 6, 8}));
+
+  const auto& core = rules.at(17);
+  BOOST_CHECK_EQUAL(core.level, 1);
+  BOOST_CHECK(core.hasParent);
+  BOOST_CHECK_EQUAL(core.defaultUpward, 16);
+  BOOST_CHECK(core.subtreeIds == AggregateIdSet({2, 4, 6, 8}));
+
+  // Racks only relay: down to their producer, up to the core of their group
+  const auto& rack = rules.at(9);
+  BOOST_CHECK_EQUAL(rack.level, 0);
+  BOOST_REQUIRE_EQUAL(rack.children.size(), 1);
+  BOOST_CHECK_EQUAL(rack.children.front().first, 1);
+  BOOST_CHECK_EQUAL(rack.upward.at(1), 17);
+
+  const auto& producer = rules.at(1);
+  BOOST_CHECK(producer.hasParent);
+  BOOST_CHECK_EQUAL(producer.defaultUpward, 9);
+}
+
+BOOST_AUTO_TEST_CASE(SingleLevel)
+{
+  // One level: every producer is a direct child of the root, odd racks relay through core 17
+  AggregateTreePlanner planner = makeRackPlanner(1);
+  BOOST_REQUIRE(planner.plan());
+  BOOST_CHECK_EQUAL(planner.getLevelCount(), 1);
+
+  const auto& rules = planner.getRules();
+  const auto& relay = rules.at(17);
+  BOOST_CHECK_EQUAL(relay.level, 0);
+  BOOST_CHECK(relay.subtreeIds.empty());
+  BOOST_CHECK_EQUAL(relay.upward.at(9), 16);
+  BOOST_CHECK_EQUAL(rules.at(16).children.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(Objective)
+{
+  // Producers 0-2 hang off hub 3; producer 4 is three hops away, behind 5 and 6
+  for (auto objective : {AggregateTreePlanner::Objective::LATENCY,
+                         AggregateTreePlanner::Objective::LINK_LOAD}) {
+    AggregateTreePlanner planner(4, 1, objective);
+    for (uint32_t i = 0; i < 3; ++i) {
+      planner.addLink(i, 3);
+      planner.addProducer(i, i + 1);
+    }
+    planner.addLink(3, 5);
+    planner.addLink(5, 6);
+    planner.addLink(6, 4);
+    planner.addProducer(4, 4);
+    BOOST_REQUIRE(planner.plan());
+    // Node 5 is at most 2 hops from every producer, the hub has the fewest hops in total
+    BOOST_CHECK_EQUAL(planner.getRoot(), objective == AggregateTreePlanner::Objective::LATENCY ? 5 : 3);
+  }
+
+  AggregateTreePlanner::Objective parsed;
+  BOOST_CHECK(AggregateTreePlanner::parseObjective("link-load", parsed));
+  BOOST_CHECK(parsed == AggregateTreePlanner::Objective::LINK_LOAD);
+  BOOST_CHECK(!AggregateTreePlanner::parseObjective("bandwidth", parsed));
+}
+
+BOOST_AUTO_TEST_CASE(Unreachable)
+{
+  AggregateTreePlanner planner(2, 2);
+  planner.addLink(0, 2);
+  planner.addProducer(0, 1);
+  planner.addProducer(1, 2);
+  BOOST_CHECK(!planner.plan());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
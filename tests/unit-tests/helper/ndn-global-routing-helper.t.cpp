@@ -37,6 +37,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+
 namespace ns3 {
 namespace ndn {
 
@@ -186,6 +188,140 @@ BOOST_AUTO_TEST_CASE(CalculateRoutesBasedOnLinkDelay)
   }
 }
 
+BOOST_AUTO_TEST_CASE(ParallelAllPossibleRoutes)
+{
+  ofstream file1(TEST_TOPO_TXT.string().c_str());
+  file1 << "router\n\n"
+        << "#node city  y x mpi-partition\n"
+        << "A4  NA  1 1 1\n"
+        << "B4  NA  80  -40 1\n"
+        << "C4  NA  80  40  1\n"
+        << "D4  NA  160  -40 1\n"
+        << "E4  NA  160  40  1\n\n"
+        << "link\n\n"
+        << "# from  to  capacity  metric  delay queue\n"
+        << "A4      B4  10Mbps    1   1ms 100\n"
+        << "A4      C4  10Mbps    5   1ms 100\n"
+        << "B4      C4  10Mbps    1   1ms 100\n"
+        << "B4      D4  10Mbps    2   1ms 100\n"
+        << "C4      E4  10Mbps    1   1ms 100\n"
+        << "D4      E4  10Mbps    3   1ms 100\n";
+  file1.close();
+
+  AnnotatedTopologyReader topologyReader("");
+  topologyReader.SetFileName(TEST_TOPO_TXT.string().c_str());
+  topologyReader.Read();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+  topologyReader.ApplyOspfMetric();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+  const std::vector<std::string> prefixes{"/a", "/d", "/e"};
+  ndnGlobalRoutingHelper.AddOrigins(prefixes[0], Names::Find<Node>("A4"));
+  ndnGlobalRoutingHelper.AddOrigins(prefixes[1], Names::Find<Node>("D4"));
+  ndnGlobalRoutingHelper.AddOrigins(prefixes[2], Names::Find<Node>("E4"));
+
+  // (node, prefix, face, cost) of every route, in FIB order
+  auto dumpAndClearRoutes = [&] {
+    std::vector<std::string> routes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      auto& fib = (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+      for (const auto& entry : fib) {
+        for (const auto& nextHop : entry.getNextHops()) {
+          routes.push_back(Names::FindName(*node) + " " + entry.getPrefix().toUri() + " " +
+                           std::to_string(nextHop.getFace().getId()) + " " +
+                           std::to_string(nextHop.getCost()));
+        }
+      }
+      for (const auto& prefix : prefixes) {
+        fib.erase(prefix);
+      }
+    }
+    return routes;
+  };
+
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes();
+  std::vector<std::string> sequential = dumpAndClearRoutes();
+  BOOST_CHECK(!sequential.empty());
+
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutesParallel(3);
+  std::vector<std::string> parallel = dumpAndClearRoutes();
+  BOOST_CHECK_EQUAL_COLLECTIONS(parallel.begin(), parallel.end(), sequential.begin(), sequential.end());
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalRoutesOnLinkChange)
+{
+  ofstream file1(TEST_TOPO_TXT.string().c_str());
+  file1 << "router\n\n"
+        << "#node city  y x mpi-partition\n"
+        << "A5  NA  1 1 1\n"
+        << "B5  NA  80  -40 1\n"
+        << "C5  NA  80  40  1\n"
+        << "D5  NA  160  -40 1\n"
+        << "E5  NA  160  40  1\n\n"
+        << "link\n\n"
+        << "# from  to  capacity  metric  delay queue\n"
+        << "A5      B5  10Mbps    1   1ms 100\n"
+        << "A5      C5  10Mbps    5   1ms 100\n"
+        << "B5      C5  10Mbps    1   1ms 100\n"
+        << "B5      D5  10Mbps    2   1ms 100\n"
+        << "C5      E5  10Mbps    1   1ms 100\n"
+        << "D5      E5  10Mbps    3   1ms 100\n";
+  file1.close();
+
+  AnnotatedTopologyReader topologyReader("");
+  topologyReader.SetFileName(TEST_TOPO_TXT.string().c_str());
+  topologyReader.Read();
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+  topologyReader.ApplyOspfMetric();
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+  ndnGlobalRoutingHelper.AddOrigins("/a", Names::Find<Node>("A5"));
+  ndnGlobalRoutingHelper.AddOrigins("/d", Names::Find<Node>("D5"));
+  ndnGlobalRoutingHelper.AddOrigins("/e", Names::Find<Node>("E5"));
+
+  auto dumpRoutes = [] {
+    std::vector<std::string> routes;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      const auto& fib = (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+      for (const auto& entry : fib) {
+        for (const auto& nextHop : entry.getNextHops()) {
+          routes.push_back(Names::FindName(*node) + " " + entry.getPrefix().toUri() + " " +
+                           std::to_string(nextHop.getFace().getId()) + " " +
+                           std::to_string(nextHop.getCost()));
+        }
+      }
+    }
+    // Re-added next hops and entries may come back in another order
+    std::sort(routes.begin(), routes.end());
+    return routes;
+  };
+
+  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutesParallel(2);
+  std::vector<std::string> original = dumpRoutes();
+
+  Ptr<Node> a = Names::Find<Node>("A5");
+  Ptr<Node> b = Names::Find<Node>("B5");
+  auto& fib = a->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+  BOOST_CHECK_EQUAL(fib.findExactMatch("/d")->getNextHops().size(), 2);
+
+  ndn::GlobalRoutingHelper::UpdateRoutesOnLinkChange(a, b, false, 2);
+  const auto& nextHops = fib.findExactMatch("/d")->getNextHops();
+  BOOST_REQUIRE_EQUAL(nextHops.size(), 1);
+  // A5 -> C5 -> B5 -> D5
+  BOOST_CHECK_EQUAL(nextHops.front().getCost(), 8);
+  BOOST_CHECK_EQUAL(fib.findExactMatch("/e")->getNextHops().size(), 1);
+
+  ndn::GlobalRoutingHelper::UpdateRoutesOnLinkChange(a, b, true, 2);
+  std::vector<std::string> restored = dumpRoutes();
+  BOOST_CHECK_EQUAL_COLLECTIONS(restored.begin(), restored.end(), original.begin(), original.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -161,6 +161,65 @@ BOOST_AUTO_TEST_CASE(PrintLpPacket)
   }
 }
 
+BOOST_AUTO_TEST_CASE(DeserializeLargeBlock)
+{
+  Data data("/aggregate/ids=1-256/seq=1");
+  data.setContent(std::make_shared< ::ndn::Buffer>(4096, 0x5a));
+  ndn::StackHelper::getKeyChain().sign(data);
+  lp::Packet lpPacket(data.wireEncode());
+  Block wire = lpPacket.wireEncode();
+
+  // Bytes after the block (e.g., a trailer) must be left in the packet
+  Ptr<Packet> packet = Create<Packet>(16);
+  packet->AddHeader(BlockHeader(wire));
+
+  BlockHeader header;
+  BOOST_CHECK_EQUAL(packet->RemoveHeader(header), wire.size());
+  BOOST_CHECK_EQUAL(packet->GetSize(), 16);
+  BOOST_CHECK(header.getBlock() == wire);
+
+  ::ndn::Buffer::const_iterator first, last;
+  std::tie(first, last) = lp::Packet(header.getBlock()).get<lp::FragmentField>(0);
+  Data decoded(Block(::ndn::make_span(&*first, std::distance(first, last))));
+  BOOST_CHECK_EQUAL(decoded.getName(), data.getName());
+  BOOST_CHECK_EQUAL(decoded.getContent().value_size(), 4096);
+}
+
+BOOST_AUTO_TEST_CASE(SharedBlockCarriage)
+{
+  Interest interest("/prefix");
+  interest.setNonce(10);
+  Block wire = lp::Packet(interest.wireEncode()).wireEncode();
+
+  Ptr<Packet> packet = Create<Packet>(wire.size());
+  packet->AddPacketTag(SharedBlockTag(wire));
+  BOOST_CHECK_EQUAL(packet->GetSize(), wire.size());
+
+  // A copy made on the way refers to the same Block
+  Ptr<Packet> copy = packet->Copy();
+  SharedBlockTag tag;
+  BOOST_REQUIRE(copy->PeekPacketTag(tag));
+  Block received = tag.getBlock();
+  BOOST_CHECK(received == wire);
+  BOOST_CHECK_EQUAL(received.wire(), wire.wire());
+
+  tag.release();
+  BOOST_CHECK(!tag.getBlock().isValid());
+  BOOST_CHECK(received == wire);
+}
+
+BOOST_AUTO_TEST_CASE(SharedBlockClearedOnDestroy)
+{
+  Interest interest("/prefix");
+  interest.setNonce(10);
+  SharedBlockTag tag(lp::Packet(interest.wireEncode()).wireEncode());
+  BOOST_CHECK(tag.getBlock().isValid());
+
+  // Expiry times restart with the next simulation, so nothing may survive this one
+  Simulator::Destroy();
+  BOOST_CHECK(!tag.getBlock().isValid());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -21,8 +21,10 @@
 #define NDNSIM_TESTS_UNIT_TESTS_TESTS_COMMON_HPP
 
 #include "ns3/core-module.h"
+#include "model/ndn-block-header.hpp"
 #include "model/ndn-global-router.hpp"
 #include "helper/ndn-scenario-helper.hpp"
+#include "utils/ndn-aggregate-utils.hpp"
 
 #include "boost-test.hpp"
 
@@ -37,6 +39,8 @@ public:
     Simulator::Destroy();
     Names::Clear();
     GlobalRouter::clear();
+    SharedBlockTag::clear();
+    AggregateUtils::clearNodeRoles();
   }
 };
 
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-aggregate-event-sink.hpp"
+
+#include "../tests-common.hpp"
+
+#include <sstream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(UtilsNdnAggregateEventSink)
+
+BOOST_AUTO_TEST_CASE(MaskFiltersEvents)
+{
+  AggregateEventSink& sink = AggregateEventSink::getInstance();
+  BOOST_CHECK(!sink.isEnabled(AggregateEventType::CACHE_HIT));
+
+  std::vector<AggregateEventType> received;
+  sink.setCallback([&received] (const AggregateEvent& event) { received.push_back(event.type); },
+                   AggregateEventSink::getMask(AggregateEventType::CACHE_HIT));
+  BOOST_CHECK(sink.isEnabled(AggregateEventType::CACHE_HIT));
+  BOOST_CHECK(!sink.isEnabled(AggregateEventType::PIGGYBACK));
+
+  ::ndn::Name name("/aggregate/ids=1-4/seq=0");
+  sink.emit({1.0, 5, AggregateEventType::PIGGYBACK, name, 0, 4});
+  sink.emit({1.0, 5, AggregateEventType::CACHE_HIT, name, 257, 2});
+  BOOST_REQUIRE_EQUAL(received.size(), 1);
+  BOOST_CHECK(received.front() == AggregateEventType::CACHE_HIT);
+
+  sink.reset();
+  BOOST_CHECK(!sink.isEnabled(AggregateEventType::CACHE_HIT));
+  sink.emit({1.0, 5, AggregateEventType::CACHE_HIT, name, 257, 2});
+  BOOST_CHECK_EQUAL(received.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ParseMask)
+{
+  uint32_t mask = 0;
+  BOOST_CHECK(AggregateEventSink::parseMask("all", mask));
+  BOOST_CHECK_EQUAL(mask, AggregateEventSink::ALL_EVENTS);
+
+  BOOST_CHECK(AggregateEventSink::parseMask("sub-interest-sent,pit-expired", mask));
+  BOOST_CHECK_EQUAL(mask, AggregateEventSink::getMask(AggregateEventType::SUB_INTEREST_SENT) |
+                          AggregateEventSink::getMask(AggregateEventType::PIT_EXPIRED));
+
+  mask = 7;
+  BOOST_CHECK(!AggregateEventSink::parseMask("cache-hit,bogus", mask));
+  BOOST_CHECK_EQUAL(mask, 7);
+}
+
+BOOST_AUTO_TEST_CASE(WriteTsv)
+{
+  ::ndn::Name name("/aggregate/ids=1-4/seq=3");
+  std::ostringstream os;
+  AggregateEventSink::writeTsv(os, {2.5, 7, AggregateEventType::AGGREGATE_SENT, name, 259, 4});
+  BOOST_CHECK_EQUAL(os.str(), "2.500000\t7\taggregate-sent\t/aggregate/ids=1-4/seq=3\t259\t4\n");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-aggregate-id-set.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(UtilsNdnAggregateIdSet)
+
+BOOST_AUTO_TEST_CASE(InsertErase)
+{
+  AggregateIdSet ids;
+  BOOST_CHECK(ids.empty());
+  BOOST_CHECK_EQUAL(ids.min(), -1);
+
+  BOOST_CHECK(ids.insert(3));
+  BOOST_CHECK(!ids.insert(3));
+  BOOST_CHECK(ids.insert(1));
+  BOOST_CHECK(!ids.insert(-1));
+  BOOST_CHECK_EQUAL(ids.size(), 2);
+  BOOST_CHECK(ids.contains(3));
+  BOOST_CHECK_EQUAL(ids.count(2), 0);
+
+  BOOST_CHECK_EQUAL(ids.erase(3), 1);
+  BOOST_CHECK_EQUAL(ids.erase(3), 0);
+  BOOST_CHECK_EQUAL(ids.size(), 1);
+  BOOST_CHECK_EQUAL(ids.toString(), "{ 1 }");
+}
+
+BOOST_AUTO_TEST_CASE(SpillToHeap)
+{
+  AggregateIdSet ids{1, 64, 200, 1000};
+  BOOST_CHECK_GT(ids.getWordCount(), AggregateIdSet::INLINE_WORDS);
+  BOOST_CHECK_EQUAL(ids.size(), 4);
+  BOOST_CHECK_EQUAL(ids.min(), 1);
+  BOOST_CHECK_EQUAL(ids.max(), 1000);
+
+  std::vector<int> expected{1, 64, 200, 1000};
+  std::vector<int> actual(ids.begin(), ids.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(actual.begin(), actual.end(), expected.begin(), expected.end());
+
+  AggregateIdSet moved(std::move(ids));
+  BOOST_CHECK_EQUAL(moved.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(SetAlgebra)
+{
+  AggregateIdSet a{1, 2, 3, 300};
+  AggregateIdSet b{2, 3};
+  AggregateIdSet c{4};
+
+  BOOST_CHECK(b.isSubsetOf(a));
+  BOOST_CHECK(!a.isSubsetOf(b));
+  BOOST_CHECK(a.intersects(b));
+  BOOST_CHECK(!a.intersects(c));
+
+  AggregateIdSet u = b;
+  u.unionWith(c);
+  BOOST_CHECK(u == AggregateIdSet({2, 3, 4}));
+
+  AggregateIdSet i = a;
+  i.intersectWith(b);
+  BOOST_CHECK(i == b);
+
+  AggregateIdSet d = a;
+  d.subtract(b);
+  BOOST_CHECK(d == AggregateIdSet({1, 300}));
+}
+
+BOOST_AUTO_TEST_CASE(EqualityIgnoresCapacity)
+{
+  AggregateIdSet small{5, 7};
+  AggregateIdSet large{5, 7, 500};
+  large.erase(500);
+
+  BOOST_CHECK(small == large);
+  BOOST_CHECK_EQUAL(small.hash(), large.hash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-aggregate-operator.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(UtilsNdnAggregateOperator)
+
+static AggregateOpSpec
+makeSpec(const std::string& text)
+{
+  AggregateOpSpec spec;
+  BOOST_REQUIRE(AggregateOpSpec::fromComponent(::ndn::Name::Component("op=" + text), spec));
+  return spec;
+}
+
+static AggregateState
+roundTrip(const AggregateState& state)
+{
+  std::vector<uint8_t> wire = state.encode();
+  return AggregateState::fromContent(wire.data(), wire.size(), state.getSpec());
+}
+
+BOOST_AUTO_TEST_CASE(ScalarOperators)
+{
+  const uint64_t samples[] = {7, 3, 9, 5};
+
+  AggregateState sum(makeSpec("sum"));
+  AggregateState min(makeSpec("min"));
+  AggregateState max(makeSpec("max"));
+  AggregateState count(makeSpec("count"));
+  AggregateState mean(makeSpec("mean"));
+  for (AggregateState* state : {&sum, &min, &max, &count, &mean}) {
+    state->addSamples(samples, 4);
+  }
+
+  BOOST_CHECK_EQUAL(sum.getResult(), 24);
+  BOOST_CHECK_EQUAL(min.getResult(), 3);
+  BOOST_CHECK_EQUAL(max.getResult(), 9);
+  BOOST_CHECK_EQUAL(count.getResult(), 4);
+  BOOST_CHECK_EQUAL(mean.getResult(), 6);
+
+  // SUM stays wire compatible with the plain 8-byte value
+  BOOST_CHECK_EQUAL(sum.encode().size(), 8);
+}
+
+BOOST_AUTO_TEST_CASE(MergeEncodedPartials)
+{
+  AggregateOpSpec spec = makeSpec("mean");
+  AggregateState left(spec);
+  left.addSample(2);
+  AggregateState right(spec);
+  right.addSample(4);
+  right.addSample(6);
+
+  AggregateState total = roundTrip(left);
+  total.merge(roundTrip(right));
+  BOOST_CHECK_EQUAL(total.getCount(), 3);
+  BOOST_CHECK_EQUAL(total.getResult(), 4);
+
+  // Partials of another operator are ignored
+  AggregateState other(makeSpec("max"));
+  other.addSample(100);
+  std::vector<uint8_t> wire = other.encode();
+  BOOST_CHECK_EQUAL(AggregateState::fromContent(wire.data(), wire.size(), spec).getCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Subtract)
+{
+  // A node answers a subset from a larger in-flight aggregate minus the extra IDs
+  for (const std::string& op : {"sum", "mean", "count", "hist,0,10,4"}) {
+    AggregateOpSpec spec = makeSpec(op);
+    AggregateState total(spec);
+    AggregateState extra(spec);
+    AggregateState expected(spec);
+    for (uint64_t value : {4, 17, 25}) {
+      total.addSample(value);
+      expected.addSample(value);
+    }
+    extra.addSample(32);
+    total.merge(extra);
+
+    AggregateState decoded = roundTrip(total);
+    BOOST_CHECK(decoded.isInvertible());
+    BOOST_CHECK(decoded.subtract(roundTrip(extra)));
+    BOOST_CHECK_EQUAL(decoded.toString(), expected.toString());
+  }
+
+  AggregateState partial(makeSpec("mean"));
+  partial.addSample(1);
+  AggregateState larger(makeSpec("mean"));
+  larger.addSample(1);
+  larger.addSample(2);
+  BOOST_CHECK(!partial.subtract(larger));
+  BOOST_CHECK_EQUAL(partial.getCount(), 1);
+
+  AggregateState max(makeSpec("max"));
+  max.addSample(3);
+  BOOST_CHECK(!max.isInvertible());
+  BOOST_CHECK(!max.subtract(max));
+  BOOST_CHECK(!AggregateState(makeSpec("sum,i64,2")).isInvertible());
+}
+
+BOOST_AUTO_TEST_CASE(Histogram)
+{
+  AggregateOpSpec spec = makeSpec("hist,10,5,3");
+  BOOST_CHECK_EQUAL(spec.histogram.lower, 10);
+  BOOST_CHECK_EQUAL(spec.histogram.width, 5);
+  BOOST_CHECK_EQUAL(spec.histogram.bucketCount, 3);
+  BOOST_CHECK(spec.toComponent() == ::ndn::Name::Component("op=hist,10,5,3"));
+
+  AggregateState state(spec);
+  for (uint64_t value : {0, 12, 15, 16, 99}) {
+    state.addSample(value);
+  }
+  AggregateState decoded = roundTrip(state);
+  std::vector<uint64_t> expected{2, 2, 1};
+  BOOST_CHECK_EQUAL_COLLECTIONS(decoded.getBuckets().begin(), decoded.getBuckets().end(),
+                                expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(decoded.toString(), "hist=[2 2 1]");
+}
+
+BOOST_AUTO_TEST_CASE(VectorOperators)
+{
+  AggregateOpSpec spec = makeSpec("sum,f32,5");
+  BOOST_CHECK(spec.isVector());
+  BOOST_CHECK_EQUAL(spec.getVectorSize(), 20);
+  BOOST_CHECK(spec.toComponent() == ::ndn::Name::Component("op=sum,f32,5"));
+
+  const float left[] = {1, 2, 3, 4, 5};
+  const float right[] = {0.5, 0.5, 0.5, 0.5, -5};
+  AggregateState sum(spec);
+  BOOST_CHECK(sum.addVector(reinterpret_cast<const uint8_t*>(left), sizeof(left)));
+  BOOST_CHECK(!sum.addVector(reinterpret_cast<const uint8_t*>(left), sizeof(left) - 4));
+  AggregateState partial(spec);
+  partial.addVector(reinterpret_cast<const uint8_t*>(right), sizeof(right));
+  sum.merge(roundTrip(partial));
+  BOOST_CHECK_EQUAL(sum.getCount(), 2);
+  BOOST_CHECK_EQUAL(sum.encode().size(), sizeof(left));
+  BOOST_CHECK_EQUAL(sum.toString(), "sum[f32x5]=[1.5 2.5 3.5 4.5 0]");
+
+  const int64_t samples[] = {5, -7, 9};
+  AggregateState min(makeSpec("min,i64,3"));
+  AggregateState max(makeSpec("max,i64,3"));
+  // An empty state holds the identity, so the first sample passes through
+  min.addVector(reinterpret_cast<const uint8_t*>(samples), sizeof(samples));
+  max.addVector(reinterpret_cast<const uint8_t*>(samples), sizeof(samples));
+  BOOST_CHECK_EQUAL(roundTrip(min).toString(), "min[i64x3]=[5 -7 9]");
+  BOOST_CHECK_EQUAL(roundTrip(max).toString(), "max[i64x3]=[5 -7 9]");
+
+  AggregateOpSpec bad;
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=mean,f32,4"), bad));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,f16,4"), bad));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,f32,0"), bad));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,i64,4000000000"), bad));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,i64,65537"), bad));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,i32,-1"), bad));
+  BOOST_CHECK(makeSpec("sum,f32,4") != makeSpec("sum,f64,4"));
+}
+
+BOOST_AUTO_TEST_CASE(Select)
+{
+  AggregateOpSpec spec;
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=median"), spec));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=min,1"), spec));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=hist,1,0,4"), spec));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=hist,0,1,4000000000"), spec));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=hist,0,1,-1"), spec));
+  BOOST_CHECK(!AggregateOpSpec::fromComponent(::ndn::Name::Component("op=hist,-5,1,4"), spec));
+  BOOST_CHECK(AggregateOpSpec::fromComponent(::ndn::Name::Component("op=hist,0,1,4096"), spec));
+
+  BOOST_CHECK(AggregateOpSpec::select("/aggregate/1/op=max/seq=0").op == AggregateOp::MAX);
+  BOOST_CHECK(AggregateOpSpec::select("/telemetry/1").op == AggregateOp::SUM);
+
+  AggregateOpSpec minSpec;
+  minSpec.op = AggregateOp::MIN;
+  AggregateOpSpec::setDefault("/telemetry", minSpec);
+  BOOST_CHECK(AggregateOpSpec::select("/telemetry/1").op == AggregateOp::MIN);
+  BOOST_CHECK(AggregateOpSpec::select("/telemetry/1/op=count").op == AggregateOp::COUNT);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
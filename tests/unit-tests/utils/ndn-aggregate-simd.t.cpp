@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-aggregate-simd.hpp"
+
+#include "../tests-common.hpp"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(UtilsNdnAggregateSimd)
+
+BOOST_AUTO_TEST_CASE(KernelsMatchScalar)
+{
+  const AggregateElementType types[] = {AggregateElementType::INT32, AggregateElementType::INT64,
+                                        AggregateElementType::FLOAT32, AggregateElementType::FLOAT64};
+  const AggregateSimd::Reduction reductions[] = {AggregateSimd::Reduction::ADD,
+                                                 AggregateSimd::Reduction::MIN,
+                                                 AggregateSimd::Reduction::MAX};
+
+  for (AggregateElementType type : types) {
+    size_t elementSize = AggregateSimd::getElementSize(type);
+    for (AggregateSimd::Reduction reduction : reductions) {
+      // Lengths around the register widths exercise both the vector body and the tail
+      for (size_t count : {1, 3, 4, 8, 9, 17, 100}) {
+        // Offset by one byte so that neither buffer is aligned
+        std::vector<uint8_t> dst(count * elementSize + 1);
+        std::vector<uint8_t> src(count * elementSize + 1);
+        for (size_t i = 0; i < count; ++i) {
+          double a = static_cast<double>(i % 7) - 3;
+          double b = static_cast<double>(i % 5) * 1.5 - 4;
+          switch (type) {
+            case AggregateElementType::INT32: {
+              int32_t x = static_cast<int32_t>(a), y = static_cast<int32_t>(b);
+              std::memcpy(&dst[1 + i * 4], &x, 4);
+              std::memcpy(&src[1 + i * 4], &y, 4);
+              break;
+            }
+            case AggregateElementType::INT64: {
+              int64_t x = static_cast<int64_t>(a) << 33, y = static_cast<int64_t>(b) << 33;
+              std::memcpy(&dst[1 + i * 8], &x, 8);
+              std::memcpy(&src[1 + i * 8], &y, 8);
+              break;
+            }
+            case AggregateElementType::FLOAT32: {
+              float x = static_cast<float>(a), y = static_cast<float>(b);
+              std::memcpy(&dst[1 + i * 4], &x, 4);
+              std::memcpy(&src[1 + i * 4], &y, 4);
+              break;
+            }
+            case AggregateElementType::FLOAT64:
+              std::memcpy(&dst[1 + i * 8], &a, 8);
+              std::memcpy(&src[1 + i * 8], &b, 8);
+              break;
+          }
+        }
+
+        std::vector<uint8_t> expected = dst;
+        AggregateSimd::reduceScalar(reduction, type, expected.data() + 1, src.data() + 1, count);
+        AggregateSimd::reduce(reduction, type, dst.data() + 1, src.data() + 1, count);
+        BOOST_CHECK_EQUAL_COLLECTIONS(dst.begin(), dst.end(), expected.begin(), expected.end());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(IdentityAndWrapping)
+{
+  int32_t values[2];
+  AggregateSimd::fillIdentity(AggregateSimd::Reduction::MIN, AggregateElementType::INT32,
+                              reinterpret_cast<uint8_t*>(values), 2);
+  BOOST_CHECK_EQUAL(values[0], std::numeric_limits<int32_t>::max());
+
+  const int32_t one[2] = {1, 1};
+  AggregateSimd::reduce(AggregateSimd::Reduction::ADD, AggregateElementType::INT32,
+                        reinterpret_cast<uint8_t*>(values), reinterpret_cast<const uint8_t*>(one), 2);
+  BOOST_CHECK_EQUAL(values[1], std::numeric_limits<int32_t>::min());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
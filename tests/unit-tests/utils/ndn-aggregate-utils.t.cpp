@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2019  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "utils/ndn-aggregate-utils.hpp"
+#include "helper/ndn-stack-helper.hpp"
+
+#include <ndn-cxx/util/sha256.hpp>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_AUTO_TEST_SUITE(UtilsNdnAggregateUtils)
+
+BOOST_AUTO_TEST_CASE(ParsePerComponentIds)
+{
+  ::ndn::Name name("/aggregate");
+  name.appendNumber(3).appendNumber(10).appendNumber(300).append("seq=7");
+
+  BOOST_CHECK(AggregateUtils::parseNumbersFromName(name) == AggregateIdSet({3, 10, 300}));
+  BOOST_CHECK(AggregateUtils::parseNumbersFromName("/aggregate/4/12") == AggregateIdSet({4, 12}));
+
+  // The first byte of these is the 0xFE sequence-number marker
+  ::ndn::Name high("/aggregate");
+  high.appendNumber(65024).appendNumber(65279).append("seq=1");
+  BOOST_CHECK(AggregateUtils::parseNumbersFromName(high) == AggregateIdSet({65024, 65279}));
+}
+
+BOOST_AUTO_TEST_CASE(RangeComponent)
+{
+  AggregateIdSet ids;
+  for (int id = 1; id <= 1000; ++id) {
+    if (id != 5) {
+      ids.insert(id);
+    }
+  }
+
+  ::ndn::Name::Component component = AggregateUtils::encodeIdSetComponent(ids);
+  BOOST_CHECK_EQUAL(std::string(reinterpret_cast<const char*>(component.value()), component.value_size()),
+                    "ids=1-4,6-1000");
+
+  AggregateIdSet decoded;
+  BOOST_CHECK(AggregateUtils::decodeIdSetComponent(component, decoded));
+  BOOST_CHECK(decoded == ids);
+}
+
+BOOST_AUTO_TEST_CASE(BitmapComponent)
+{
+  AggregateIdSet ids;
+  for (int id = 1; id <= 300; id += 2) {
+    ids.insert(id);
+  }
+
+  ::ndn::Name::Component component = AggregateUtils::encodeIdSetComponent(ids);
+  BOOST_CHECK_EQUAL(component.value_size(), 4 + 300 / 8 + 1);
+
+  AggregateIdSet decoded;
+  BOOST_CHECK(AggregateUtils::decodeIdSetComponent(component, decoded));
+  BOOST_CHECK(decoded == ids);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedRanges)
+{
+  for (const char* text : {"ids=1-", "ids=3-1", "ids=1,", "ids=1,,2", "ids=x", "seq=1",
+                           "ids=0-2000000000", "ids=1-1048576,1-1048576"}) {
+    AggregateIdSet decoded;
+    BOOST_CHECK(!AggregateUtils::decodeIdSetComponent(::ndn::Name::Component(text), decoded));
+    BOOST_CHECK(decoded.empty());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AppendIdSet)
+{
+  AggregateIdSet ids{1, 2, 3, 7};
+
+  ::ndn::Name compact("/aggregate");
+  AggregateUtils::appendIdSet(compact, ids);
+  BOOST_CHECK_EQUAL(compact.size(), 2);
+  BOOST_CHECK(AggregateUtils::parseNumbersFromName(compact) == ids);
+
+  // A single ID stays a plain ID component so it matches the producer route
+  ::ndn::Name single("/aggregate");
+  AggregateUtils::appendIdSet(single, AggregateIdSet{42});
+  BOOST_CHECK_EQUAL(single, "/aggregate/42");
+  int id = 0;
+  BOOST_CHECK(AggregateUtils::decodeIdComponent(single[-1], id));
+  BOOST_CHECK_EQUAL(id, 42);
+
+  AggregateUtils::setIdEncoding(AggregateUtils::IdEncoding::PER_COMPONENT);
+  ::ndn::Name legacy("/aggregate");
+  AggregateUtils::appendIdSet(legacy, ids);
+  AggregateUtils::setIdEncoding(AggregateUtils::IdEncoding::COMPACT);
+  BOOST_CHECK_EQUAL(legacy.size(), 5);
+  BOOST_CHECK(AggregateUtils::parseNumbersFromName(legacy) == ids);
+}
+
+BOOST_AUTO_TEST_CASE(DataTemplateMatchesKeyChain)
+{
+  ::ndn::Name name("/aggregate/ids=1-4/seq=3");
+  auto data = AggregateUtils::createDataWithValue(name, 42);
+  BOOST_CHECK_EQUAL(data->getName(), name);
+  BOOST_CHECK_EQUAL(AggregateUtils::extractValueFromContent(*data), 42);
+  BOOST_CHECK_EQUAL(data->getFreshnessPeriod(), ::ndn::time::milliseconds(1000));
+
+  // The template must produce the same wire as the regular set-and-sign path
+  ::ndn::Data expected(name);
+  expected.setContent(data->getContent().value_bytes());
+  expected.setFreshnessPeriod(::ndn::time::milliseconds(1000));
+  StackHelper::getKeyChain().sign(expected);
+  BOOST_CHECK(data->wireEncode() == expected.wireEncode());
+
+  AggregateOpSpec spec;
+  spec.op = AggregateOp::MAX;
+  AggregateState state(spec);
+  state.addSample(7);
+  auto stateData = AggregateUtils::createDataWithState(name, state);
+  BOOST_CHECK_EQUAL(AggregateUtils::extractStateFromContent(*stateData, spec).getResult(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(PartialData)
+{
+  ::ndn::Name name("/aggregate/ids=1-8/seq=2");
+  AggregateOpSpec spec;
+  AggregateState state(spec);
+  state.addSample(5);
+  state.addSample(6);
+
+  // Without missing IDs the content is the plain state
+  AggregateIdSet missingIds;
+  auto complete = AggregateUtils::createPartialData(name, state, missingIds);
+  BOOST_CHECK_EQUAL(complete->getContent().value_size(), 8);
+  BOOST_CHECK_EQUAL(AggregateUtils::extractStateFromContent(*complete, spec, missingIds).getResult(), 11);
+  BOOST_CHECK(missingIds.empty());
+
+  auto partial = AggregateUtils::createPartialData(name, state, AggregateIdSet{3, 4, 7});
+  BOOST_CHECK_EQUAL(AggregateUtils::extractStateFromContent(*partial, spec).getResult(), 11);
+  missingIds = AggregateIdSet{1};
+  BOOST_CHECK_EQUAL(AggregateUtils::extractStateFromContent(*partial, spec, missingIds).getResult(), 11);
+  BOOST_CHECK(missingIds == (AggregateIdSet{1, 3, 4, 7}));
+
+  AggregateOpSpec vectorSpec;
+  BOOST_REQUIRE(AggregateOpSpec::fromComponent(::ndn::Name::Component("op=sum,i64,2"), vectorSpec));
+  AggregateState vectorState(vectorSpec);
+  std::vector<uint8_t> sample = AggregateUtils::makeVectorSample(vectorSpec, 10);
+  vectorState.addVector(sample.data(), sample.size());
+  auto vectorPartial = AggregateUtils::createPartialData(name, vectorState, AggregateIdSet{2});
+  missingIds.clear();
+  AggregateState decoded = AggregateUtils::extractStateFromContent(*vectorPartial, vectorSpec, missingIds);
+  BOOST_CHECK_EQUAL(decoded.toString(), vectorState.toString());
+  BOOST_CHECK(missingIds == AggregateIdSet{2});
+}
+
+BOOST_AUTO_TEST_CASE(SigningPolicies)
+{
+  AggregateDataTemplate dataTemplate(::ndn::time::milliseconds(1000));
+  ::ndn::Name name("/aggregate/ids=1-4/seq=3");
+
+  dataTemplate.setSigningPolicy(AggregateSigningPolicy::DIGEST_SHA256);
+  auto digestData = dataTemplate.makeData(name, uint64_t(5));
+  BOOST_CHECK_EQUAL(digestData->getSignatureType(), ::ndn::tlv::DigestSha256);
+  auto signedPortion = digestData->extractSignedRanges();
+  ::ndn::util::Sha256 digest;
+  for (const auto& range : signedPortion) {
+    digest.update(range);
+  }
+  BOOST_CHECK(*digest.computeDigest() == ::ndn::Buffer(digestData->getSignatureValue().value_begin(),
+                                                       digestData->getSignatureValue().value_end()));
+
+  dataTemplate.setSigningPolicy(AggregateSigningPolicy::FAKE);
+  auto fakeData = dataTemplate.makeData(name, uint64_t(5));
+  BOOST_CHECK_EQUAL(fakeData->getSignatureType(), 255);
+  BOOST_CHECK_EQUAL(fakeData->getSignatureValue().value_size(), 1);
+  BOOST_CHECK_EQUAL(AggregateUtils::extractValueFromContent(*fakeData), 5);
+
+  dataTemplate.setSigningPolicy(AggregateSigningPolicy::NONE);
+  BOOST_CHECK_EQUAL(dataTemplate.makeData(name, uint64_t(5))->getSignatureValue().value_size(), 0);
+
+  AggregateSigningPolicy policy;
+  BOOST_CHECK(AggregateDataTemplate::parseSigningPolicy("digest", policy));
+  BOOST_CHECK(policy == AggregateSigningPolicy::DIGEST_SHA256);
+  BOOST_CHECK(!AggregateDataTemplate::parseSigningPolicy("rsa", policy));
+}
+
+BOOST_FIXTURE_TEST_CASE(NodeRoleRegistry, CleanupFixture)
+{
+  using NodeRole = AggregateUtils::NodeRole;
+
+  // Non-uniform layout: two producers under one rack, a core in between
+  AggregateUtils::registerNodeRole(0, NodeRole::PRODUCER, 1);
+  AggregateUtils::registerNodeRole(1, NodeRole::PRODUCER, 2);
+  AggregateUtils::registerNodeRole(2, NodeRole::CORE_AGG, 1);
+  AggregateUtils::registerNodeRole(4, NodeRole::RACK_AGG, 1);
+
+  BOOST_CHECK(AggregateUtils::determineNodeRole(1) == NodeRole::PRODUCER);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(2) == NodeRole::CORE_AGG);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(3) == NodeRole::UNKNOWN);
+  BOOST_CHECK(AggregateUtils::determineNodeRole(9) == NodeRole::UNKNOWN);
+  BOOST_CHECK_EQUAL(AggregateUtils::getLogicalId(1), 2);
+  BOOST_CHECK_EQUAL(AggregateUtils::getLogicalId(4), 1);
+  BOOST_CHECK_EQUAL(AggregateUtils::getNodeRoleString(NodeRole::RACK_AGG, 4), "R1");
+  BOOST_CHECK_EQUAL(AggregateUtils::getNodeRoleString(NodeRole::CORE_AGG, 2), "C1");
+
+  AggregateUtils::clearNodeRoles();
+  BOOST_CHECK(AggregateUtils::determineNodeRole(0) == NodeRole::PRODUCER);
+  BOOST_CHECK_EQUAL(AggregateUtils::getLogicalId(0), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,151 @@
+#include "ndn-aggregate-data-template.hpp"
+
+#include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/meta-info.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/sha256.hpp>
+
+#include <endian.h>
+#include <stdexcept>
+
+namespace ns3 {
+namespace ndn {
+
+AggregateDataTemplate::AggregateDataTemplate(::ndn::time::milliseconds freshnessPeriod)
+  : m_freshnessPeriod(freshnessPeriod)
+{
+}
+
+void
+AggregateDataTemplate::setSigningPolicy(AggregateSigningPolicy policy)
+{
+  m_signingPolicy = policy;
+  m_isPrepared = false;
+}
+
+bool
+AggregateDataTemplate::parseSigningPolicy(const std::string& text, AggregateSigningPolicy& policy)
+{
+  if (text == "keychain") {
+    policy = AggregateSigningPolicy::KEYCHAIN;
+  }
+  else if (text == "digest") {
+    policy = AggregateSigningPolicy::DIGEST_SHA256;
+  }
+  else if (text == "fake") {
+    policy = AggregateSigningPolicy::FAKE;
+  }
+  else if (text == "none") {
+    policy = AggregateSigningPolicy::NONE;
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
+void
+AggregateDataTemplate::prepare()
+{
+  ::ndn::MetaInfo metaInfo;
+  metaInfo.setFreshnessPeriod(m_freshnessPeriod);
+  m_metaInfo = metaInfo.wireEncode();
+
+  // Same fake signature type as ndn::Producer
+  static const auto FAKE_SIGNATURE_TYPE = static_cast<::ndn::tlv::SignatureTypeValue>(255);
+  static const uint8_t FAKE_SIGNATURE_VALUE[] = {0};
+
+  switch (m_signingPolicy) {
+    case AggregateSigningPolicy::KEYCHAIN: {
+      ::ndn::KeyChain& keyChain = StackHelper::getKeyChain();
+      // Sign one probe packet the usual way to learn the SignatureInfo the KeyChain would use
+      ::ndn::Data probe("/aggregate");
+      keyChain.sign(probe);
+      m_signatureInfo = probe.getSignatureInfo().wireEncode();
+      m_signatureSize = probe.getSignatureValue().value_size();
+      m_keyName = keyChain.getPib().getDefaultIdentity().getDefaultKey().getName();
+      break;
+    }
+    case AggregateSigningPolicy::DIGEST_SHA256:
+      m_signatureInfo = ::ndn::SignatureInfo(::ndn::tlv::DigestSha256).wireEncode();
+      m_signatureSize = ::ndn::util::Sha256::DIGEST_SIZE;
+      break;
+    case AggregateSigningPolicy::FAKE:
+      m_signatureInfo = ::ndn::SignatureInfo(FAKE_SIGNATURE_TYPE).wireEncode();
+      m_signatureValue = std::make_shared<::ndn::Buffer>(FAKE_SIGNATURE_VALUE,
+                                                         sizeof(FAKE_SIGNATURE_VALUE));
+      m_signatureSize = m_signatureValue->size();
+      break;
+    case AggregateSigningPolicy::NONE:
+      m_signatureInfo = ::ndn::SignatureInfo(FAKE_SIGNATURE_TYPE).wireEncode();
+      m_signatureValue = std::make_shared<::ndn::Buffer>();
+      m_signatureSize = 0;
+      break;
+  }
+
+  m_isPrepared = true;
+}
+
+std::shared_ptr<::ndn::Data>
+AggregateDataTemplate::makeData(const ::ndn::Name& name, ::ndn::span<const uint8_t> content)
+{
+  if (!m_isPrepared) {
+    prepare();
+  }
+
+  ::ndn::EncodingEstimator estimator;
+  size_t unsignedSize = name.wireEncode(estimator) + m_metaInfo.size() + m_signatureInfo.size() +
+                        ::ndn::tlv::sizeOfVarNumber(::ndn::tlv::Content) +
+                        ::ndn::tlv::sizeOfVarNumber(content.size()) + content.size();
+  size_t signatureValueSize = ::ndn::tlv::sizeOfVarNumber(::ndn::tlv::SignatureValue) +
+                              ::ndn::tlv::sizeOfVarNumber(m_signatureSize) + m_signatureSize;
+  size_t dataHeaderSize = ::ndn::tlv::sizeOfVarNumber(::ndn::tlv::Data) +
+                          ::ndn::tlv::sizeOfVarNumber(unsignedSize + signatureValueSize);
+
+  // Elements are prepended in reverse order; the SignatureValue is appended after signing
+  ::ndn::EncodingBuffer encoder(dataHeaderSize + unsignedSize + signatureValueSize,
+                                signatureValueSize);
+  ::ndn::encoding::prependBlock(encoder, m_signatureInfo);
+  ::ndn::encoding::prependBinaryBlock(encoder, ::ndn::tlv::Content, content);
+  ::ndn::encoding::prependBlock(encoder, m_metaInfo);
+  name.wireEncode(encoder);
+
+  ::ndn::ConstBufferPtr signature = m_signatureValue;
+  if (m_signingPolicy == AggregateSigningPolicy::KEYCHAIN) {
+    signature = StackHelper::getKeyChain().getTpm().sign({encoder}, m_keyName,
+                                                         ::ndn::DigestAlgorithm::SHA256);
+    if (signature == nullptr) {
+      throw std::runtime_error("Cannot sign aggregate Data with key " + m_keyName.toUri());
+    }
+  }
+  else if (m_signingPolicy == AggregateSigningPolicy::DIGEST_SHA256) {
+    signature = ::ndn::util::Sha256::computeDigest({encoder.data(), encoder.size()});
+  }
+
+  auto data = std::make_shared<::ndn::Data>();
+  data->wireEncode(encoder, *signature);
+  return data;
+}
+
+std::shared_ptr<::ndn::Data>
+AggregateDataTemplate::makeData(const ::ndn::Name& name, uint64_t value)
+{
+  uint64_t networkValue = htobe64(value);
+  return makeData(name, {reinterpret_cast<const uint8_t*>(&networkValue), sizeof(networkValue)});
+}
+
+std::shared_ptr<::ndn::Data>
+AggregateDataTemplate::makeData(const ::ndn::Name& name, const AggregateState& state)
+{
+  if (state.getSpec().isVector()) {
+    return makeData(name, state.getElements());
+  }
+  state.encode(m_scratch);
+  return makeData(name, m_scratch);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,103 @@
+#ifndef NDN_AGGREGATE_DATA_TEMPLATE_HPP
+#define NDN_AGGREGATE_DATA_TEMPLATE_HPP
+
+#include "ndn-aggregate-operator.hpp"
+
+#include <ndn-cxx/data.hpp>
+#include <ndn-cxx/name.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief How aggregation Data (intermediate aggregates and producer values) are signed
+ */
+enum class AggregateSigningPolicy : uint8_t {
+  KEYCHAIN,      ///< StackHelper KeyChain's default key (default)
+  DIGEST_SHA256, ///< DigestSha256 over the signed portion
+  FAKE,          ///< pre-computed fake signature (type 255, one zero byte), as in ndn::Producer
+  NONE           ///< type 255 with an empty SignatureValue
+};
+
+/**
+ * @brief Pre-encoded Data skeleton for aggregation results
+ *
+ * The MetaInfo and SignatureInfo blocks and the signing key are resolved once, on first
+ * use. Each packet is then encoded straight into a single, exactly sized wire buffer
+ * (name, content, signature) that the returned Data decodes in place. No intermediate
+ * content Buffer is allocated and the TLV is not re-encoded by the KeyChain.
+ *
+ * Content is copied from the caller's bytes (or from the state's own storage for vector
+ * operators); scalar states are encoded through a scratch buffer reused across calls.
+ *
+ * Only KEYCHAIN computes a real signature per packet. DIGEST_SHA256 hashes the signed
+ * portion, and FAKE and NONE append a pre-computed SignatureValue.
+ */
+class AggregateDataTemplate
+{
+public:
+  explicit
+  AggregateDataTemplate(::ndn::time::milliseconds freshnessPeriod);
+
+  /**
+   * @brief Create a signed Data carrying @p content
+   */
+  std::shared_ptr<::ndn::Data>
+  makeData(const ::ndn::Name& name, ::ndn::span<const uint8_t> content);
+
+  /**
+   * @brief Create a signed Data carrying one big-endian uint64 value
+   */
+  std::shared_ptr<::ndn::Data>
+  makeData(const ::ndn::Name& name, uint64_t value);
+
+  /**
+   * @brief Create a signed Data carrying an encoded partial aggregation state
+   */
+  std::shared_ptr<::ndn::Data>
+  makeData(const ::ndn::Name& name, const AggregateState& state);
+
+  /**
+   * @brief Select the signing policy; takes effect with the next makeData()
+   */
+  void
+  setSigningPolicy(AggregateSigningPolicy policy);
+
+  AggregateSigningPolicy
+  getSigningPolicy() const
+  {
+    return m_signingPolicy;
+  }
+
+  /**
+   * @brief Parse "keychain", "digest", "fake" or "none"
+   * @return False if @p text names no policy
+   */
+  static bool
+  parseSigningPolicy(const std::string& text, AggregateSigningPolicy& policy);
+
+private:
+  void
+  prepare();
+
+private:
+  ::ndn::time::milliseconds m_freshnessPeriod;
+  AggregateSigningPolicy m_signingPolicy = AggregateSigningPolicy::KEYCHAIN;
+  bool m_isPrepared = false;
+  ::ndn::Block m_metaInfo;
+  ::ndn::Block m_signatureInfo;
+  ::ndn::Name m_keyName;
+  size_t m_signatureSize = 0;
+  ::ndn::ConstBufferPtr m_signatureValue; ///< pre-computed value for FAKE and NONE
+  std::vector<uint8_t> m_scratch;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_AGGREGATE_DATA_TEMPLATE_HPP
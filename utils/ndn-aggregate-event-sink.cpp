@@ -0,0 +1,112 @@
+#include "ndn-aggregate-event-sink.hpp"
+
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace ns3 {
+namespace ndn {
+
+static const AggregateEventType ALL_EVENT_TYPES[] = {
+  AggregateEventType::INTEREST_RECEIVED,
+  AggregateEventType::SUB_INTEREST_SENT,
+  AggregateEventType::DATA_AGGREGATED,
+  AggregateEventType::AGGREGATE_SENT,
+  AggregateEventType::CACHE_HIT,
+  AggregateEventType::PIGGYBACK,
+  AggregateEventType::PIT_EXPIRED,
+  AggregateEventType::DEADLINE_REPLY,
+  AggregateEventType::PRODUCER_DATA,
+  AggregateEventType::RESULT
+};
+
+AggregateEventSink&
+AggregateEventSink::getInstance()
+{
+  static AggregateEventSink sink;
+  return sink;
+}
+
+void
+AggregateEventSink::setCallback(const Callback& callback, uint32_t mask)
+{
+  m_callback = callback;
+  m_mask = callback ? mask : 0;
+}
+
+void
+AggregateEventSink::reset()
+{
+  m_callback = nullptr;
+  m_mask = 0;
+}
+
+const char*
+AggregateEventSink::toString(AggregateEventType type)
+{
+  switch (type) {
+    case AggregateEventType::INTEREST_RECEIVED:
+      return "interest-received";
+    case AggregateEventType::SUB_INTEREST_SENT:
+      return "sub-interest-sent";
+    case AggregateEventType::DATA_AGGREGATED:
+      return "data-aggregated";
+    case AggregateEventType::AGGREGATE_SENT:
+      return "aggregate-sent";
+    case AggregateEventType::CACHE_HIT:
+      return "cache-hit";
+    case AggregateEventType::PIGGYBACK:
+      return "piggyback";
+    case AggregateEventType::PIT_EXPIRED:
+      return "pit-expired";
+    case AggregateEventType::DEADLINE_REPLY:
+      return "deadline-reply";
+    case AggregateEventType::PRODUCER_DATA:
+      return "producer-data";
+    case AggregateEventType::RESULT:
+      return "result";
+  }
+  return "unknown";
+}
+
+bool
+AggregateEventSink::parseMask(const std::string& text, uint32_t& mask)
+{
+  if (text == "all") {
+    mask = ALL_EVENTS;
+    return true;
+  }
+
+  uint32_t result = 0;
+  std::istringstream is(text);
+  std::string token;
+  while (std::getline(is, token, ',')) {
+    bool isFound = false;
+    for (AggregateEventType type : ALL_EVENT_TYPES) {
+      if (token == toString(type)) {
+        result |= getMask(type);
+        isFound = true;
+        break;
+      }
+    }
+    if (!isFound) {
+      return false;
+    }
+  }
+  mask = result;
+  return true;
+}
+
+void
+AggregateEventSink::writeTsv(std::ostream& os, const AggregateEvent& event)
+{
+  os << std::fixed << std::setprecision(6) << event.time << '\t'
+     << event.nodeId << '\t'
+     << toString(event.type) << '\t'
+     << event.name << '\t'
+     << event.faceId << '\t'
+     << event.idCount << '\n';
+}
+
+} // namespace ndn
+} // namespace ns3
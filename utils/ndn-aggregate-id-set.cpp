@@ -0,0 +1,280 @@
+#include "ndn-aggregate-id-set.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+
+namespace ns3 {
+namespace ndn {
+
+static inline size_t
+popcount64(uint64_t word)
+{
+  return static_cast<size_t>(__builtin_popcountll(word));
+}
+
+AggregateIdSet::AggregateIdSet(std::initializer_list<int> ids)
+{
+  for (int id : ids) {
+    insert(id);
+  }
+}
+
+void
+AggregateIdSet::reserveWords(size_t nWords)
+{
+  if (nWords <= getWordCount()) {
+    return;
+  }
+
+  if (m_heap.empty()) {
+    m_heap.assign(m_inline, m_inline + INLINE_WORDS);
+    std::fill(m_inline, m_inline + INLINE_WORDS, 0);
+  }
+  // Grow geometrically so that inserting ascending IDs stays amortized O(1)
+  m_heap.resize(std::max(nWords, m_heap.size() * 2), 0);
+}
+
+bool
+AggregateIdSet::insert(int id)
+{
+  if (id < 0) {
+    return false;
+  }
+  size_t word = static_cast<size_t>(id) / 64;
+  uint64_t mask = uint64_t(1) << (static_cast<size_t>(id) % 64);
+  reserveWords(word + 1);
+
+  uint64_t& target = words()[word];
+  bool isNew = (target & mask) == 0;
+  target |= mask;
+  return isNew;
+}
+
+size_t
+AggregateIdSet::erase(int id)
+{
+  if (!contains(id)) {
+    return 0;
+  }
+  words()[static_cast<size_t>(id) / 64] &= ~(uint64_t(1) << (static_cast<size_t>(id) % 64));
+  return 1;
+}
+
+size_t
+AggregateIdSet::size() const
+{
+  const uint64_t* w = words();
+  size_t total = 0;
+  for (size_t i = 0; i < getWordCount(); ++i) {
+    total += popcount64(w[i]);
+  }
+  return total;
+}
+
+bool
+AggregateIdSet::empty() const
+{
+  const uint64_t* w = words();
+  for (size_t i = 0; i < getWordCount(); ++i) {
+    if (w[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void
+AggregateIdSet::clear()
+{
+  m_heap.clear();
+  std::fill(m_inline, m_inline + INLINE_WORDS, 0);
+}
+
+int
+AggregateIdSet::min() const
+{
+  size_t pos = findNext(0);
+  return pos == NPOS ? -1 : static_cast<int>(pos);
+}
+
+int
+AggregateIdSet::max() const
+{
+  const uint64_t* w = words();
+  for (size_t i = getWordCount(); i > 0; --i) {
+    if (w[i - 1] != 0) {
+      return static_cast<int>((i - 1) * 64 + 63 - __builtin_clzll(w[i - 1]));
+    }
+  }
+  return -1;
+}
+
+AggregateIdSet&
+AggregateIdSet::unionWith(const AggregateIdSet& other)
+{
+  reserveWords(other.getWordCount());
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  for (size_t i = 0; i < other.getWordCount(); ++i) {
+    w[i] |= o[i];
+  }
+  return *this;
+}
+
+AggregateIdSet&
+AggregateIdSet::intersectWith(const AggregateIdSet& other)
+{
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  size_t common = std::min(getWordCount(), other.getWordCount());
+  for (size_t i = 0; i < common; ++i) {
+    w[i] &= o[i];
+  }
+  for (size_t i = common; i < getWordCount(); ++i) {
+    w[i] = 0;
+  }
+  return *this;
+}
+
+AggregateIdSet&
+AggregateIdSet::subtract(const AggregateIdSet& other)
+{
+  uint64_t* w = words();
+  const uint64_t* o = other.words();
+  size_t common = std::min(getWordCount(), other.getWordCount());
+  for (size_t i = 0; i < common; ++i) {
+    w[i] &= ~o[i];
+  }
+  return *this;
+}
+
+bool
+AggregateIdSet::isSubsetOf(const AggregateIdSet& other) const
+{
+  const uint64_t* w = words();
+  const uint64_t* o = other.words();
+  size_t common = std::min(getWordCount(), other.getWordCount());
+  for (size_t i = 0; i < common; ++i) {
+    if ((w[i] & ~o[i]) != 0) {
+      return false;
+    }
+  }
+  for (size_t i = common; i < getWordCount(); ++i) {
+    if (w[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+AggregateIdSet::intersects(const AggregateIdSet& other) const
+{
+  const uint64_t* w = words();
+  const uint64_t* o = other.words();
+  size_t common = std::min(getWordCount(), other.getWordCount());
+  for (size_t i = 0; i < common; ++i) {
+    if ((w[i] & o[i]) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+AggregateIdSet::operator==(const AggregateIdSet& other) const
+{
+  const uint64_t* w = words();
+  const uint64_t* o = other.words();
+  size_t common = std::min(getWordCount(), other.getWordCount());
+  for (size_t i = 0; i < common; ++i) {
+    if (w[i] != o[i]) {
+      return false;
+    }
+  }
+  // Trailing words of the larger set must be empty
+  for (size_t i = common; i < getWordCount(); ++i) {
+    if (w[i] != 0) {
+      return false;
+    }
+  }
+  for (size_t i = common; i < other.getWordCount(); ++i) {
+    if (o[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t
+AggregateIdSet::hash() const
+{
+  // FNV-1a over the words, ignoring trailing zero words so capacity does not matter
+  const uint64_t* w = words();
+  size_t last = getWordCount();
+  while (last > 0 && w[last - 1] == 0) {
+    --last;
+  }
+
+  size_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < last; ++i) {
+    h ^= static_cast<size_t>(w[i]);
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+size_t
+AggregateIdSet::findNext(size_t pos) const
+{
+  const uint64_t* w = words();
+  size_t nWords = getWordCount();
+  size_t word = pos / 64;
+  if (word >= nWords) {
+    return NPOS;
+  }
+
+  uint64_t bits = w[word] & (~uint64_t(0) << (pos % 64));
+  while (true) {
+    if (bits != 0) {
+      return word * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+    }
+    if (++word >= nWords) {
+      return NPOS;
+    }
+    bits = w[word];
+  }
+}
+
+std::vector<int>
+AggregateIdSet::toVector() const
+{
+  std::vector<int> ids;
+  ids.reserve(size());
+  for (int id : *this) {
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+std::string
+AggregateIdSet::toString() const
+{
+  std::ostringstream os;
+  os << *this;
+  return os.str();
+}
+
+std::ostream&
+operator<<(std::ostream& os, const AggregateIdSet& ids)
+{
+  os << "{ ";
+  for (int id : ids) {
+    os << id << " ";
+  }
+  return os << "}";
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,289 @@
+#ifndef NDN_AGGREGATE_ID_SET_HPP
+#define NDN_AGGREGATE_ID_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Dense set of non-negative producer IDs used by aggregation
+ *
+ * The set is a dynamic bitset. IDs below INLINE_BITS live in inline storage, so the
+ * common small-topology case never allocates; larger IDs spill into a heap word array.
+ * Union, intersection, difference and subset tests run one 64-bit word at a time,
+ * and size() is a popcount.
+ *
+ * Iteration yields IDs in ascending order, like the std::set<int> it replaces.
+ */
+class AggregateIdSet
+{
+public:
+  static constexpr size_t INLINE_WORDS = 2;
+  static constexpr size_t INLINE_BITS = INLINE_WORDS * 64;
+
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int*;
+    using reference = int;
+
+    const_iterator() = default;
+
+    int
+    operator*() const
+    {
+      return static_cast<int>(m_pos);
+    }
+
+    const_iterator&
+    operator++()
+    {
+      m_pos = m_set->findNext(m_pos + 1);
+      return *this;
+    }
+
+    const_iterator
+    operator++(int)
+    {
+      const_iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool
+    operator==(const const_iterator& other) const
+    {
+      return m_pos == other.m_pos;
+    }
+
+    bool
+    operator!=(const const_iterator& other) const
+    {
+      return m_pos != other.m_pos;
+    }
+
+  private:
+    const_iterator(const AggregateIdSet* set, size_t pos)
+      : m_set(set)
+      , m_pos(pos)
+    {
+    }
+
+  private:
+    const AggregateIdSet* m_set = nullptr;
+    size_t m_pos = NPOS;
+
+    friend class AggregateIdSet;
+  };
+
+public:
+  AggregateIdSet() = default;
+
+  AggregateIdSet(std::initializer_list<int> ids);
+
+  template<typename Iterator>
+  AggregateIdSet(Iterator first, Iterator last)
+  {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  /**
+   * @brief Add an ID (negative IDs are ignored)
+   * @return True if the ID was not present before
+   */
+  bool
+  insert(int id);
+
+  /**
+   * @brief Remove an ID
+   * @return Number of removed IDs (0 or 1), matching std::set::erase
+   */
+  size_t
+  erase(int id);
+
+  bool
+  contains(int id) const
+  {
+    if (id < 0) {
+      return false;
+    }
+    size_t word = static_cast<size_t>(id) / 64;
+    return word < getWordCount() && (words()[word] >> (static_cast<size_t>(id) % 64)) & 1;
+  }
+
+  /**
+   * @return 1 if @p id is in the set, 0 otherwise (std::set compatible)
+   */
+  size_t
+  count(int id) const
+  {
+    return contains(id) ? 1 : 0;
+  }
+
+  /**
+   * @return Number of IDs in the set (popcount over all words)
+   */
+  size_t
+  size() const;
+
+  bool
+  empty() const;
+
+  void
+  clear();
+
+  /**
+   * @return Smallest ID, or -1 if the set is empty
+   */
+  int
+  min() const;
+
+  /**
+   * @return Largest ID, or -1 if the set is empty
+   */
+  int
+  max() const;
+
+  /**
+   * @brief In-place union
+   */
+  AggregateIdSet&
+  unionWith(const AggregateIdSet& other);
+
+  /**
+   * @brief In-place intersection
+   */
+  AggregateIdSet&
+  intersectWith(const AggregateIdSet& other);
+
+  /**
+   * @brief In-place difference (remove every ID present in @p other)
+   */
+  AggregateIdSet&
+  subtract(const AggregateIdSet& other);
+
+  /**
+   * @return True if every ID of this set is also in @p other
+   */
+  bool
+  isSubsetOf(const AggregateIdSet& other) const;
+
+  /**
+   * @return True if the sets share at least one ID
+   */
+  bool
+  intersects(const AggregateIdSet& other) const;
+
+  /**
+   * @return Hash that is equal for equal sets regardless of storage capacity
+   */
+  size_t
+  hash() const;
+
+  /**
+   * @return IDs in ascending order
+   */
+  std::vector<int>
+  toVector() const;
+
+  /**
+   * @return Human-readable form, e.g. "{ 1 2 5 }"
+   */
+  std::string
+  toString() const;
+
+  const_iterator
+  begin() const
+  {
+    return const_iterator(this, findNext(0));
+  }
+
+  const_iterator
+  end() const
+  {
+    return const_iterator(this, NPOS);
+  }
+
+  bool
+  operator==(const AggregateIdSet& other) const;
+
+  bool
+  operator!=(const AggregateIdSet& other) const
+  {
+    return !(*this == other);
+  }
+
+  /**
+   * @return Number of 64-bit words currently backing the set
+   */
+  size_t
+  getWordCount() const
+  {
+    return m_heap.empty() ? INLINE_WORDS : m_heap.size();
+  }
+
+  /**
+   * @return Backing words; bit (id % 64) of word (id / 64) is set for each member
+   */
+  const uint64_t*
+  words() const
+  {
+    return m_heap.empty() ? m_inline : m_heap.data();
+  }
+
+private:
+  static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+  uint64_t*
+  words()
+  {
+    return m_heap.empty() ? m_inline : m_heap.data();
+  }
+
+  void
+  reserveWords(size_t nWords);
+
+  /**
+   * @return Position of the first member >= @p pos, or NPOS
+   */
+  size_t
+  findNext(size_t pos) const;
+
+private:
+  uint64_t m_inline[INLINE_WORDS] = {0, 0};
+  std::vector<uint64_t> m_heap; ///< used instead of m_inline once an ID >= INLINE_BITS is stored
+};
+
+std::ostream&
+operator<<(std::ostream& os, const AggregateIdSet& ids);
+
+} // namespace ndn
+} // namespace ns3
+
+namespace std {
+
+template<>
+struct hash<ns3::ndn::AggregateIdSet>
+{
+  size_t
+  operator()(const ns3::ndn::AggregateIdSet& ids) const
+  {
+    return ids.hash();
+  }
+};
+
+} // namespace std
+
+#endif // NDN_AGGREGATE_ID_SET_HPP
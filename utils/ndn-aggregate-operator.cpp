@@ -0,0 +1,512 @@
+#include "ndn-aggregate-operator.hpp"
+
+#include <endian.h>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+namespace ns3 {
+namespace ndn {
+
+static const char OPERATOR_MARKER[] = "op=";
+static const size_t OPERATOR_MARKER_LENGTH = 3;
+static const char STATE_MAGIC[] = "AGG";
+static const size_t STATE_HEADER_LENGTH = 4 + sizeof(uint64_t); // magic + op, count
+
+static std::map<::ndn::Name, AggregateOpSpec>&
+getDefaults()
+{
+  static std::map<::ndn::Name, AggregateOpSpec> defaults;
+  return defaults;
+}
+
+static const char*
+getOperatorName(AggregateOp op)
+{
+  switch (op) {
+    case AggregateOp::SUM:       return "sum";
+    case AggregateOp::MIN:       return "min";
+    case AggregateOp::MAX:       return "max";
+    case AggregateOp::COUNT:     return "count";
+    case AggregateOp::MEAN:      return "mean";
+    case AggregateOp::HISTOGRAM: return "hist";
+  }
+  return "sum";
+}
+
+static const char*
+getElementTypeName(AggregateElementType type)
+{
+  switch (type) {
+    case AggregateElementType::INT32:   return "i32";
+    case AggregateElementType::INT64:   return "i64";
+    case AggregateElementType::FLOAT32: return "f32";
+    case AggregateElementType::FLOAT64: return "f64";
+  }
+  return "i64";
+}
+
+static bool
+isElementWise(AggregateOp op)
+{
+  return op == AggregateOp::SUM || op == AggregateOp::MIN || op == AggregateOp::MAX;
+}
+
+static AggregateSimd::Reduction
+getReduction(AggregateOp op)
+{
+  switch (op) {
+    case AggregateOp::MIN: return AggregateSimd::Reduction::MIN;
+    case AggregateOp::MAX: return AggregateSimd::Reduction::MAX;
+    default:               return AggregateSimd::Reduction::ADD;
+  }
+}
+
+::ndn::Name::Component
+AggregateOpSpec::toComponent() const
+{
+  std::string text = std::string(OPERATOR_MARKER) + getOperatorName(op);
+  if (op == AggregateOp::HISTOGRAM) {
+    text += "," + std::to_string(histogram.lower) + "," + std::to_string(histogram.width) +
+            "," + std::to_string(histogram.bucketCount);
+  }
+  else if (isVector()) {
+    text += std::string(",") + getElementTypeName(elementType) + "," + std::to_string(vectorLength);
+  }
+  return ::ndn::Name::Component(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+bool
+AggregateOpSpec::isOperatorMarker(const ::ndn::Name::Component& component)
+{
+  return component.value_size() >= OPERATOR_MARKER_LENGTH &&
+         std::memcmp(component.value(), OPERATOR_MARKER, OPERATOR_MARKER_LENGTH) == 0;
+}
+
+bool
+AggregateOpSpec::fromComponent(const ::ndn::Name::Component& component, AggregateOpSpec& spec)
+{
+  if (!isOperatorMarker(component)) {
+    return false;
+  }
+
+  std::string text(reinterpret_cast<const char*>(component.value()) + OPERATOR_MARKER_LENGTH,
+                   component.value_size() - OPERATOR_MARKER_LENGTH);
+  std::string name = text.substr(0, text.find(','));
+
+  AggregateOpSpec result;
+  bool isKnown = false;
+  for (AggregateOp op : {AggregateOp::SUM, AggregateOp::MIN, AggregateOp::MAX,
+                         AggregateOp::COUNT, AggregateOp::MEAN, AggregateOp::HISTOGRAM}) {
+    if (name == getOperatorName(op)) {
+      result.op = op;
+      isKnown = true;
+      break;
+    }
+  }
+  if (!isKnown) {
+    return false;
+  }
+
+  if (name.size() < text.size() && isElementWise(result.op)) {
+    // "<op>,<elementType>,<vectorLength>"
+    std::string params = text.substr(name.size() + 1);
+    size_t comma = params.find(',');
+    if (comma == std::string::npos) {
+      return false;
+    }
+    std::string typeName = params.substr(0, comma);
+    bool isKnownType = false;
+    for (AggregateElementType type : {AggregateElementType::INT32, AggregateElementType::INT64,
+                                      AggregateElementType::FLOAT32, AggregateElementType::FLOAT64}) {
+      if (typeName == getElementTypeName(type)) {
+        result.elementType = type;
+        isKnownType = true;
+        break;
+      }
+    }
+    // The length is unsigned, so a '-' would wrap
+    std::string length = params.substr(comma + 1);
+    std::istringstream is(length);
+    is >> result.vectorLength;
+    if (!isKnownType || length.find('-') != std::string::npos || is.fail() || !is.eof() ||
+        result.vectorLength == 0 || result.vectorLength > MAX_VECTOR_LENGTH) {
+      return false;
+    }
+  }
+  else if (name.size() < text.size()) {
+    if (result.op != AggregateOp::HISTOGRAM) {
+      return false;
+    }
+    // "hist,<lower>,<width>,<bucketCount>"; the fields are unsigned, so a '-' would wrap
+    std::string params = text.substr(name.size() + 1);
+    if (params.find('-') != std::string::npos) {
+      return false;
+    }
+    std::istringstream is(params);
+    char comma1 = 0;
+    char comma2 = 0;
+    is >> result.histogram.lower >> comma1 >> result.histogram.width >> comma2
+       >> result.histogram.bucketCount;
+    if (is.fail() || !is.eof() || comma1 != ',' || comma2 != ',' ||
+        result.histogram.width == 0 || result.histogram.bucketCount == 0 ||
+        result.histogram.bucketCount > HistogramSpec::MAX_BUCKET_COUNT) {
+      return false;
+    }
+  }
+
+  spec = result;
+  return true;
+}
+
+void
+AggregateOpSpec::setDefault(const ::ndn::Name& prefix, const AggregateOpSpec& spec)
+{
+  getDefaults()[prefix] = spec;
+}
+
+AggregateOpSpec
+AggregateOpSpec::select(const ::ndn::Name& name)
+{
+  AggregateOpSpec spec;
+  for (const auto& component : name) {
+    if (fromComponent(component, spec)) {
+      return spec;
+    }
+  }
+
+  const auto& defaults = getDefaults();
+  for (size_t length = name.size() + 1; length > 0; --length) {
+    auto it = defaults.find(name.getPrefix(length - 1));
+    if (it != defaults.end()) {
+      return it->second;
+    }
+  }
+  return spec;
+}
+
+AggregateState::AggregateState(const AggregateOpSpec& spec)
+  : m_spec(spec)
+{
+  if (m_spec.op == AggregateOp::HISTOGRAM) {
+    m_buckets.assign(m_spec.histogram.bucketCount, 0);
+  }
+  else if (m_spec.isVector()) {
+    m_elements.resize(m_spec.getVectorSize());
+    AggregateSimd::fillIdentity(getReduction(m_spec.op), m_spec.elementType,
+                                m_elements.data(), m_spec.vectorLength);
+  }
+}
+
+template<AggregateOp Op>
+static void
+addSamplesImpl(AggregateState& state, const uint64_t* values, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    AggregateOperator<Op>::add(state, values[i]);
+  }
+}
+
+void
+AggregateState::addSample(uint64_t value)
+{
+  addSamples(&value, 1);
+}
+
+void
+AggregateState::addSamples(const uint64_t* values, size_t count)
+{
+  if (m_spec.isVector()) {
+    return;
+  }
+  m_count += count;
+  switch (m_spec.op) {
+    case AggregateOp::SUM:       addSamplesImpl<AggregateOp::SUM>(*this, values, count); break;
+    case AggregateOp::MIN:       addSamplesImpl<AggregateOp::MIN>(*this, values, count); break;
+    case AggregateOp::MAX:       addSamplesImpl<AggregateOp::MAX>(*this, values, count); break;
+    case AggregateOp::COUNT:     break;
+    case AggregateOp::MEAN:      addSamplesImpl<AggregateOp::MEAN>(*this, values, count); break;
+    case AggregateOp::HISTOGRAM: addSamplesImpl<AggregateOp::HISTOGRAM>(*this, values, count); break;
+  }
+}
+
+bool
+AggregateState::addVector(const uint8_t* buffer, size_t size)
+{
+  if (!m_spec.isVector() || size != m_elements.size()) {
+    return false;
+  }
+  AggregateSimd::reduce(getReduction(m_spec.op), m_spec.elementType,
+                        m_elements.data(), buffer, m_spec.vectorLength);
+  ++m_count;
+  return true;
+}
+
+void
+AggregateState::merge(const AggregateState& other)
+{
+  if (other.m_spec != m_spec || other.m_count == 0) {
+    return;
+  }
+  if (m_spec.isVector()) {
+    AggregateSimd::reduce(getReduction(m_spec.op), m_spec.elementType,
+                          m_elements.data(), other.m_elements.data(), m_spec.vectorLength);
+    m_count += other.m_count;
+    return;
+  }
+  m_count += other.m_count;
+  switch (m_spec.op) {
+    case AggregateOp::SUM:       AggregateOperator<AggregateOp::SUM>::merge(*this, other); break;
+    case AggregateOp::MIN:       AggregateOperator<AggregateOp::MIN>::merge(*this, other); break;
+    case AggregateOp::MAX:       AggregateOperator<AggregateOp::MAX>::merge(*this, other); break;
+    case AggregateOp::COUNT:     break;
+    case AggregateOp::MEAN:      AggregateOperator<AggregateOp::MEAN>::merge(*this, other); break;
+    case AggregateOp::HISTOGRAM: AggregateOperator<AggregateOp::HISTOGRAM>::merge(*this, other); break;
+  }
+}
+
+bool
+AggregateState::isInvertible() const
+{
+  return !m_spec.isVector() && m_spec.op != AggregateOp::MIN && m_spec.op != AggregateOp::MAX;
+}
+
+bool
+AggregateState::subtract(const AggregateState& other)
+{
+  if (other.m_spec != m_spec || !isInvertible()) {
+    return false;
+  }
+  if (m_spec.op == AggregateOp::SUM) {
+    // A decoded SUM partial counts as one sample, so keep the state non-empty
+    m_count = other.m_count < m_count ? m_count - other.m_count : 1;
+    m_sum -= other.m_sum;
+    return true;
+  }
+  if (other.m_count > m_count) {
+    return false;
+  }
+  m_count -= other.m_count;
+  switch (m_spec.op) {
+    case AggregateOp::MEAN:
+      m_sum -= other.m_sum;
+      break;
+    case AggregateOp::HISTOGRAM:
+      for (size_t i = 0; i < m_buckets.size() && i < other.m_buckets.size(); ++i) {
+        m_buckets[i] -= other.m_buckets[i];
+      }
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+static void
+appendUint64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+  uint64_t netValue = htobe64(value);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&netValue);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(netValue));
+}
+
+static bool
+readUint64(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+{
+  if (end - pos < static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+    return false;
+  }
+  uint64_t netValue;
+  std::memcpy(&netValue, pos, sizeof(netValue));
+  value = be64toh(netValue);
+  pos += sizeof(netValue);
+  return true;
+}
+
+std::vector<uint8_t>
+AggregateState::encode() const
+{
+  std::vector<uint8_t> buffer;
+  encode(buffer);
+  return buffer;
+}
+
+void
+AggregateState::encode(std::vector<uint8_t>& buffer) const
+{
+  if (m_spec.isVector()) {
+    buffer.assign(m_elements.begin(), m_elements.end());
+    return;
+  }
+
+  buffer.clear();
+  if (m_spec.op == AggregateOp::SUM) {
+    appendUint64(buffer, m_sum);
+    return;
+  }
+
+  buffer.insert(buffer.end(), STATE_MAGIC, STATE_MAGIC + 3);
+  buffer.push_back(static_cast<uint8_t>(m_spec.op));
+  appendUint64(buffer, m_count);
+  switch (m_spec.op) {
+    case AggregateOp::MIN:
+      appendUint64(buffer, m_min);
+      break;
+    case AggregateOp::MAX:
+      appendUint64(buffer, m_max);
+      break;
+    case AggregateOp::MEAN:
+      appendUint64(buffer, m_sum);
+      break;
+    case AggregateOp::HISTOGRAM:
+      for (uint64_t bucket : m_buckets) {
+        appendUint64(buffer, bucket);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+AggregateState
+AggregateState::fromContent(const uint8_t* buffer, size_t size, const AggregateOpSpec& spec)
+{
+  AggregateState state(spec);
+  const uint8_t* pos = buffer;
+  const uint8_t* end = buffer + size;
+
+  if (spec.isVector()) {
+    state.addVector(buffer, size);
+    return state;
+  }
+
+  if (isScalarContent(size)) {
+    uint64_t value = 0;
+    readUint64(pos, end, value);
+    if (spec.op == AggregateOp::SUM) {
+      // SUM partials share the 8-byte form, so the value is already a sum
+      state.m_sum = value;
+      state.m_count = 1;
+    }
+    else {
+      state.addSample(value);
+    }
+    return state;
+  }
+
+  if (size < STATE_HEADER_LENGTH || std::memcmp(buffer, STATE_MAGIC, 3) != 0 ||
+      buffer[3] != static_cast<uint8_t>(spec.op)) {
+    return state;
+  }
+  pos += 4;
+
+  AggregateState decoded(spec);
+  readUint64(pos, end, decoded.m_count);
+  bool isValid = true;
+  switch (spec.op) {
+    case AggregateOp::MIN:
+      isValid = readUint64(pos, end, decoded.m_min);
+      break;
+    case AggregateOp::MAX:
+      isValid = readUint64(pos, end, decoded.m_max);
+      break;
+    case AggregateOp::MEAN:
+      isValid = readUint64(pos, end, decoded.m_sum);
+      break;
+    case AggregateOp::HISTOGRAM:
+      for (uint64_t& bucket : decoded.m_buckets) {
+        isValid = isValid && readUint64(pos, end, bucket);
+      }
+      break;
+    default:
+      break;
+  }
+  return isValid && pos == end ? decoded : state;
+}
+
+double
+AggregateState::getResult() const
+{
+  if (m_spec.isVector()) {
+    return static_cast<double>(m_count);
+  }
+  switch (m_spec.op) {
+    case AggregateOp::SUM:
+      return static_cast<double>(m_sum);
+    case AggregateOp::MIN:
+      return m_count == 0 ? 0 : static_cast<double>(m_min);
+    case AggregateOp::MAX:
+      return static_cast<double>(m_max);
+    case AggregateOp::MEAN:
+      return m_count == 0 ? 0 : static_cast<double>(m_sum) / m_count;
+    case AggregateOp::COUNT:
+    case AggregateOp::HISTOGRAM:
+      return static_cast<double>(m_count);
+  }
+  return 0;
+}
+
+static const size_t MAX_PRINTED_ELEMENTS = 8;
+
+static void
+printElement(std::ostream& os, AggregateElementType type, const uint8_t* pos)
+{
+  switch (type) {
+    case AggregateElementType::INT32: {
+      int32_t value;
+      std::memcpy(&value, pos, sizeof(value));
+      os << value;
+      break;
+    }
+    case AggregateElementType::INT64: {
+      int64_t value;
+      std::memcpy(&value, pos, sizeof(value));
+      os << value;
+      break;
+    }
+    case AggregateElementType::FLOAT32: {
+      float value;
+      std::memcpy(&value, pos, sizeof(value));
+      os << value;
+      break;
+    }
+    case AggregateElementType::FLOAT64: {
+      double value;
+      std::memcpy(&value, pos, sizeof(value));
+      os << value;
+      break;
+    }
+  }
+}
+
+std::string
+AggregateState::toString() const
+{
+  std::ostringstream os;
+  os << getOperatorName(m_spec.op);
+  if (m_spec.isVector()) {
+    os << "[" << getElementTypeName(m_spec.elementType) << "x" << m_spec.vectorLength << "]=[";
+    size_t elementSize = AggregateSimd::getElementSize(m_spec.elementType);
+    for (size_t i = 0; i < m_spec.vectorLength && i < MAX_PRINTED_ELEMENTS; ++i) {
+      os << (i > 0 ? " " : "");
+      printElement(os, m_spec.elementType, m_elements.data() + i * elementSize);
+    }
+    os << (m_spec.vectorLength > MAX_PRINTED_ELEMENTS ? " ...]" : "]");
+    return os.str();
+  }
+  os << "=";
+  if (m_spec.op == AggregateOp::HISTOGRAM) {
+    os << "[";
+    for (size_t i = 0; i < m_buckets.size(); ++i) {
+      os << (i > 0 ? " " : "") << m_buckets[i];
+    }
+    os << "]";
+  }
+  else {
+    os << getResult();
+  }
+  return os.str();
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,384 @@
+#ifndef NDN_AGGREGATE_OPERATOR_HPP
+#define NDN_AGGREGATE_OPERATOR_HPP
+
+#include "ndn-aggregate-simd.hpp"
+
+#include <ndn-cxx/name.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Built-in aggregation operators
+ */
+enum class AggregateOp : uint8_t {
+  SUM,
+  MIN,
+  MAX,
+  COUNT,
+  MEAN,
+  HISTOGRAM
+};
+
+/**
+ * @brief Fixed-width histogram layout: bucket i covers [lower + i*width, lower + (i+1)*width)
+ *
+ * Samples below the first bucket or above the last one are clamped into it.
+ */
+struct HistogramSpec
+{
+  /// Largest bucket count accepted from a name, as every aggregator allocates the buckets
+  static constexpr uint32_t MAX_BUCKET_COUNT = 4096;
+
+  uint64_t lower = 0;
+  uint64_t width = 1;
+  uint32_t bucketCount = 16;
+
+  size_t
+  getBucket(uint64_t value) const
+  {
+    if (value < lower) {
+      return 0;
+    }
+    uint64_t bucket = (value - lower) / width;
+    return bucket >= bucketCount ? bucketCount - 1 : static_cast<size_t>(bucket);
+  }
+
+  bool
+  operator==(const HistogramSpec& other) const
+  {
+    return lower == other.lower && width == other.width && bucketCount == other.bucketCount;
+  }
+};
+
+/**
+ * @brief Operator selected for an aggregation round
+ *
+ * The operator travels in the name as an "op=" component (e.g. "op=min",
+ * "op=hist,0,10,8" for lower, width, bucket count). Names without one use the
+ * per-prefix default registered with setDefault(), falling back to SUM.
+ *
+ * SUM, MIN and MAX may also run element-wise over fixed-length vectors, written as
+ * "op=sum,f32,256" (element type i32, i64, f32 or f64, then the element count).
+ */
+struct AggregateOpSpec
+{
+  /// Largest element count accepted from a name, as every aggregator allocates the vector
+  static constexpr uint32_t MAX_VECTOR_LENGTH = 65536;
+
+  AggregateOp op = AggregateOp::SUM;
+  HistogramSpec histogram;
+  AggregateElementType elementType = AggregateElementType::INT64;
+  uint32_t vectorLength = 0; ///< 0 for scalar (uint64 sample) aggregation
+
+  bool
+  isVector() const
+  {
+    return vectorLength > 0;
+  }
+
+  /**
+   * @return Size in bytes of one vector payload (0 for scalar operators)
+   */
+  size_t
+  getVectorSize() const
+  {
+    return vectorLength * AggregateSimd::getElementSize(elementType);
+  }
+
+  /**
+   * @return The "op=" name component describing this operator
+   */
+  ::ndn::Name::Component
+  toComponent() const;
+
+  /**
+   * @brief Parse an "op=" component
+   * @return False if @p component is not a well-formed operator component
+   */
+  static bool
+  fromComponent(const ::ndn::Name::Component& component, AggregateOpSpec& spec);
+
+  /**
+   * @return True if the component value starts with "op="
+   */
+  static bool
+  isOperatorMarker(const ::ndn::Name::Component& component);
+
+  /**
+   * @brief Register the operator used for names under @p prefix that carry no "op=" component
+   */
+  static void
+  setDefault(const ::ndn::Name& prefix, const AggregateOpSpec& spec);
+
+  /**
+   * @brief Select the operator for a name: its "op=" component, else the longest
+   *        matching per-prefix default, else SUM
+   */
+  static AggregateOpSpec
+  select(const ::ndn::Name& name);
+
+  bool
+  operator==(const AggregateOpSpec& other) const
+  {
+    return op == other.op && (op != AggregateOp::HISTOGRAM || histogram == other.histogram) &&
+           vectorLength == other.vectorLength &&
+           (vectorLength == 0 || elementType == other.elementType);
+  }
+
+  bool
+  operator!=(const AggregateOpSpec& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+/**
+ * @brief Compile-time operator traits
+ *
+ * Each built-in operator specializes add() and merge() so that the per-sample work
+ * touches only its own fields; AggregateState dispatches once per call.
+ */
+template<AggregateOp Op>
+struct AggregateOperator;
+
+/**
+ * @brief Partial aggregation state kept in the PIT and carried in Data content
+ *
+ * Content encoding:
+ *  - exactly 8 bytes: one big-endian uint64 sample (producer values, and SUM partials,
+ *    which keeps SUM wire-compatible with the original format)
+ *  - otherwise: "AGG" + op byte, big-endian sample count, then the operator's fields
+ *  - vector operators: the raw elements only; a producer sample and an element-wise
+ *    partial share this form, so vector partials carry no sample count
+ */
+class AggregateState
+{
+public:
+  explicit
+  AggregateState(const AggregateOpSpec& spec = AggregateOpSpec());
+
+  /**
+   * @brief Decode Data content into a state for @p spec
+   *
+   * An 8-byte sample becomes a one-sample state. An encoded partial of a different
+   * operator yields an empty state.
+   */
+  static AggregateState
+  fromContent(const uint8_t* buffer, size_t size, const AggregateOpSpec& spec);
+
+  /**
+   * @return True if @p size denotes a single raw sample rather than an encoded partial
+   */
+  static bool
+  isScalarContent(size_t size)
+  {
+    return size == sizeof(uint64_t);
+  }
+
+  /**
+   * @brief Fold one raw sample into the state
+   */
+  void
+  addSample(uint64_t value);
+
+  /**
+   * @brief Fold many raw samples using the operator's specialized loop
+   *
+   * Scalar samples do not apply to vector operators and are ignored by them.
+   */
+  void
+  addSamples(const uint64_t* values, size_t count);
+
+  /**
+   * @brief Fold one vector sample (or element-wise partial) with the SIMD kernels
+   * @return False, leaving the state untouched, if @p size is not the spec's vector size
+   */
+  bool
+  addVector(const uint8_t* buffer, size_t size);
+
+  /**
+   * @brief Merge another partial of the same operator
+   */
+  void
+  merge(const AggregateState& other);
+
+  /**
+   * @return True if a merged partial can be taken out again with subtract()
+   *         (scalar SUM, COUNT, MEAN and HISTOGRAM)
+   */
+  bool
+  isInvertible() const;
+
+  /**
+   * @brief Take out a partial of the same operator that is contained in this state
+   *
+   * SUM partials travel without a sample count, so for SUM only the sum is exact.
+   *
+   * @return False, leaving the state untouched, if the operator is not invertible or
+   *         @p other holds more samples than this state
+   */
+  bool
+  subtract(const AggregateState& other);
+
+  /**
+   * @return Encoded content (see class description)
+   */
+  std::vector<uint8_t>
+  encode() const;
+
+  /**
+   * @brief Encode into @p buffer, replacing its contents but keeping its capacity
+   */
+  void
+  encode(std::vector<uint8_t>& buffer) const;
+
+  /**
+   * @return Final scalar result (for HISTOGRAM and vector operators, the sample count)
+   */
+  double
+  getResult() const;
+
+  /**
+   * @return Human-readable result, e.g. "sum=42", "hist=[1 0 3]" or "sum[f32x2]=[1.5 2]"
+   */
+  std::string
+  toString() const;
+
+  const AggregateOpSpec&
+  getSpec() const
+  {
+    return m_spec;
+  }
+
+  uint64_t
+  getCount() const
+  {
+    return m_count;
+  }
+
+  const std::vector<uint64_t>&
+  getBuckets() const
+  {
+    return m_buckets;
+  }
+
+  /**
+   * @return Raw vector elements (empty for scalar operators)
+   */
+  const std::vector<uint8_t>&
+  getElements() const
+  {
+    return m_elements;
+  }
+
+private:
+  AggregateOpSpec m_spec;
+
+  // Operator fields; only those used by m_spec.op are meaningful
+  uint64_t m_count = 0;
+  uint64_t m_sum = 0;
+  uint64_t m_min = std::numeric_limits<uint64_t>::max();
+  uint64_t m_max = 0;
+  std::vector<uint64_t> m_buckets;
+  std::vector<uint8_t> m_elements;
+
+  template<AggregateOp Op>
+  friend struct AggregateOperator;
+};
+
+template<>
+struct AggregateOperator<AggregateOp::SUM>
+{
+  static void
+  add(AggregateState& s, uint64_t value)
+  {
+    s.m_sum += value;
+  }
+
+  static void
+  merge(AggregateState& s, const AggregateState& other)
+  {
+    s.m_sum += other.m_sum;
+  }
+};
+
+template<>
+struct AggregateOperator<AggregateOp::MIN>
+{
+  static void
+  add(AggregateState& s, uint64_t value)
+  {
+    s.m_min = value < s.m_min ? value : s.m_min;
+  }
+
+  static void
+  merge(AggregateState& s, const AggregateState& other)
+  {
+    add(s, other.m_min);
+  }
+};
+
+template<>
+struct AggregateOperator<AggregateOp::MAX>
+{
+  static void
+  add(AggregateState& s, uint64_t value)
+  {
+    s.m_max = value > s.m_max ? value : s.m_max;
+  }
+
+  static void
+  merge(AggregateState& s, const AggregateState& other)
+  {
+    add(s, other.m_max);
+  }
+};
+
+template<>
+struct AggregateOperator<AggregateOp::COUNT>
+{
+  static void
+  add(AggregateState&, uint64_t)
+  {
+  }
+
+  static void
+  merge(AggregateState&, const AggregateState&)
+  {
+  }
+};
+
+template<>
+struct AggregateOperator<AggregateOp::MEAN> : AggregateOperator<AggregateOp::SUM>
+{
+};
+
+template<>
+struct AggregateOperator<AggregateOp::HISTOGRAM>
+{
+  static void
+  add(AggregateState& s, uint64_t value)
+  {
+    ++s.m_buckets[s.m_spec.histogram.getBucket(value)];
+  }
+
+  static void
+  merge(AggregateState& s, const AggregateState& other)
+  {
+    for (size_t i = 0; i < s.m_buckets.size() && i < other.m_buckets.size(); ++i) {
+      s.m_buckets[i] += other.m_buckets[i];
+    }
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_AGGREGATE_OPERATOR_HPP
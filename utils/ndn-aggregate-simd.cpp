@@ -0,0 +1,378 @@
+#include "ndn-aggregate-simd.hpp"
+
+#include <cstring>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define NDN_AGGREGATE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ns3 {
+namespace ndn {
+
+using Reduction = AggregateSimd::Reduction;
+using Kernel = void (*)(uint8_t* dst, const uint8_t* src, size_t count);
+
+static const size_t REDUCTION_COUNT = 3;
+static const size_t ELEMENT_TYPE_COUNT = 4;
+
+template<typename T>
+static inline T
+loadElement(const uint8_t* pos)
+{
+  T value;
+  std::memcpy(&value, pos, sizeof(value));
+  return value;
+}
+
+template<typename T>
+static inline void
+storeElement(uint8_t* pos, T value)
+{
+  std::memcpy(pos, &value, sizeof(value));
+}
+
+// Integer addition goes through the unsigned type so that overflow wraps instead of being UB
+static inline int32_t
+addValues(int32_t a, int32_t b)
+{
+  return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+static inline int64_t
+addValues(int64_t a, int64_t b)
+{
+  return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+static inline float
+addValues(float a, float b)
+{
+  return a + b;
+}
+
+static inline double
+addValues(double a, double b)
+{
+  return a + b;
+}
+
+// MIN/MAX follow the x86 minps/maxps convention (the second operand wins on ties and NaN)
+struct AddOp
+{
+  template<typename T>
+  static T
+  apply(T a, T b)
+  {
+    return addValues(a, b);
+  }
+};
+
+struct MinOp
+{
+  template<typename T>
+  static T
+  apply(T a, T b)
+  {
+    return a < b ? a : b;
+  }
+};
+
+struct MaxOp
+{
+  template<typename T>
+  static T
+  apply(T a, T b)
+  {
+    return a > b ? a : b;
+  }
+};
+
+template<typename T, typename Op>
+static void
+reduceRange(uint8_t* dst, const uint8_t* src, size_t begin, size_t count)
+{
+  for (size_t i = begin; i < count; ++i) {
+    uint8_t* pos = dst + i * sizeof(T);
+    storeElement<T>(pos, Op::apply(loadElement<T>(pos), loadElement<T>(src + i * sizeof(T))));
+  }
+}
+
+template<typename T, typename Op>
+static void
+scalarKernel(uint8_t* dst, const uint8_t* src, size_t count)
+{
+  reduceRange<T, Op>(dst, src, 0, count);
+}
+
+/**
+ * Defines a kernel that combines whole registers with OP and finishes the tail
+ * with the scalar loop
+ */
+#define NDN_AGGREGATE_VECTOR_KERNEL(TARGET, NAME, T, VEC, LOAD, STORE, OP, SCALAR_OP)  \
+  TARGET static void                                                                 \
+  NAME(uint8_t* dst, const uint8_t* src, size_t count)                               \
+  {                                                                                  \
+    const size_t lanes = sizeof(VEC) / sizeof(T);                                    \
+    size_t i = 0;                                                                    \
+    for (; i + lanes <= count; i += lanes) {                                         \
+      VEC a = LOAD(dst + i * sizeof(T));                                             \
+      VEC b = LOAD(src + i * sizeof(T));                                             \
+      STORE(dst + i * sizeof(T), OP(a, b));                                          \
+    }                                                                                \
+    reduceRange<T, SCALAR_OP>(dst, src, i, count);                                   \
+  }
+
+#ifdef NDN_AGGREGATE_SIMD_X86
+
+#define NDN_AGGREGATE_SSE2
+#define NDN_AGGREGATE_AVX2 __attribute__((target("avx2")))
+
+static inline __m128i
+loadSi128(const uint8_t* pos)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+}
+
+static inline void
+storeSi128(uint8_t* pos, __m128i value)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(pos), value);
+}
+
+static inline __m128
+loadPs128(const uint8_t* pos)
+{
+  return _mm_loadu_ps(reinterpret_cast<const float*>(pos));
+}
+
+static inline void
+storePs128(uint8_t* pos, __m128 value)
+{
+  _mm_storeu_ps(reinterpret_cast<float*>(pos), value);
+}
+
+static inline __m128d
+loadPd128(const uint8_t* pos)
+{
+  return _mm_loadu_pd(reinterpret_cast<const double*>(pos));
+}
+
+static inline void
+storePd128(uint8_t* pos, __m128d value)
+{
+  _mm_storeu_pd(reinterpret_cast<double*>(pos), value);
+}
+
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2AddInt32, int32_t, __m128i,
+                            loadSi128, storeSi128, _mm_add_epi32, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2AddInt64, int64_t, __m128i,
+                            loadSi128, storeSi128, _mm_add_epi64, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2AddFloat32, float, __m128,
+                            loadPs128, storePs128, _mm_add_ps, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2AddFloat64, double, __m128d,
+                            loadPd128, storePd128, _mm_add_pd, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2MinFloat32, float, __m128,
+                            loadPs128, storePs128, _mm_min_ps, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2MinFloat64, double, __m128d,
+                            loadPd128, storePd128, _mm_min_pd, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2MaxFloat32, float, __m128,
+                            loadPs128, storePs128, _mm_max_ps, MaxOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_SSE2, sse2MaxFloat64, double, __m128d,
+                            loadPd128, storePd128, _mm_max_pd, MaxOp)
+
+NDN_AGGREGATE_AVX2 static inline __m256i
+loadSi256(const uint8_t* pos)
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+}
+
+NDN_AGGREGATE_AVX2 static inline void
+storeSi256(uint8_t* pos, __m256i value)
+{
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(pos), value);
+}
+
+NDN_AGGREGATE_AVX2 static inline __m256
+loadPs256(const uint8_t* pos)
+{
+  return _mm256_loadu_ps(reinterpret_cast<const float*>(pos));
+}
+
+NDN_AGGREGATE_AVX2 static inline void
+storePs256(uint8_t* pos, __m256 value)
+{
+  _mm256_storeu_ps(reinterpret_cast<float*>(pos), value);
+}
+
+NDN_AGGREGATE_AVX2 static inline __m256d
+loadPd256(const uint8_t* pos)
+{
+  return _mm256_loadu_pd(reinterpret_cast<const double*>(pos));
+}
+
+NDN_AGGREGATE_AVX2 static inline void
+storePd256(uint8_t* pos, __m256d value)
+{
+  _mm256_storeu_pd(reinterpret_cast<double*>(pos), value);
+}
+
+// AVX2 has no 64-bit integer min/max; build them from compare + blend
+NDN_AGGREGATE_AVX2 static inline __m256i
+minEpi64(__m256i a, __m256i b)
+{
+  return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+NDN_AGGREGATE_AVX2 static inline __m256i
+maxEpi64(__m256i a, __m256i b)
+{
+  return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2AddInt32, int32_t, __m256i,
+                            loadSi256, storeSi256, _mm256_add_epi32, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2AddInt64, int64_t, __m256i,
+                            loadSi256, storeSi256, _mm256_add_epi64, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2AddFloat32, float, __m256,
+                            loadPs256, storePs256, _mm256_add_ps, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2AddFloat64, double, __m256d,
+                            loadPd256, storePd256, _mm256_add_pd, AddOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MinInt32, int32_t, __m256i,
+                            loadSi256, storeSi256, _mm256_min_epi32, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MinInt64, int64_t, __m256i,
+                            loadSi256, storeSi256, minEpi64, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MinFloat32, float, __m256,
+                            loadPs256, storePs256, _mm256_min_ps, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MinFloat64, double, __m256d,
+                            loadPd256, storePd256, _mm256_min_pd, MinOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MaxInt32, int32_t, __m256i,
+                            loadSi256, storeSi256, _mm256_max_epi32, MaxOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MaxInt64, int64_t, __m256i,
+                            loadSi256, storeSi256, maxEpi64, MaxOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MaxFloat32, float, __m256,
+                            loadPs256, storePs256, _mm256_max_ps, MaxOp)
+NDN_AGGREGATE_VECTOR_KERNEL(NDN_AGGREGATE_AVX2, avx2MaxFloat64, double, __m256d,
+                            loadPd256, storePd256, _mm256_max_pd, MaxOp)
+
+#endif // NDN_AGGREGATE_SIMD_X86
+
+#undef NDN_AGGREGATE_VECTOR_KERNEL
+
+// Indexed by [Reduction][AggregateElementType]
+using KernelTable = Kernel[REDUCTION_COUNT][ELEMENT_TYPE_COUNT];
+
+static const KernelTable SCALAR_KERNELS = {
+  {scalarKernel<int32_t, AddOp>, scalarKernel<int64_t, AddOp>,
+   scalarKernel<float, AddOp>, scalarKernel<double, AddOp>},
+  {scalarKernel<int32_t, MinOp>, scalarKernel<int64_t, MinOp>,
+   scalarKernel<float, MinOp>, scalarKernel<double, MinOp>},
+  {scalarKernel<int32_t, MaxOp>, scalarKernel<int64_t, MaxOp>,
+   scalarKernel<float, MaxOp>, scalarKernel<double, MaxOp>},
+};
+
+#ifdef NDN_AGGREGATE_SIMD_X86
+// SSE2 lacks integer min/max, which stay scalar
+static const KernelTable SSE2_KERNELS = {
+  {sse2AddInt32, sse2AddInt64, sse2AddFloat32, sse2AddFloat64},
+  {scalarKernel<int32_t, MinOp>, scalarKernel<int64_t, MinOp>, sse2MinFloat32, sse2MinFloat64},
+  {scalarKernel<int32_t, MaxOp>, scalarKernel<int64_t, MaxOp>, sse2MaxFloat32, sse2MaxFloat64},
+};
+
+static const KernelTable AVX2_KERNELS = {
+  {avx2AddInt32, avx2AddInt64, avx2AddFloat32, avx2AddFloat64},
+  {avx2MinInt32, avx2MinInt64, avx2MinFloat32, avx2MinFloat64},
+  {avx2MaxInt32, avx2MaxInt64, avx2MaxFloat32, avx2MaxFloat64},
+};
+#endif // NDN_AGGREGATE_SIMD_X86
+
+static bool
+hasAvx2()
+{
+#ifdef NDN_AGGREGATE_SIMD_X86
+  static const bool isSupported = __builtin_cpu_supports("avx2");
+  return isSupported;
+#else
+  return false;
+#endif
+}
+
+static const KernelTable&
+getKernels()
+{
+#ifdef NDN_AGGREGATE_SIMD_X86
+  return hasAvx2() ? AVX2_KERNELS : SSE2_KERNELS;
+#else
+  return SCALAR_KERNELS;
+#endif
+}
+
+size_t
+AggregateSimd::getElementSize(AggregateElementType type)
+{
+  switch (type) {
+    case AggregateElementType::INT32:   return sizeof(int32_t);
+    case AggregateElementType::INT64:   return sizeof(int64_t);
+    case AggregateElementType::FLOAT32: return sizeof(float);
+    case AggregateElementType::FLOAT64: return sizeof(double);
+  }
+  return 0;
+}
+
+void
+AggregateSimd::reduce(Reduction reduction, AggregateElementType type,
+                      uint8_t* dst, const uint8_t* src, size_t count)
+{
+  getKernels()[static_cast<size_t>(reduction)][static_cast<size_t>(type)](dst, src, count);
+}
+
+void
+AggregateSimd::reduceScalar(Reduction reduction, AggregateElementType type,
+                            uint8_t* dst, const uint8_t* src, size_t count)
+{
+  SCALAR_KERNELS[static_cast<size_t>(reduction)][static_cast<size_t>(type)](dst, src, count);
+}
+
+template<typename T>
+static void
+fillIdentityImpl(Reduction reduction, uint8_t* dst, size_t count)
+{
+  T value = 0;
+  if (reduction == Reduction::MIN) {
+    value = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                 : std::numeric_limits<T>::max();
+  }
+  else if (reduction == Reduction::MAX) {
+    value = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                 : std::numeric_limits<T>::lowest();
+  }
+  for (size_t i = 0; i < count; ++i) {
+    storeElement<T>(dst + i * sizeof(T), value);
+  }
+}
+
+void
+AggregateSimd::fillIdentity(Reduction reduction, AggregateElementType type,
+                            uint8_t* dst, size_t count)
+{
+  switch (type) {
+    case AggregateElementType::INT32:   fillIdentityImpl<int32_t>(reduction, dst, count); break;
+    case AggregateElementType::INT64:   fillIdentityImpl<int64_t>(reduction, dst, count); break;
+    case AggregateElementType::FLOAT32: fillIdentityImpl<float>(reduction, dst, count); break;
+    case AggregateElementType::FLOAT64: fillIdentityImpl<double>(reduction, dst, count); break;
+  }
+}
+
+const char*
+AggregateSimd::getKernelName()
+{
+#ifdef NDN_AGGREGATE_SIMD_X86
+  return hasAvx2() ? "avx2" : "sse2";
+#else
+  return "scalar";
+#endif
+}
+
+} // namespace ndn
+} // namespace ns3
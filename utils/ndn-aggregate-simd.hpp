@@ -0,0 +1,75 @@
+#ifndef NDN_AGGREGATE_SIMD_HPP
+#define NDN_AGGREGATE_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Element type of a vector aggregation payload
+ *
+ * Elements are carried in host (little-endian on x86) byte order, back to back.
+ */
+enum class AggregateElementType : uint8_t {
+  INT32,
+  INT64,
+  FLOAT32,
+  FLOAT64
+};
+
+/**
+ * @brief Element-wise reduction kernels for vector aggregation payloads
+ *
+ * On x86 the AVX2 kernels are selected at runtime when the CPU supports them, SSE2
+ * kernels otherwise; other targets use the scalar loop. Buffers need not be aligned.
+ * Integer addition wraps around.
+ */
+class AggregateSimd
+{
+public:
+  enum class Reduction : uint8_t {
+    ADD,
+    MIN,
+    MAX
+  };
+
+  /**
+   * @return Size in bytes of one element of @p type
+   */
+  static size_t
+  getElementSize(AggregateElementType type);
+
+  /**
+   * @brief dst[i] = reduction(dst[i], src[i]) for i in [0, count)
+   */
+  static void
+  reduce(Reduction reduction, AggregateElementType type,
+         uint8_t* dst, const uint8_t* src, size_t count);
+
+  /**
+   * @brief Same as reduce(), always using the scalar loop (reference for tests)
+   */
+  static void
+  reduceScalar(Reduction reduction, AggregateElementType type,
+               uint8_t* dst, const uint8_t* src, size_t count);
+
+  /**
+   * @brief Fill @p count elements with the identity of @p reduction
+   *        (0, the type's maximum, or its lowest value / -inf)
+   */
+  static void
+  fillIdentity(Reduction reduction, AggregateElementType type, uint8_t* dst, size_t count);
+
+  /**
+   * @return Name of the kernel set used by reduce(): "avx2", "sse2" or "scalar"
+   */
+  static const char*
+  getKernelName();
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // NDN_AGGREGATE_SIMD_HPP
@@ -5,7 +5,11 @@
 #include <ndn-cxx/encoding/block.hpp>
 #include <endian.h>
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include <cstring>
 #include <iomanip>
+#include <limits>
+
+NS_LOG_COMPONENT_DEFINE("ndn.AggregateUtils");
 
 namespace ns3 {
 namespace ndn {
@@ -13,6 +17,19 @@ namespace ndn {
 // Implement existing functions (getNodeCount, determineNodeRole, getNodeRoleString)
 // ...
 
+namespace {
+
+struct RoleEntry
+{
+  AggregateUtils::NodeRole role;
+  uint32_t logicalId;
+};
+
+// Roles registered by the topology helper, by node index; empty for the index ranges
+std::vector<RoleEntry> s_nodeRoles;
+
+} // namespace
+
 uint32_t
 AggregateUtils::getNodeCount()
 {
@@ -30,9 +47,46 @@ AggregateUtils::getNodeCount()
   return nodeCount;
 }
 
+void
+AggregateUtils::registerNodeRole(uint32_t nodeIndex, NodeRole role, uint32_t logicalId)
+{
+  if (nodeIndex >= s_nodeRoles.size()) {
+    s_nodeRoles.resize(nodeIndex + 1, RoleEntry{NodeRole::UNKNOWN, 0});
+  }
+  s_nodeRoles[nodeIndex] = RoleEntry{role, logicalId};
+}
+
+void
+AggregateUtils::clearNodeRoles()
+{
+  s_nodeRoles.clear();
+}
+
+uint32_t
+AggregateUtils::getLogicalId(uint32_t nodeIndex)
+{
+  if (!s_nodeRoles.empty()) {
+    return nodeIndex < s_nodeRoles.size() ? s_nodeRoles[nodeIndex].logicalId : 0;
+  }
+
+  uint32_t nodeCount = getNodeCount();
+  switch (determineNodeRole(nodeIndex)) {
+    case NodeRole::PRODUCER:
+      return nodeIndex + 1;
+    case NodeRole::RACK_AGG:
+      return nodeIndex - nodeCount + 1;
+    default:
+      return nodeIndex - 2 * nodeCount + 1;
+  }
+}
+
 AggregateUtils::NodeRole
 AggregateUtils::determineNodeRole(uint32_t nodeIndex)
 {
+  if (!s_nodeRoles.empty()) {
+    return nodeIndex < s_nodeRoles.size() ? s_nodeRoles[nodeIndex].role : NodeRole::UNKNOWN;
+  }
+
   // Get nodeCount from GlobalValue
   uint32_t nodeCount = getNodeCount();
   
@@ -58,6 +112,22 @@ AggregateUtils::determineNodeRole(uint32_t nodeIndex)
 std::string
 AggregateUtils::getNodeRoleString(NodeRole role, uint32_t nodeIndex)
 {
+  if (nodeIndex < s_nodeRoles.size() && s_nodeRoles[nodeIndex].role == role) {
+    uint32_t logicalId = s_nodeRoles[nodeIndex].logicalId;
+    switch (role) {
+      case NodeRole::PRODUCER:
+        return "P" + std::to_string(logicalId);
+      case NodeRole::RACK_AGG:
+        return "R" + std::to_string(logicalId);
+      case NodeRole::CORE_AGG:
+        return "C" + std::to_string(logicalId);
+      case NodeRole::POD_AGG:
+        return "A" + std::to_string(logicalId);
+      default:
+        break;
+    }
+  }
+
   uint32_t nodeCount = getNodeCount();
   uint32_t numRackAggregators = nodeCount;
   
@@ -101,60 +171,333 @@ AggregateUtils::extractValueFromContent(const ::ndn::Data& data)
   return value;
 }
 
-std::set<int>
+bool
+AggregateUtils::isSequenceMarker(const ::ndn::Name::Component& component)
+{
+  static const char marker[] = "seq=";
+  return component.value_size() >= sizeof(marker) - 1 &&
+         std::memcmp(component.value(), marker, sizeof(marker) - 1) == 0;
+}
+
+static const char RANGE_MARKER[] = "ids=";
+static const char BITMAP_MARKER[] = "idb=";
+static const size_t MARKER_LENGTH = 4;
+
+static AggregateUtils::IdEncoding s_idEncoding = AggregateUtils::IdEncoding::COMPACT;
+
+void
+AggregateUtils::setIdEncoding(IdEncoding encoding)
+{
+  s_idEncoding = encoding;
+}
+
+AggregateUtils::IdEncoding
+AggregateUtils::getIdEncoding()
+{
+  return s_idEncoding;
+}
+
+void
+AggregateUtils::appendIdSet(::ndn::Name& name, const AggregateIdSet& ids)
+{
+  if (ids.size() == 1 || s_idEncoding == IdEncoding::PER_COMPONENT) {
+    for (int id : ids) {
+      appendId(name, id);
+    }
+    return;
+  }
+  if (!ids.empty()) {
+    name.append(encodeIdSetComponent(ids));
+  }
+}
+
+::ndn::Name::Component
+AggregateUtils::encodeIdSetComponent(const AggregateIdSet& ids)
+{
+  std::string ranges(RANGE_MARKER);
+  auto it = ids.begin();
+  while (it != ids.end()) {
+    int first = *it;
+    int last = first;
+    while (++it != ids.end() && *it == last + 1) {
+      last = *it;
+    }
+    if (ranges.size() > MARKER_LENGTH) {
+      ranges += ',';
+    }
+    ranges += std::to_string(first);
+    if (last != first) {
+      ranges += '-';
+      ranges += std::to_string(last);
+    }
+  }
+
+  size_t bitmapSize = ids.empty() ? 0 : static_cast<size_t>(ids.max()) / 8 + 1;
+  if (MARKER_LENGTH + bitmapSize >= ranges.size()) {
+    return ::ndn::Name::Component(reinterpret_cast<const uint8_t*>(ranges.data()), ranges.size());
+  }
+
+  std::vector<uint8_t> bitmap(MARKER_LENGTH + bitmapSize, 0);
+  std::memcpy(bitmap.data(), BITMAP_MARKER, MARKER_LENGTH);
+  for (int id : ids) {
+    bitmap[MARKER_LENGTH + id / 8] |= static_cast<uint8_t>(1 << (id % 8));
+  }
+  return ::ndn::Name::Component(bitmap.data(), bitmap.size());
+}
+
+bool
+AggregateUtils::decodeIdSetComponent(const ::ndn::Name::Component& component, AggregateIdSet& ids)
+{
+  const uint8_t* value = component.value();
+  size_t length = component.value_size();
+  if (length < MARKER_LENGTH) {
+    return false;
+  }
+
+  if (std::memcmp(value, BITMAP_MARKER, MARKER_LENGTH) == 0) {
+    for (size_t i = MARKER_LENGTH; i < length; ++i) {
+      for (int bit = 0; bit < 8; ++bit) {
+        if ((value[i] >> bit) & 1) {
+          ids.insert(static_cast<int>((i - MARKER_LENGTH) * 8) + bit);
+        }
+      }
+    }
+    return true;
+  }
+
+  if (std::memcmp(value, RANGE_MARKER, MARKER_LENGTH) != 0) {
+    return false;
+  }
+
+  // Parse "a" or "a-b" items separated by ','; ranges are collected separately
+  // so that a malformed component leaves @p ids untouched
+  AggregateIdSet decoded;
+  size_t pos = MARKER_LENGTH;
+  auto readNumber = [&] (int& number) {
+    size_t start = pos;
+    int64_t result = 0;
+    while (pos < length && value[pos] >= '0' && value[pos] <= '9') {
+      result = result * 10 + (value[pos] - '0');
+      if (result > MAX_ID) {
+        return false;
+      }
+      ++pos;
+    }
+    number = static_cast<int>(result);
+    return pos > start;
+  };
+
+  // Overlapping ranges could still expand to far more than MAX_ID IDs in total
+  int64_t nExpanded = 0;
+  while (pos < length) {
+    int first = 0;
+    int last = 0;
+    if (!readNumber(first)) {
+      return false;
+    }
+    last = first;
+    if (pos < length && value[pos] == '-') {
+      ++pos;
+      if (!readNumber(last) || last < first) {
+        return false;
+      }
+    }
+    nExpanded += last - first + 1;
+    if (nExpanded > MAX_ID + 1) {
+      return false;
+    }
+    for (int64_t id = first; id <= last; ++id) {
+      decoded.insert(static_cast<int>(id));
+    }
+    if (pos < length) {
+      if (value[pos] != ',' || pos + 1 == length) {
+        return false;
+      }
+      ++pos;
+    }
+  }
+  ids.unionWith(decoded);
+  return true;
+}
+
+void
+AggregateUtils::appendId(::ndn::Name& name, int id)
+{
+  name.append(std::to_string(id));
+}
+
+bool
+AggregateUtils::decodeIdComponent(const ::ndn::Name::Component& component, int& id)
+{
+  // Decimal text first: its bytes would also parse as a (wrong) NonNegativeInteger
+  const uint8_t* value = component.value();
+  size_t length = component.value_size();
+  bool isDecimal = length > 0;
+  int64_t decimal = 0;
+  for (size_t j = 0; j < length && isDecimal; ++j) {
+    isDecimal = value[j] >= '0' && value[j] <= '9';
+    decimal = decimal * 10 + (value[j] - '0');
+    if (isDecimal && decimal > MAX_ID) {
+      return false;
+    }
+  }
+  if (isDecimal) {
+    id = static_cast<int>(decimal);
+    return id > 0;
+  }
+
+  if (component.isNumber()) {
+    uint64_t number = component.toNumber();
+    if (number > 0 && number <= static_cast<uint64_t>(MAX_ID)) {
+      id = static_cast<int>(number);
+      return true;
+    }
+  }
+  return false;
+}
+
+AggregateIdSet
 AggregateUtils::parseNumbersFromName(const ::ndn::Name& name)
 {
-  std::set<int> idSet;
+  AggregateIdSet idSet;
   
-  // Skip the first component (typically "aggregate") and skip sequence number
+  // Skip the first component (typically "aggregate"); the round and the operator are
+  // marked by their "seq=" and "op=" prefixes. Native sequence-number components are
+  // not skipped: their 0xFE marker byte is also the first byte of IDs 65024-65279.
   for (size_t i = 1; i < name.size(); ++i) {
-    // Skip sequence number components (they have a specific format)
-    std::string uri = name[i].toUri();
-    if (uri.find("seq=") != std::string::npos) {
+    const ::ndn::Name::Component& component = name[i];
+    if (isSequenceMarker(component) || AggregateOpSpec::isOperatorMarker(component)) {
       continue;
     }
     
-    try {
-      // Remove any % prefix (used for NDN component encoding)
-      if (uri[0] == '%') {
-        uri = uri.substr(1);
-      }
-      
-      int id = std::stoi(uri);
-      if (id > 0) {
-        idSet.insert(id);
-      }
-    } 
-    catch (const std::exception& e) {
-      // Skip components that can't be parsed as integers
+    // Compact "ids=" / "idb=" component carrying many IDs at once
+    if (decodeIdSetComponent(component, idSet)) {
+      continue;
+    }
+    
+    int id = 0;
+    if (decodeIdComponent(component, id)) {
+      idSet.insert(id);
     }
   }
   
   return idSet;
 }
 
+AggregateDataTemplate&
+AggregateUtils::getDataTemplate()
+{
+  // Freshness period of 1 second for all aggregation Data
+  static AggregateDataTemplate dataTemplate(::ndn::time::milliseconds(1000));
+  return dataTemplate;
+}
+
 std::shared_ptr<::ndn::Data>
 AggregateUtils::createDataWithValue(const ::ndn::Name& name, uint64_t value)
 {
-  auto data = std::make_shared<::ndn::Data>(name);
-  
-  // Convert value to network byte order
-  uint64_t networkValue = htobe64(value);
-  
-  // Create a buffer containing the value
-  std::shared_ptr<::ndn::Buffer> buffer = std::make_shared<::ndn::Buffer>(
-    reinterpret_cast<const uint8_t*>(&networkValue), sizeof(networkValue));
-  
-  // Set as content
-  data->setContent(buffer);
-  
-  // Set freshness period (1 second)
-  data->setFreshnessPeriod(::ndn::time::milliseconds(1000));
-  
-  // Sign the data
-  signData(data);
-  
-  return data;
+  return getDataTemplate().makeData(name, value);
+}
+
+std::shared_ptr<::ndn::Data>
+AggregateUtils::createDataWithState(const ::ndn::Name& name, const AggregateState& state)
+{
+  return getDataTemplate().makeData(name, state);
+}
+
+static const char PARTIAL_MAGIC[] = "AGP";
+static const size_t PARTIAL_HEADER_LENGTH = 3 + sizeof(uint16_t);
+
+std::shared_ptr<::ndn::Data>
+AggregateUtils::createPartialData(const ::ndn::Name& name, const AggregateState& state,
+                                  const AggregateIdSet& missingIds)
+{
+  if (missingIds.empty()) {
+    return createDataWithState(name, state);
+  }
+
+  ::ndn::Name::Component descriptor = encodeIdSetComponent(missingIds);
+  std::vector<uint8_t> encoded = state.encode();
+  uint16_t descriptorSize = htobe16(static_cast<uint16_t>(descriptor.value_size()));
+
+  std::vector<uint8_t> content;
+  content.reserve(PARTIAL_HEADER_LENGTH + descriptor.value_size() + encoded.size());
+  content.insert(content.end(), PARTIAL_MAGIC, PARTIAL_MAGIC + 3);
+  content.insert(content.end(), reinterpret_cast<const uint8_t*>(&descriptorSize),
+                 reinterpret_cast<const uint8_t*>(&descriptorSize) + sizeof(descriptorSize));
+  content.insert(content.end(), descriptor.value(), descriptor.value() + descriptor.value_size());
+  content.insert(content.end(), encoded.begin(), encoded.end());
+  return getDataTemplate().makeData(name, content);
+}
+
+AggregateState
+AggregateUtils::extractStateFromContent(const ::ndn::Data& data, const AggregateOpSpec& spec)
+{
+  AggregateIdSet missingIds;
+  return extractStateFromContent(data, spec, missingIds);
+}
+
+AggregateState
+AggregateUtils::extractStateFromContent(const ::ndn::Data& data, const AggregateOpSpec& spec,
+                                        AggregateIdSet& missingIds)
+{
+  const ::ndn::Block& content = data.getContent();
+  const uint8_t* value = content.value();
+  size_t size = content.value_size();
+
+  // A deadline reply wraps the state in a missing-IDs header; a vector sample only
+  // looks like one if its size differs from the operator's vector size
+  if (size > PARTIAL_HEADER_LENGTH && std::memcmp(value, PARTIAL_MAGIC, 3) == 0 &&
+      !AggregateState::isScalarContent(size) && (!spec.isVector() || size != spec.getVectorSize())) {
+    uint16_t descriptorSize = 0;
+    std::memcpy(&descriptorSize, value + 3, sizeof(descriptorSize));
+    descriptorSize = be16toh(descriptorSize);
+    if (PARTIAL_HEADER_LENGTH + descriptorSize <= size) {
+      decodeIdSetComponent(::ndn::Name::Component(value + PARTIAL_HEADER_LENGTH, descriptorSize),
+                           missingIds);
+      value += PARTIAL_HEADER_LENGTH + descriptorSize;
+      size -= PARTIAL_HEADER_LENGTH + descriptorSize;
+    }
+  }
+
+  if (spec.isVector() || size >= sizeof(uint64_t)) {
+    return AggregateState::fromContent(value, size, spec);
+  }
+
+  // Short (text) content: treat it as a single sample
+  AggregateState state(spec);
+  state.addSample(extractValueFromContent(data));
+  return state;
+}
+
+template<typename T>
+static void
+fillVectorSample(std::vector<uint8_t>& buffer, uint32_t length, uint64_t value)
+{
+  for (uint32_t i = 0; i < length; ++i) {
+    T element = static_cast<T>(value + i);
+    std::memcpy(buffer.data() + i * sizeof(T), &element, sizeof(T));
+  }
+}
+
+std::vector<uint8_t>
+AggregateUtils::makeVectorSample(const AggregateOpSpec& spec, uint64_t value)
+{
+  std::vector<uint8_t> buffer(spec.getVectorSize());
+  switch (spec.elementType) {
+    case AggregateElementType::INT32:
+      fillVectorSample<int32_t>(buffer, spec.vectorLength, value);
+      break;
+    case AggregateElementType::INT64:
+      fillVectorSample<int64_t>(buffer, spec.vectorLength, value);
+      break;
+    case AggregateElementType::FLOAT32:
+      fillVectorSample<float>(buffer, spec.vectorLength, value);
+      break;
+    case AggregateElementType::FLOAT64:
+      fillVectorSample<double>(buffer, spec.vectorLength, value);
+      break;
+  }
+  return buffer;
 }
 
 bool
@@ -167,7 +510,7 @@ AggregateUtils::isAggregationName(const ::ndn::Name& name)
   return false;
 }
 
-std::set<int>
+AggregateIdSet
 AggregateUtils::extractIdsFromName(const ::ndn::Name& name)
 {
   if (!isAggregationName(name)) {
@@ -200,7 +543,7 @@ AggregateUtils::extractSequenceComponent(const ::ndn::Name& name)
 {
   for (size_t i = 0; i < name.size(); i++) {
     // Check for string-based sequence
-    if (name[i].toUri().find("seq=") != std::string::npos) {
+    if (isSequenceMarker(name[i])) {
       return name[i];
     }
     // Check for native sequence numbers
@@ -211,6 +554,17 @@ AggregateUtils::extractSequenceComponent(const ::ndn::Name& name)
   return ::ndn::Name::Component();
 }
 
+::ndn::Name::Component
+AggregateUtils::extractOperatorComponent(const ::ndn::Name& name)
+{
+  for (const auto& component : name) {
+    if (AggregateOpSpec::isOperatorMarker(component)) {
+      return component;
+    }
+  }
+  return ::ndn::Name::Component();
+}
+
 ::ndn::Name
 AggregateUtils::getNameWithoutSequence(const ::ndn::Name& name)
 {
@@ -218,8 +572,7 @@ AggregateUtils::getNameWithoutSequence(const ::ndn::Name& name)
   
   for (size_t i = 0; i < name.size(); i++) {
     // Check for both string-based sequence markers AND native sequence numbers
-    std::string uri = name[i].toUri();
-    if (uri.find("seq=") == std::string::npos && !name[i].isSequenceNumber()) {
+    if (!isSequenceMarker(name[i]) && !name[i].isSequenceNumber()) {
       result.append(name[i]);
     }
   }
@@ -237,14 +590,13 @@ AggregateUtils::doSequenceComponentsMatch(const ::ndn::Name& name1, const ::ndn:
 }
 
 bool
-AggregateUtils::isSubset(const std::set<int>& potentialSubset, const std::set<int>& potentialSuperset)
+AggregateUtils::isSubset(const AggregateIdSet& potentialSubset, const AggregateIdSet& potentialSuperset)
 {
-  return std::includes(potentialSuperset.begin(), potentialSuperset.end(),
-                     potentialSubset.begin(), potentialSubset.end());
+  return potentialSubset.isSubsetOf(potentialSuperset);
 }
 
 bool
-AggregateUtils::isSuperset(const std::set<int>& potentialSuperset, const std::set<int>& potentialSubset)
+AggregateUtils::isSuperset(const AggregateIdSet& potentialSuperset, const AggregateIdSet& potentialSubset)
 {
   return isSubset(potentialSubset, potentialSuperset);
 }
@@ -253,11 +605,11 @@ void
 AggregateUtils::logInterestInfo(const ::ndn::Interest& interest, uint32_t faceId, 
                               const std::string& nodeInfo)
 {
-  std::cout << '\n' << nodeInfo
-          << " - STRATEGY received Interest: " << interest.getName() 
-          << " via " << faceId
-          << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds() 
-          << "s" << std::endl << std::flush;
+  NS_LOG_DEBUG(nodeInfo
+               << " - STRATEGY received Interest: " << interest.getName()
+               << " via " << faceId
+               << " at " << std::fixed << std::setprecision(2) << ns3::Simulator::Now().GetSeconds()
+               << "s");
 }
 
 } // namespace ndn
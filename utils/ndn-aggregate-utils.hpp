@@ -6,11 +6,28 @@
 #include "ns3/node-container.h"
 #include "ns3/uinteger.h"
 #include <string>
+#include <vector>
 
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/name.hpp>
-#include <set>
+
+#include "ndn-aggregate-id-set.hpp"
+#include "ndn-aggregate-data-template.hpp"
+#include "ndn-aggregate-event-sink.hpp"
+#include "ndn-aggregate-operator.hpp"
+
+/**
+ * @brief Guard for debug dumps that need more than a single NS_LOG statement
+ *
+ * Like the NS_LOG macros, it is compile-time false unless ns-3 logging is enabled
+ * (NS3_LOG_ENABLE), and requires NS_LOG_COMPONENT_DEFINE in the translation unit.
+ */
+#ifdef NS3_LOG_ENABLE
+#define NDN_AGGREGATE_LOG_ENABLED(level) (g_log.IsEnabled(level))
+#else
+#define NDN_AGGREGATE_LOG_ENABLED(level) (false)
+#endif
 
 namespace ns3 {
 namespace ndn {
@@ -28,6 +45,7 @@ public:
     PRODUCER,    // P1, P2, etc.
     RACK_AGG,    // R1, R2, etc.
     CORE_AGG,    // C1, C2, etc.
+    POD_AGG,     // A1, A2, etc. (between rack and core, e.g. fat-tree aggregation layer)
     UNKNOWN
   };
 
@@ -54,6 +72,29 @@ public:
   static uint32_t
   getNodeCount();
 
+  /**
+   * @brief Record the role and logical (1-based, per role) ID of node @p nodeIndex
+   *
+   * Once any node is registered, determineNodeRole, getNodeRoleString and getLogicalId
+   * read this table, indexed by node, instead of deriving roles from index ranges and
+   * the NodeCount global value; unregistered nodes are then UNKNOWN. Topology helpers
+   * register every node once, after creating the topology.
+   */
+  static void
+  registerNodeRole(uint32_t nodeIndex, NodeRole role, uint32_t logicalId);
+
+  /**
+   * @brief Forget all registered roles, restoring the index ranges
+   */
+  static void
+  clearNodeRoles();
+
+  /**
+   * @return Logical ID of node @p nodeIndex within its role group (e.g. 2 for "R2")
+   */
+  static uint32_t
+  getLogicalId(uint32_t nodeIndex);
+
   /**
    * @brief Extract a numeric value from Data content
    * @param data The NDN data packet
@@ -61,13 +102,97 @@ public:
    */
   static uint64_t extractValueFromContent(const ::ndn::Data& data);
 
+  /**
+   * @brief Largest ID accepted when decoding a name
+   *
+   * Bounds the work and memory an ID set taken from an Interest or Data name can cost.
+   */
+  static constexpr int MAX_ID = 1 << 20;
+
+  /**
+   * @brief Append a single ID as a decimal component, e.g. /aggregate/12
+   */
+  static void appendId(::ndn::Name& name, int id);
+
+  /**
+   * @brief Decode a single-ID component
+   *
+   * A component made only of ASCII digits is a decimal ID (as written by appendId).
+   * Any other component is read as a NonNegativeInteger, as written by appendNumber().
+   *
+   * @return false unless the component holds an ID in [1, MAX_ID]
+   */
+  static bool decodeIdComponent(const ::ndn::Name::Component& component, int& id);
+
   /**
    * @brief Parse numbers from an NDN name (components that can be converted to integers)
+   *
+   * Accepts per-ID components (see decodeIdComponent) and compact ID-set components.
+   *
    * @param name The NDN name to parse
-   * @return Set of integers found in the name
+   * @return Set of positive integers found in the name
+   */
+  static AggregateIdSet parseNumbersFromName(const ::ndn::Name& name);
+
+  /**
+   * @brief How appendIdSet() writes a set of more than one ID into a name
+   */
+  enum class IdEncoding {
+    PER_COMPONENT, // one decimal component per ID, e.g. /aggregate/1/2/3
+    COMPACT        // a single "ids=" range or "idb=" bitmap component
+  };
+
+  /**
+   * @brief Select the ID encoding used by appendIdSet() (default: COMPACT)
+   *
+   * Decoding always accepts both forms, so nodes may be switched independently.
    */
-  static std::set<int> parseNumbersFromName(const ::ndn::Name& name);
+  static void setIdEncoding(IdEncoding encoding);
+
+  static IdEncoding getIdEncoding();
+
+  /**
+   * @brief Append an ID set to a name using the selected encoding
+   *
+   * A single ID is always appended with appendId so it matches the /aggregate/<id>
+   * producer routes. Otherwise, in COMPACT mode the shorter of the two compact forms
+   * is used; the choice depends only on the set, so equal sets give equal names.
+   *
+   * @param name The name to append to
+   * @param ids The IDs to append
+   */
+  static void appendIdSet(::ndn::Name& name, const AggregateIdSet& ids);
+
+  /**
+   * @brief Encode an ID set as one compact name component
+   * @param ids The IDs to encode
+   * @return "ids=" followed by ascending ranges (e.g. "ids=1-4,6,9-1000"), or
+   *         "idb=" followed by a little-endian bitmap (bit i of byte j is ID j*8+i),
+   *         whichever is shorter
+   */
+  static ::ndn::Name::Component encodeIdSetComponent(const AggregateIdSet& ids);
+
+  /**
+   * @brief Decode a compact "ids=" / "idb=" component
+   * @param component The component to decode
+   * @param ids Set the decoded IDs are added to
+   * @return False if the component is not a well-formed compact ID set, or if its
+   *         ranges name IDs above MAX_ID or more than MAX_ID IDs in total
+   */
+  static bool decodeIdSetComponent(const ::ndn::Name::Component& component, AggregateIdSet& ids);
+
+  /**
+   * @brief Check if a name component is a "seq=" round marker
+   * @param component The component to check
+   * @return True if the component value starts with "seq="
+   */
+  static bool isSequenceMarker(const ::ndn::Name::Component& component);
   
+  /**
+   * @brief Shared pre-encoded Data template used for all aggregation Data (1s freshness)
+   */
+  static AggregateDataTemplate& getDataTemplate();
+
   /**
    * @brief Create an NDN data packet with a numeric value as content
    * @param name The name for the data packet
@@ -76,6 +201,57 @@ public:
    */
   static std::shared_ptr<::ndn::Data> createDataWithValue(const ::ndn::Name& name, uint64_t value);
 
+  /**
+   * @brief Create an NDN data packet carrying an encoded partial aggregation state
+   * @param name The name for the data packet
+   * @param state The partial state (SUM states are encoded as a plain 8-byte value)
+   * @return Shared pointer to the created Data object
+   */
+  static std::shared_ptr<::ndn::Data> createDataWithState(const ::ndn::Name& name,
+                                                          const AggregateState& state);
+
+  /**
+   * @brief Decode the Data content into a partial state for the given operator
+   * @param data The NDN data packet
+   * @param spec The operator of the round the data belongs to
+   * @return The decoded state (empty if the content belongs to another operator)
+   */
+  static AggregateState extractStateFromContent(const ::ndn::Data& data, const AggregateOpSpec& spec);
+
+  /**
+   * @brief Create a deadline reply: a partial state that lacks the IDs in @p missingIds
+   *
+   * With no missing IDs this is createDataWithState(). Otherwise the content is "AGP",
+   * a big-endian uint16 length, the missing IDs as an encodeIdSetComponent() value, and
+   * then the state encoded as by createDataWithState().
+   *
+   * @param name The name for the data packet
+   * @param state The partial state of the IDs that did answer
+   * @param missingIds IDs whose contributions are not in @p state
+   * @return Shared pointer to the created Data object
+   */
+  static std::shared_ptr<::ndn::Data> createPartialData(const ::ndn::Name& name,
+                                                        const AggregateState& state,
+                                                        const AggregateIdSet& missingIds);
+
+  /**
+   * @brief Decode the Data content like extractStateFromContent() and collect missing IDs
+   * @param data The NDN data packet
+   * @param spec The operator of the round the data belongs to
+   * @param missingIds Set the IDs missing from a deadline reply are added to
+   * @return The decoded state
+   */
+  static AggregateState extractStateFromContent(const ::ndn::Data& data, const AggregateOpSpec& spec,
+                                                AggregateIdSet& missingIds);
+
+  /**
+   * @brief Build a producer's vector sample for a vector operator
+   * @param spec The vector operator of the round (element type and length)
+   * @param value The producer's value; element i is set to value + i
+   * @return Raw vector payload of spec.getVectorSize() bytes
+   */
+  static std::vector<uint8_t> makeVectorSample(const AggregateOpSpec& spec, uint64_t value);
+
   /**
    * @brief Check if a name is for an aggregation interest/data
    * @param name The NDN name to check
@@ -88,7 +264,7 @@ public:
    * @param name The aggregate name
    * @return Set of IDs contained in the name
    */
-  static std::set<int> extractIdsFromName(const ::ndn::Name& name);
+  static AggregateIdSet extractIdsFromName(const ::ndn::Name& name);
 
   /**
    * @brief Sign a data packet using the NDN keychain
@@ -113,6 +289,13 @@ public:
    */
   static ::ndn::Name::Component extractSequenceComponent(const ::ndn::Name& name);
 
+  /**
+   * @brief Extract the "op=" operator component from an NDN name
+   * @param name The name to extract from
+   * @return The operator component, or an empty component if the name has none
+   */
+  static ::ndn::Name::Component extractOperatorComponent(const ::ndn::Name& name);
+
   /**
    * @brief Check if two sequence components match (for Interest aggregation)
    * @param name1 First name to check
@@ -127,7 +310,7 @@ public:
    * @param potentialSuperset Set that might contain the other set
    * @return True if potentialSubset is contained in potentialSuperset
    */
-  static bool isSubset(const std::set<int>& potentialSubset, const std::set<int>& potentialSuperset);
+  static bool isSubset(const AggregateIdSet& potentialSubset, const AggregateIdSet& potentialSuperset);
 
   /**
    * @brief Check if a set is a superset of another
@@ -135,7 +318,7 @@ public:
    * @param potentialSubset Set that might be a subset
    * @return True if potentialSuperset contains potentialSubset
    */
-  static bool isSuperset(const std::set<int>& potentialSuperset, const std::set<int>& potentialSubset);
+  static bool isSuperset(const AggregateIdSet& potentialSuperset, const AggregateIdSet& potentialSubset);
 
   /**
    * @brief Format and log details about an Interest